@@ -0,0 +1,61 @@
+#ifndef QTJSONSERIALIZER_AMBIENTCONTEXT_P_H
+#define QTJSONSERIALIZER_AMBIENTCONTEXT_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <utility>
+
+namespace QtJsonSerializer {
+
+// State that converters consult during a de/serialization call, without it being passed through
+// the SerializationHelper interface: ErrorSink, ProjectionContext, MergePatchContext,
+// ChangeTrackingContext, JsonSourceContext and JsonTextContext. Each of them holds an
+// AmbientScope, which installs a value for the current thread for as long as it exists.
+// The value lives in a function local thread_local of this template, keyed by the context
+// class, as exported classes cannot have thread_local static members on all compilers.
+template <typename TContext, typename TValue>
+class AmbientScope
+{
+	Q_DISABLE_COPY(AmbientScope)
+public:
+	explicit AmbientScope(TValue value);
+	~AmbientScope();
+
+	// the value of the innermost scope of this thread, or a value initialized TValue if there is none
+	static TValue current();
+
+private:
+	TValue _previous;
+
+	static TValue &local();
+};
+
+// ------------- GENERIC IMPLEMENTATION -------------
+
+template <typename TContext, typename TValue>
+AmbientScope<TContext, TValue>::AmbientScope(TValue value) :
+	_previous{std::exchange(local(), std::move(value))}
+{}
+
+template <typename TContext, typename TValue>
+AmbientScope<TContext, TValue>::~AmbientScope()
+{
+	local() = std::move(_previous);
+}
+
+template <typename TContext, typename TValue>
+TValue AmbientScope<TContext, TValue>::current()
+{
+	return local();
+}
+
+template <typename TContext, typename TValue>
+TValue &AmbientScope<TContext, TValue>::local()
+{
+	thread_local TValue value{};
+	return value;
+}
+
+}
+
+#endif // QTJSONSERIALIZER_AMBIENTCONTEXT_P_H
@@ -1,5 +1,8 @@
 #include "cborserializer.h"
 #include "cborserializer_p.h"
+#include "changetracker_p.h"
+#include "patch_p.h"
+#include "projection_p.h"
 
 #include <cmath>
 
@@ -39,6 +42,8 @@ void CborSerializer::setTypeTag(int metaTypeId, QCborTag tag)
 		d->typeTags.insert(metaTypeId, tag);
 		qCDebug(logCbor) << "Removed Type-Tag for metaTypeId" << QMetaTypeName(metaTypeId);
 	}
+	// tags decide which converters accept the data
+	d->deserCache.clear();
 }
 
 QCborTag CborSerializer::typeTag(int metaTypeId) const
@@ -54,11 +59,57 @@ QCborTag CborSerializer::typeTag(int metaTypeId) const
 	return tag;
 }
 
+void CborSerializer::setClassId(const QMetaObject *metaObject, qint64 classId)
+{
+	Q_D(CborSerializer);
+	Q_ASSERT_X(metaObject, Q_FUNC_INFO, "You cannot assign a class id to a nullptr metaobject");
+	QWriteLocker lock{&d->classIdsLock};
+	// drop any previous mapping in both directions, so ids stay unique
+	if (const auto it = d->classIds.find(metaObject); it != d->classIds.end()) {
+		d->classesById.remove(*it);
+		d->classIds.erase(it);
+	}
+	if (classId < 0) {
+		qCDebug(logCbor) << "Removed Class-Id for" << metaObject->className();
+		return;
+	}
+	if (const auto oldMeta = d->classesById.value(classId, nullptr); oldMeta)
+		d->classIds.remove(oldMeta);
+	d->classIds.insert(metaObject, classId);
+	d->classesById.insert(classId, metaObject);
+	qCDebug(logCbor) << "Added Class-Id for" << metaObject->className()
+					 << "as" << classId;
+}
+
+qint64 CborSerializer::classId(const QMetaObject *metaObject) const
+{
+	Q_D(const CborSerializer);
+	QReadLocker lock{&d->classIdsLock};
+	return d->classIds.value(metaObject, -1);
+}
+
+const QMetaObject *CborSerializer::classForId(qint64 classId) const
+{
+	Q_D(const CborSerializer);
+	QReadLocker lock{&d->classIdsLock};
+	return d->classesById.value(classId, nullptr);
+}
+
 QCborValue CborSerializer::serialize(const QVariant &data) const
 {
 	return serializeVariant(data.userType(), data);
 }
 
+QCborValue CborSerializer::serializeChanges(const QVariant &data) const
+{
+	if (!changeTracker())
+		throw SerializationException{"Serializing changes requires a changeTracker to be set"};
+	if (!QMetaType(data.userType()).flags().testFlag(QMetaType::PointerToQObject))
+		throw SerializationException{"Only the changes of QObjects can be serialized"};
+	ChangeTrackingContext _{ChangeTrackingContext::Mode::Changes};
+	return serializeVariant(data.userType(), data);
+}
+
 void CborSerializer::serializeTo(QIODevice *device, const QVariant &data, QCborValue::EncodingOptions options) const
 {
 	if (!device->isOpen() || !device->isWritable())
@@ -78,23 +129,99 @@ QVariant CborSerializer::deserialize(const QCborValue &cbor, int metaTypeId, QOb
 }
 
 QVariant CborSerializer::deserializeFrom(QIODevice *device, int metaTypeId, QObject *parent) const
+{
+	return deserializeFrom(device, metaTypeId, QStringList{}, parent);
+}
+
+QVariant CborSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
+{
+	QCborParserError error;
+	const auto cbor = QCborValue::fromCbor(data, &error);
+	if (error.error.c != QCborError::NoError)
+		throw DeserializationException("Failed to read file as CBOR with error: " + error.error.toString().toUtf8());
+	return deserializeVariant(metaTypeId, cbor, parent);
+}
+
+QVariant CborSerializer::deserialize(const QCborValue &cbor, int metaTypeId, const QStringList &projection, QObject *parent) const
+{
+	const auto root = ProjectionNode::fromPaths(projection);
+	ProjectionContext _{&root};
+	return deserializeVariant(metaTypeId, cbor, parent);
+}
+
+QVariant CborSerializer::deserializeFrom(QIODevice *device, int metaTypeId, const QStringList &projection, QObject *parent) const
 {
 	if (!device->isOpen() || !device->isReadable())
 		throw DeserializationException{"QIODevice must be open and readable!"};
+	const auto root = ProjectionNode::fromPaths(projection);
 	QCborStreamReader reader{device};
-	const auto cbor = QCborValue::fromCbor(reader);
+	const auto cbor = CborSerializerPrivate::readProjected(reader, &root);
 	if (const auto error = reader.lastError(); error.c != QCborError::NoError)
 		throw DeserializationException("Failed to read file as CBOR with error: " + error.toString().toUtf8());
+	ProjectionContext _{&root};
 	return deserializeVariant(metaTypeId, cbor, parent);
 }
 
-QVariant CborSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
+QVariant CborSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, const QStringList &projection, QObject *parent) const
+{
+	const auto root = ProjectionNode::fromPaths(projection);
+	QCborStreamReader reader{data};
+	const auto cbor = CborSerializerPrivate::readProjected(reader, &root);
+	if (const auto error = reader.lastError(); error.c != QCborError::NoError)
+		throw DeserializationException("Failed to read file as CBOR with error: " + error.toString().toUtf8());
+	ProjectionContext _{&root};
+	return deserializeVariant(metaTypeId, cbor, parent);
+}
+
+void CborSerializer::deserializeInto(QVariant &value, const QCborValue &cbor, QObject *parent) const
+{
+	if (!value.isValid())
+		throw DeserializationException{"Cannot deserialize into an invalid value - use deserialize instead"};
+	deserializeVariantInto(value.userType(), value, cbor, parent);
+}
+
+void CborSerializer::applyMergePatch(QVariant &value, const QCborValue &patch, QObject *parent) const
+{
+	if (!value.isValid())
+		throw DeserializationException{"Cannot apply a patch to an invalid value"};
+	MergePatchContext _{true};
+	deserializeVariantInto(value.userType(), value, patch, parent);
+}
+
+void CborSerializer::applyPatch(QVariant &value, const QCborArray &operations, QObject *parent) const
+{
+	if (!value.isValid())
+		throw DeserializationException{"Cannot apply a patch to an invalid value"};
+	// the operations work on the serialized value, only their differences are written back in place
+	const auto document = serialize(value);
+	const auto patched = JsonPatch::applyOperations(document, operations);
+	if (JsonPatch::canMerge(document, patched)) {
+		MergePatchContext _{true};
+		deserializeVariantInto(value.userType(), value, JsonPatch::createMergePatch(document, patched), parent);
+	} else
+		deserializeVariantInto(value.userType(), value, patched, parent);
+}
+
+QCborValue CborSerializer::createMergePatch(const QVariant &from, const QVariant &to) const
+{
+	return JsonPatch::createMergePatch(serialize(from), serialize(to));
+}
+
+DeserializationResult CborSerializer::tryDeserialize(const QCborValue &cbor, int metaTypeId, QObject *parent) const
+{
+	return tryDeserializeVariant(metaTypeId, cbor, parent);
+}
+
+DeserializationResult CborSerializer::tryDeserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
 {
 	QCborParserError error;
 	const auto cbor = QCborValue::fromCbor(data, &error);
-	if (error.error.c != QCborError::NoError)
-		throw DeserializationException("Failed to read file as CBOR with error: " + error.error.toString().toUtf8());
-	return deserializeVariant(metaTypeId, cbor, parent);
+	if (error.error.c != QCborError::NoError) {
+		return {[error]() {
+			return "Failed to read file as CBOR with error: " + error.error.toString().toUtf8();
+		}, {}};
+	}
+	return tryDeserializeVariant(metaTypeId, cbor, parent);
 }
 
 std::variant<QCborValue, QJsonValue> CborSerializer::serializeGeneric(const QVariant &value) const
@@ -234,3 +361,38 @@ qreal CborSerializerPrivate::deserializeRationaleNumber(const QCborArray &data)
 	return static_cast<long double>(data[0].toInteger()) /
 		   static_cast<long double>(data[1].toInteger());
 }
+
+QCborValue CborSerializerPrivate::readProjected(QCborStreamReader &reader, const ProjectionNode *projection)
+{
+	// only untagged containers are filtered, everything else is decoded by Qt as usual
+	if (projection->selectsAll() || !reader.isContainer())
+		return QCborValue::fromCbor(reader);
+
+	const auto isMap = reader.isMap();
+	QCborArray array;
+	QCborMap map;
+	if (!reader.enterContainer())
+		return {};
+	while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+		if (!isMap) {
+			array.append(readProjected(reader, projection));
+			continue;
+		}
+
+		// keys are matched the same way the map converters stringify them
+		const auto key = QCborValue::fromCbor(reader);
+		if (reader.lastError() != QCborError::NoError)
+			break;
+		if (const auto selected = projection->select(key.toVariant().toString()); selected)
+			map.insert(key, readProjected(reader, selected));
+		else
+			reader.next();  // skips the whole value without decoding it
+	}
+	if (reader.lastError() != QCborError::NoError)
+		return {};
+	reader.leaveContainer();
+	if (isMap)
+		return map;
+	else
+		return array;
+}
@@ -4,6 +4,8 @@
 #include "QtJsonSerializer/qtjsonserializer_global.h"
 #include "QtJsonSerializer/serializerbase.h"
 
+#include <QtCore/qstringlist.h>
+
 namespace QtJsonSerializer {
 
 class CborSerializerPrivate;
@@ -43,6 +45,9 @@ public:
 		BitArray = 10009, //!< Tag used for QBitArray
 		Date = 10010, //!< Tag used for QDate (short ISO format)
 		Time = 10011, //!< Tag used for QTime (short ISO format)
+		PositionalObject = 10012, //!< Tag used for gadgets and objects encoded as positional array, prefixed by their schema fingerprint
+		VariantAlternative = 10013, //!< Tag used for std::variant values, encoded as array of the alternative index and the value
+		DateTimeMsecs = 10014, //!< Tag used for QDateTime, encoded as milliseconds since the epoch
 
 		LocaleISO = 10100, //!< Tag used for QLocale, encoded via the ISO format
 		LocaleBCP47 = 10101, //!< Tag used for QLocale, encoded via the BCP47 format
@@ -79,12 +84,26 @@ public:
 	QCborTag typeTag() const;
 	QCborTag typeTag(int metaTypeId) const override;
 
+	//! Register a compact id to be written instead of the class name for polymorphic objects
+	template <typename T>
+	void setClassId(qint64 classId = -1);
+	//! @copybrief CborSerializer::setClassId(qint64)
+	void setClassId(const QMetaObject *metaObject, qint64 classId = -1);
+	//! @copybrief TypeConverter::SerializationHelper::classId
+	template <typename T>
+	qint64 classId() const;
+	qint64 classId(const QMetaObject *metaObject) const override;
+	//! @copybrief TypeConverter::SerializationHelper::classForId
+	const QMetaObject *classForId(qint64 classId) const override;
+
 	//! Serializers a QVariant value to a QCborValue
 	QCborValue serialize(const QVariant &data) const;
 	//! Serializers a QVariant value to a device
 	void serializeTo(QIODevice *device, const QVariant &data, QCborValue::EncodingOptions options = QCborValue::NoTransformation) const;
 	//! Serializers a QVariant value to a byte array
 	QByteArray serializeTo(const QVariant &data, QCborValue::EncodingOptions options = QCborValue::NoTransformation) const;
+	//! Serializers only the properties of a tracked QObject that changed since the last time, as merge patch
+	QCborValue serializeChanges(const QVariant &data) const;
 
 	//! Serializers a c++ type to cbor
 	template <typename T>
@@ -95,6 +114,9 @@ public:
 	//! Serializers a c++ type to a byte array
 	template <typename T>
 	QByteArray serializeTo(const T &data, QCborValue::EncodingOptions options = QCborValue::NoTransformation) const;
+	//! Serializers only the properties of a tracked QObject that changed since the last time, as merge patch
+	template <typename T>
+	QCborValue serializeChanges(T *object) const;
 
 	//! Deserializes a QCborValue to a QVariant value, based on the given type id
 	QVariant deserialize(const QCborValue &cbor, int metaTypeId, QObject *parent = nullptr) const;
@@ -102,6 +124,26 @@ public:
 	QVariant deserializeFrom(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
 	//! Deserializes data from a device to a QVariant value, based on the given type id
 	QVariant deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of a QCborValue to a QVariant value, based on the given type id
+	QVariant deserialize(const QCborValue &cbor, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a device to a QVariant value, based on the given type id
+	QVariant deserializeFrom(QIODevice *device, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a byte array to a QVariant value, based on the given type id
+	QVariant deserializeFrom(const QByteArray &data, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+
+	//! Updates an existing value in place from a QCborValue, only writing what changed
+	void deserializeInto(QVariant &value, const QCborValue &cbor, QObject *parent = nullptr) const;
+	//! Applies a merge patch (RFC 7386) to an existing value in place, only writing what changed
+	void applyMergePatch(QVariant &value, const QCborValue &patch, QObject *parent = nullptr) const;
+	//! Applies patch operations (RFC 6902) to an existing value in place, only writing what changed
+	void applyPatch(QVariant &value, const QCborArray &operations, QObject *parent = nullptr) const;
+	//! Creates the smallest merge patch (RFC 7386) that turns one value into the other
+	QCborValue createMergePatch(const QVariant &from, const QVariant &to) const;
+
+	//! Deserializes a QCborValue to a QVariant value, based on the given type id, without throwing on errors
+	DeserializationResult tryDeserialize(const QCborValue &cbor, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes data from a byte array to a QVariant value, based on the given type id, without throwing on errors
+	DeserializationResult tryDeserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
 
 	//! Deserializes cbor to the given c++ type
 	template <typename T>
@@ -112,6 +154,33 @@ public:
 	//! Deserializes data from a byte array to the given c++ type
 	template <typename T>
 	T deserializeFrom(const QByteArray &data, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of cbor to the given c++ type
+	template <typename T>
+	T deserialize(const QCborValue &cbor, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a device to the given c++ type
+	template <typename T>
+	T deserializeFrom(QIODevice *device, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a byte array to the given c++ type
+	template <typename T>
+	T deserializeFrom(const QByteArray &data, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Updates an existing c++ value in place from cbor, only writing what changed
+	template <typename T>
+	void deserializeInto(T &value, const QCborValue &cbor, QObject *parent = nullptr) const;
+	//! Applies a merge patch (RFC 7386) to an existing c++ value in place, only writing what changed
+	template <typename T>
+	void applyMergePatch(T &value, const QCborValue &patch, QObject *parent = nullptr) const;
+	//! Applies patch operations (RFC 6902) to an existing c++ value in place, only writing what changed
+	template <typename T>
+	void applyPatch(T &value, const QCborArray &operations, QObject *parent = nullptr) const;
+	//! Creates the smallest merge patch (RFC 7386) that turns one c++ value into the other
+	template <typename T>
+	QCborValue createMergePatch(const T &from, const T &to) const;
+	//! Deserializes cbor to the given c++ type, without throwing on errors
+	template <typename T>
+	DeserializationResult tryDeserialize(const QCborValue &cbor, QObject *parent = nullptr) const;
+	//! Deserializes data from a byte array to the given c++ type, without throwing on errors
+	template <typename T>
+	DeserializationResult tryDeserializeFrom(const QByteArray &data, QObject *parent = nullptr) const;
 
 	std::variant<QCborValue, QJsonValue> serializeGeneric(const QVariant &value) const override;
 	QVariant deserializeGeneric(const std::variant<QCborValue, QJsonValue> &value, int metaTypeId, QObject *parent) const override;
@@ -147,6 +216,20 @@ QCborTag CborSerializer::typeTag() const
 	return typeTag(qMetaTypeId<T>());
 }
 
+template<typename T>
+void CborSerializer::setClassId(qint64 classId)
+{
+	static_assert(std::is_base_of_v<QObject, T>, "T must inherit QObject");
+	setClassId(&T::staticMetaObject, classId);
+}
+
+template<typename T>
+qint64 CborSerializer::classId() const
+{
+	static_assert(std::is_base_of_v<QObject, T>, "T must inherit QObject");
+	return classId(&T::staticMetaObject);
+}
+
 template<typename T>
 QCborValue CborSerializer::serialize(const T &data) const
 {
@@ -168,6 +251,13 @@ QByteArray CborSerializer::serializeTo(const T &data, QCborValue::EncodingOption
 	return serializeTo(__private::variant_helper<T>::toVariant(data), options);
 }
 
+template<typename T>
+QCborValue CborSerializer::serializeChanges(T *object) const
+{
+	static_assert(std::is_base_of_v<QObject, T>, "T must inherit QObject");
+	return serializeChanges(__private::variant_helper<T*>::toVariant(object));
+}
+
 template<typename T>
 T CborSerializer::deserialize(const QCborValue &cbor, QObject *parent) const
 {
@@ -189,6 +279,83 @@ T CborSerializer::deserializeFrom(const QByteArray &data, QObject *parent) const
 	return __private::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), parent));
 }
 
+template<typename T>
+T CborSerializer::deserialize(const QCborValue &cbor, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserialize(cbor, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+T CborSerializer::deserializeFrom(QIODevice *device, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserializeFrom(device, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+T CborSerializer::deserializeFrom(const QByteArray &data, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+void CborSerializer::deserializeInto(T &value, const QCborValue &cbor, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	// hand the data over to the variant, so containers can be updated without detaching
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	deserializeInto(variant, cbor, parent);
+}
+
+template<typename T>
+void CborSerializer::applyMergePatch(T &value, const QCborValue &patch, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	applyMergePatch(variant, patch, parent);
+}
+
+template<typename T>
+void CborSerializer::applyPatch(T &value, const QCborArray &operations, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	applyPatch(variant, operations, parent);
+}
+
+template<typename T>
+QCborValue CborSerializer::createMergePatch(const T &from, const T &to) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be serialized");
+	return createMergePatch(__private::variant_helper<T>::toVariant(from),
+							__private::variant_helper<T>::toVariant(to));
+}
+
+template<typename T>
+DeserializationResult CborSerializer::tryDeserialize(const QCborValue &cbor, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return tryDeserialize(cbor, qMetaTypeId<T>(), parent);
+}
+
+template<typename T>
+DeserializationResult CborSerializer::tryDeserializeFrom(const QByteArray &data, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return tryDeserializeFrom(data, qMetaTypeId<T>(), parent);
+}
+
 }
 
 #endif // QTJSONSERIALIZER_CBORSERIALIZER_H
@@ -8,9 +8,12 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QCborStreamReader>
 
 namespace QtJsonSerializer {
 
+class ProjectionNode;
+
 class Q_JSONSERIALIZER_EXPORT CborSerializerPrivate : public SerializerBasePrivate
 {
 	Q_DECLARE_PUBLIC(CborSerializer)
@@ -21,6 +24,9 @@ public:
 
 	mutable QReadWriteLock typeTagsLock {};
 	QHash<int, QCborTag> typeTags {};
+	mutable QReadWriteLock classIdsLock {};
+	QHash<const QMetaObject*, qint64> classIds {};
+	QHash<qint64, const QMetaObject*> classesById {};
 	bool handleSpecialNumbers = false;
 
 	QVariant deserializeCborValue(int propertyType, const QCborValue &value) const override;
@@ -30,6 +36,8 @@ public:
 	qreal deserializeDecimal(const QCborArray &data) const;
 	qreal deserializeBigfloat(const QCborArray &data) const;
 	qreal deserializeRationaleNumber(const QCborArray &data) const;
+
+	static QCborValue readProjected(QCborStreamReader &reader, const ProjectionNode *projection);
 };
 
 Q_DECLARE_LOGGING_CATEGORY(logCbor)
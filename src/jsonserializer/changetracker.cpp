@@ -0,0 +1,182 @@
+#include "changetracker.h"
+#include "changetracker_p.h"
+
+#include <QtCore/QMetaProperty>
+
+#include <algorithm>
+using namespace QtJsonSerializer;
+
+Q_LOGGING_CATEGORY(QtJsonSerializer::logChangeTracker, "qt.jsonserializer.changetracker")
+
+ChangeTracker::ChangeTracker(QObject *parent) :
+	QObject{*new ChangeTrackerPrivate{}, parent}
+{}
+
+ChangeTracker::~ChangeTracker() = default;
+
+void ChangeTracker::track(QObject *object)
+{
+	Q_D(ChangeTracker);
+	if (!object)
+		return;
+
+	QMutexLocker locker{&d->lock};
+	// already tracked objects only get a new snapshot
+	if (const auto it = d->objects.find(object); it != d->objects.end()) {
+		it->changed.clear();
+		return;
+	}
+
+	static const auto notifySlot = staticMetaObject.method(staticMetaObject.indexOfSlot("_q_propertyNotified()"));
+	const auto metaObject = object->metaObject();
+	const auto &notifyMap = d->notifyMap(metaObject);
+	ChangeTrackerPrivate::ObjectState state;
+	state.connections.reserve(notifyMap.size() + 1);
+	for (auto it = notifyMap.constBegin(), end = notifyMap.constEnd(); it != end; ++it)
+		state.connections.append(connect(object, metaObject->method(it.key()), this, notifySlot));
+	// objects may live in other threads -> forget them as soon as they are gone
+	state.connections.append(connect(object, &QObject::destroyed, this, [d](QObject *destroyed) {
+		QMutexLocker locker{&d->lock};
+		d->objects.remove(destroyed);
+	}, Qt::DirectConnection));
+	d->objects.insert(object, state);
+	qCDebug(logChangeTracker) << "Tracking" << notifyMap.size()
+							  << "notify signals of object of type" << metaObject->className();
+}
+
+void ChangeTracker::untrack(QObject *object)
+{
+	Q_D(ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	if (auto it = d->objects.find(object); it != d->objects.end()) {
+		d->disconnectState(*it);
+		d->objects.erase(it);
+	}
+}
+
+bool ChangeTracker::isTracked(QObject *object) const
+{
+	Q_D(const ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	return d->objects.contains(object);
+}
+
+bool ChangeTracker::hasChanges(QObject *object) const
+{
+	Q_D(const ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	const auto it = d->objects.constFind(object);
+	return it != d->objects.constEnd() && !it->changed.isEmpty();
+}
+
+QList<QByteArray> ChangeTracker::changedProperties(QObject *object) const
+{
+	Q_D(const ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	const auto it = d->objects.constFind(object);
+	if (it == d->objects.constEnd())
+		return {};
+	return ChangeTrackerPrivate::propertyNames(object->metaObject(), it->changed);
+}
+
+void ChangeTracker::snapshot(QObject *object)
+{
+	Q_D(ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	if (auto it = d->objects.find(object); it != d->objects.end())
+		it->changed.clear();
+}
+
+QList<QByteArray> ChangeTracker::takeChanges(QObject *object)
+{
+	Q_D(ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	const auto it = d->objects.find(object);
+	if (it == d->objects.end())
+		return {};
+	// swap under the lock, so notifications in between are neither lost nor reported twice
+	QSet<int> changed;
+	changed.swap(it->changed);
+	locker.unlock();
+	return ChangeTrackerPrivate::propertyNames(object->metaObject(), changed);
+}
+
+void ChangeTracker::clear()
+{
+	Q_D(ChangeTracker);
+	QMutexLocker locker{&d->lock};
+	for (auto &state : d->objects)
+		d->disconnectState(state);
+	d->objects.clear();
+}
+
+// ------------- private implementation -------------
+
+const ChangeTrackerPrivate::NotifyMap &ChangeTrackerPrivate::notifyMap(const QMetaObject *metaObject)
+{
+	auto it = notifyCache.find(metaObject);
+	if (it == notifyCache.end()) {
+		// multiple properties can share a notify signal
+		NotifyMap map;
+		for (auto i = 0; i < metaObject->propertyCount(); ++i) {
+			const auto property = metaObject->property(i);
+			if (property.hasNotifySignal())
+				map[property.notifySignalIndex()].append(i);
+		}
+		it = notifyCache.insert(metaObject, map);
+	}
+	return *it;
+}
+
+QList<QByteArray> ChangeTrackerPrivate::propertyNames(const QMetaObject *metaObject, const QSet<int> &indexes)
+{
+	// report them in declaration order
+	auto sorted = indexes.values();
+	std::sort(sorted.begin(), sorted.end());
+	QList<QByteArray> names;
+	names.reserve(sorted.size());
+	for (const auto index : qAsConst(sorted))
+		names.append(metaObject->property(index).name());
+	return names;
+}
+
+void ChangeTrackerPrivate::disconnectState(ObjectState &state)
+{
+	for (const auto &connection : qAsConst(state.connections))
+		QObject::disconnect(connection);
+	state.connections.clear();
+}
+
+void ChangeTrackerPrivate::_q_propertyNotified()
+{
+	Q_Q(ChangeTracker);
+	const auto object = q->sender();
+	const auto signalIndex = q->senderSignalIndex();
+	if (!object || signalIndex < 0)
+		return;
+
+	QMutexLocker locker{&lock};
+	const auto it = objects.find(object);
+	if (it == objects.end())
+		return;
+	const auto wasUnchanged = it->changed.isEmpty();
+	for (const auto index : notifyMap(object->metaObject()).value(signalIndex))
+		it->changed.insert(index);
+	const auto isChanged = !it->changed.isEmpty();
+	locker.unlock();
+
+	if (wasUnchanged && isChanged)
+		emit q->objectChanged(object, {});
+}
+
+ChangeTrackingContext::ChangeTrackingContext(Mode mode) :
+	_scope{mode}
+{}
+
+ChangeTrackingContext::Mode ChangeTrackingContext::currentMode()
+{
+	// without a context, the value initialized mode is Track
+	return Scope::current();
+}
+
+#include "moc_changetracker.cpp"
@@ -0,0 +1,54 @@
+#ifndef QTJSONSERIALIZER_CHANGETRACKER_H
+#define QTJSONSERIALIZER_CHANGETRACKER_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <QtCore/qobject.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qbytearray.h>
+
+namespace QtJsonSerializer {
+
+class ChangeTrackerPrivate;
+//! Records which properties of QObjects changed, by listening to their notify signals
+class Q_JSONSERIALIZER_EXPORT ChangeTracker : public QObject
+{
+	Q_OBJECT
+
+public:
+	//! Default constructor
+	explicit ChangeTracker(QObject *parent = nullptr);
+	~ChangeTracker() override;
+
+	//! Starts tracking the given object, with none of its properties marked as changed
+	void track(QObject *object);
+	//! Stops tracking the given object
+	void untrack(QObject *object);
+	//! Checks if the given object is currently tracked
+	bool isTracked(QObject *object) const;
+
+	//! Checks if any property of the given object changed since the last snapshot
+	bool hasChanges(QObject *object) const;
+	//! Returns the names of the properties of the given object that changed since the last snapshot
+	QList<QByteArray> changedProperties(QObject *object) const;
+	//! Takes a snapshot of the given object, which marks all its properties as unchanged
+	void snapshot(QObject *object);
+	//! Returns the names of the changed properties of the given object and takes a snapshot of it
+	QList<QByteArray> takeChanges(QObject *object);
+
+	//! Stops tracking all objects
+	void clear();
+
+Q_SIGNALS:
+	//! Is emitted when the first property of a tracked object changes after a snapshot
+	void objectChanged(QObject *object, QPrivateSignal);
+
+private:
+	Q_DECLARE_PRIVATE(ChangeTracker)
+	Q_PRIVATE_SLOT(d_func(), void _q_propertyNotified())
+};
+
+}
+
+//! @file changetracker.h The ChangeTracker header file
+#endif // QTJSONSERIALIZER_CHANGETRACKER_H
@@ -0,0 +1,68 @@
+#ifndef QTJSONSERIALIZER_CHANGETRACKER_P_H
+#define QTJSONSERIALIZER_CHANGETRACKER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "changetracker.h"
+#include "ambientcontext_p.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+#include <QtCore/QMutex>
+#include <QtCore/QLoggingCategory>
+
+#include <QtCore/private/qobject_p.h>
+
+namespace QtJsonSerializer {
+
+class Q_JSONSERIALIZER_EXPORT ChangeTrackerPrivate : public QObjectPrivate
+{
+	Q_DECLARE_PUBLIC(ChangeTracker)
+
+public:
+	struct ObjectState {
+		QSet<int> changed;  // property indexes
+		QVector<QMetaObject::Connection> connections;
+	};
+	// notify signal index -> indexes of the properties it notifies
+	using NotifyMap = QHash<int, QVector<int>>;
+
+	mutable QMutex lock;
+	QHash<QObject*, ObjectState> objects;
+	QHash<const QMetaObject*, NotifyMap> notifyCache;
+
+	const NotifyMap &notifyMap(const QMetaObject *metaObject);
+	static QList<QByteArray> propertyNames(const QMetaObject *metaObject, const QSet<int> &indexes);
+	void disconnectState(ObjectState &state);
+
+	void _q_propertyNotified();
+};
+
+// Selects how the ObjectConverter serializes objects if the serializer has a change tracker.
+// Track only starts tracking new objects, Snapshot serializes objects completely and takes a
+// snapshot of them, and Changes serializes tracked objects as map of their changed properties.
+class Q_JSONSERIALIZER_EXPORT ChangeTrackingContext
+{
+	Q_DISABLE_COPY(ChangeTrackingContext)
+public:
+	enum class Mode {
+		Track,
+		Snapshot,
+		Changes
+	};
+
+	ChangeTrackingContext(Mode mode);
+
+	static Mode currentMode();
+
+private:
+	using Scope = AmbientScope<ChangeTrackingContext, Mode>;
+
+	Scope _scope;
+};
+
+Q_DECLARE_LOGGING_CATEGORY(logChangeTracker)
+
+}
+
+#endif // QTJSONSERIALIZER_CHANGETRACKER_P_H
@@ -7,6 +7,10 @@ Exception::Exception(const QByteArray &what) :
 	d{new ExceptionPrivate{what}}
 {}
 
+Exception::Exception(const QByteArray &what, const PropertyTrace &trace) :
+	d{new ExceptionPrivate{what, trace}}
+{}
+
 const char *Exception::what() const noexcept
 {
 	return d->what.constData();
@@ -54,6 +58,10 @@ DeserializationException::DeserializationException(const QByteArray &what) :
 	Exception{"Failed to deserialize with error: " + what}
 {}
 
+DeserializationException::DeserializationException(const QByteArray &what, const PropertyTrace &trace) :
+	Exception{"Failed to deserialize with error: " + what, trace}
+{}
+
 void DeserializationException::raise() const
 {
 	throw *this;
@@ -68,9 +76,75 @@ ExceptionBase *DeserializationException::clone() const
 
 
 
+DeserializationResult::DeserializationResult(QVariant value) :
+	d{new DeserializationResultPrivate{}}
+{
+	d->value = std::move(value);
+}
+
+DeserializationResult::DeserializationResult(const DeserializationException &exception) :
+	d{new DeserializationResultPrivate{}}
+{
+	d->trace = exception.propertyTrace();
+	d->exception = exception;
+}
+
+DeserializationResult::DeserializationResult(std::function<QByteArray()> messageFn, Exception::PropertyTrace trace) :
+	d{new DeserializationResultPrivate{}}
+{
+	d->messageFn = std::move(messageFn);
+	d->trace = std::move(trace);
+}
+
+bool DeserializationResult::isValid() const
+{
+	return !d->messageFn && !d->exception;
+}
+
+DeserializationResult::operator bool() const
+{
+	return isValid();
+}
+
+QVariant DeserializationResult::value() const
+{
+	return d->value;
+}
+
+QByteArray DeserializationResult::message() const
+{
+	return isValid() ? QByteArray{} : d->error().message();
+}
+
+Exception::PropertyTrace DeserializationResult::propertyTrace() const
+{
+	return d->trace;
+}
+
+void DeserializationResult::raise() const
+{
+	Q_ASSERT_X(!isValid(), Q_FUNC_INFO, "Cannot raise the error of a successful result");
+	d->error().raise();
+	Q_UNREACHABLE();
+}
+
+
+
 ExceptionPrivate::ExceptionPrivate(QByteArray msg) :
 	message{std::move(msg)},
 	trace{ExceptionContext::currentContext()}
+{
+	createWhat();
+}
+
+ExceptionPrivate::ExceptionPrivate(QByteArray msg, Exception::PropertyTrace trace) :
+	message{std::move(msg)},
+	trace{std::move(trace)}
+{
+	createWhat();
+}
+
+void ExceptionPrivate::createWhat()
 {
 	//construct the whole trace
 	what = "what: " + message + "\nProperty Trace:";
@@ -81,3 +155,13 @@ ExceptionPrivate::ExceptionPrivate(QByteArray msg) :
 			what += "\n\t" + p.first + " (Type: " + p.second + ")";
 	}
 }
+
+
+
+const DeserializationException &DeserializationResultPrivate::error() const
+{
+	// the message is only formatted once it is actually needed
+	if (!exception)
+		exception.emplace(messageFn(), trace);
+	return *exception;
+}
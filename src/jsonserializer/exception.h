@@ -5,6 +5,9 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qsharedpointer.h>
 #include <QtCore/qstack.h>
+#include <QtCore/qvariant.h>
+
+#include <functional>
 
 #if !defined(QT_NO_EXCEPTIONS) && QT_CONFIG(future)
 #include <QtCore/qexception.h>
@@ -47,6 +50,9 @@ public:
 	virtual ExceptionBase *clone() const override;
 
 protected:
+	//! @private
+	Exception(const QByteArray &what, const PropertyTrace &trace);
+
 	//! @private
 	QSharedPointer<ExceptionPrivate> d;
 };
@@ -68,11 +74,53 @@ class Q_JSONSERIALIZER_EXPORT DeserializationException : public Exception
 public:
 	//! Constructor with error message
 	DeserializationException(const QByteArray &what);
+	//! Constructor with error message and the property trace of where the error occured
+	DeserializationException(const QByteArray &what, const PropertyTrace &trace);
 
 	void raise() const override;
 	ExceptionBase *clone() const override;
 };
 
+class DeserializationResultPrivate;
+//! The result of a deserialization that does not throw, holding either the value or the error
+class Q_JSONSERIALIZER_EXPORT DeserializationResult
+{
+public:
+	//! Creates a successful result with the given value
+	DeserializationResult(QVariant value = {});
+	//! Creates a failed result from the given exception
+	DeserializationResult(const DeserializationException &exception);
+	//! @private
+	DeserializationResult(std::function<QByteArray()> messageFn, Exception::PropertyTrace trace);
+
+	//! Returns true, if the deserialization succeeded
+	bool isValid() const;
+	//! @copybrief DeserializationResult::isValid
+	explicit operator bool() const;
+
+	//! Returns the deserialized value, or an invalid QVariant if the deserialization failed
+	QVariant value() const;
+	//! Returns the deserialized value, converted to T
+	template <typename T>
+	T value() const;
+
+	//! Returns the error message, without the property trace
+	QByteArray message() const;
+	//! Returns the property trace of where the error occured
+	Exception::PropertyTrace propertyTrace() const;
+	//! Throws the error as DeserializationException
+	Q_NORETURN void raise() const;
+
+private:
+	QSharedPointer<DeserializationResultPrivate> d;
+};
+
+template<typename T>
+T DeserializationResult::value() const
+{
+	return value().template value<T>();
+}
+
 }
 
 #endif // QTJSONSERIALIZER_EXCEPTION_H
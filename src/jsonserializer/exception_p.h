@@ -4,6 +4,8 @@
 #include "qtjsonserializer_global.h"
 #include "exception.h"
 
+#include <optional>
+
 namespace QtJsonSerializer {
 
 class Q_JSONSERIALIZER_EXPORT ExceptionPrivate
@@ -11,10 +13,25 @@ class Q_JSONSERIALIZER_EXPORT ExceptionPrivate
 	Q_DISABLE_COPY(ExceptionPrivate)
 public:
 	ExceptionPrivate(QByteArray message);
+	ExceptionPrivate(QByteArray message, Exception::PropertyTrace trace);
 
 	QByteArray message;
 	Exception::PropertyTrace trace;
 	QByteArray what;
+
+private:
+	void createWhat();
+};
+
+class Q_JSONSERIALIZER_EXPORT DeserializationResultPrivate
+{
+public:
+	QVariant value;
+	std::function<QByteArray()> messageFn;
+	Exception::PropertyTrace trace;
+	mutable std::optional<DeserializationException> exception;
+
+	const DeserializationException &error() const;
 };
 
 }
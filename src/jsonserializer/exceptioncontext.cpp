@@ -41,3 +41,47 @@ int ExceptionContext::currentDepth()
 {
 	return contextStore.localData().size();
 }
+
+
+
+ErrorSink::ErrorSink() :
+	_scope{this}
+{}
+
+ErrorSink::~ErrorSink()
+{
+	Q_ASSERT_X(Scope::current() == this, Q_FUNC_INFO, "Error sinks must be destroyed in reverse order");
+}
+
+bool ErrorSink::hasFailed() const
+{
+	return _failed;
+}
+
+DeserializationResult ErrorSink::result(QVariant value) const
+{
+	if (_failed)
+		return {_messageFn, _trace};
+	else
+		return {std::move(value)};
+}
+
+bool ErrorSink::currentFailed()
+{
+	const auto sink = Scope::current();
+	return sink && sink->_failed;
+}
+
+void ErrorSink::fail(MessageFn messageFn)
+{
+	// without a sink, errors are reported the classic way
+	const auto sink = Scope::current();
+	if (!sink)
+		throw DeserializationException{messageFn()};
+	// only the first error is kept, as everything afterwards is a consequence of it
+	if (!sink->_failed) {
+		sink->_failed = true;
+		sink->_messageFn = std::move(messageFn);
+		sink->_trace = ExceptionContext::currentContext();
+	}
+}
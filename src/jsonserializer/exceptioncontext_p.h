@@ -3,6 +3,7 @@
 
 #include "qtjsonserializer_global.h"
 #include "exception.h"
+#include "ambientcontext_p.h"
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QThreadStorage>
@@ -24,6 +25,30 @@ private:
 	static QThreadStorage<SerializationException::PropertyTrace> contextStore;
 };
 
+class Q_JSONSERIALIZER_EXPORT ErrorSink
+{
+	Q_DISABLE_COPY(ErrorSink)
+public:
+	using MessageFn = std::function<QByteArray()>;
+
+	ErrorSink();
+	~ErrorSink();
+
+	bool hasFailed() const;
+	DeserializationResult result(QVariant value) const;
+
+	static bool currentFailed();
+	static void fail(MessageFn messageFn);
+
+private:
+	using Scope = AmbientScope<ErrorSink, ErrorSink*>;
+
+	Scope _scope;
+	bool _failed = false;
+	MessageFn _messageFn;
+	Exception::PropertyTrace _trace;
+};
+
 Q_DECLARE_LOGGING_CATEGORY(logExceptCtx)
 
 }
@@ -0,0 +1,269 @@
+#include "instancefactory.h"
+#include "instancefactory_p.h"
+
+#include <QtCore/QMetaProperty>
+#include <QtCore/QThread>
+
+#include <utility>
+using namespace QtJsonSerializer;
+
+const char * const InstancePoolPrivate::PooledProperty = "__qt_json_serializer_pooled";
+
+InstanceFactory::InstanceFactory() = default;
+
+InstanceFactory::~InstanceFactory() = default;
+
+QObject *InstanceFactory::createObject(const QMetaObject *metaObject, QObject *parent)
+{
+	return metaObject->newInstance(Q_ARG(QObject*, parent));
+}
+
+void *InstanceFactory::createGadget(const QMetaObject *metaObject, int gadgetType)
+{
+	Q_UNUSED(metaObject)
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return QMetaType::create(gadgetType);
+#else
+	return QMetaType(gadgetType).create();
+#endif
+}
+
+InstancePool::InstancePool(int capacity) :
+	d{new InstancePoolPrivate{capacity}}
+{}
+
+InstancePool::~InstancePool()
+{
+	clear();
+	qDeleteAll(d->prototypes);
+}
+
+QObject *InstancePool::createObject(const QMetaObject *metaObject, QObject *parent)
+{
+	QMutexLocker locker{&d->lock};
+	if (const auto it = d->objects.find(metaObject); it != d->objects.end()) {
+		// objects cannot be moved to the current thread from here, so only those living in it are reused
+		const auto thread = QThread::currentThread();
+		for (auto i = it->size() - 1; i >= 0; --i) {
+			if (it->at(i)->thread() == thread) {
+				const auto object = it->takeAt(i);
+				locker.unlock();
+				object->setParent(parent);
+				return object;
+			}
+		}
+	}
+	locker.unlock();
+
+	const auto object = InstanceFactory::createObject(metaObject, parent);
+	if (object)
+		object->setProperty(InstancePoolPrivate::PooledProperty, true);
+	return object;
+}
+
+void *InstancePool::createGadget(const QMetaObject *metaObject, int gadgetType)
+{
+	QMutexLocker locker{&d->lock};
+	if (const auto it = d->gadgets.find(gadgetType); it != d->gadgets.end() && !it->isEmpty())
+		return it->takeLast();
+	locker.unlock();
+	return InstanceFactory::createGadget(metaObject, gadgetType);
+}
+
+void InstancePool::recycle(QObject *object)
+{
+	if (!object)
+		return;
+
+	object->setParent(nullptr);
+	const auto metaObject = object->metaObject();
+	QMutexLocker locker{&d->lock};
+	const auto isFull = d->objects.value(metaObject).size() >= d->capacity;
+	locker.unlock();
+	const auto prototype = isFull ? nullptr : d->prototype(metaObject);
+	d->recycleChildren(this, object, prototype);
+	if (!prototype) {
+		delete object;
+		return;
+	}
+
+	InstancePoolPrivate::resetObject(object, prototype);
+	// other threads may have filled the pool in the meantime
+	locker.relock();
+	if (auto &freeObjects = d->objects[metaObject]; freeObjects.size() < d->capacity) {
+		freeObjects.append(object);
+		return;
+	}
+	locker.unlock();
+	delete object;
+}
+
+void InstancePool::recycle(int gadgetType, void *gadget)
+{
+	if (!gadget)
+		return;
+
+	QMutexLocker locker{&d->lock};
+	auto &freeGadgets = d->gadgets[gadgetType];
+	if (freeGadgets.size() >= d->capacity) {
+		locker.unlock();
+		InstancePoolPrivate::destroyGadget(gadgetType, gadget);
+		return;
+	}
+	InstancePoolPrivate::resetGadget(gadgetType, gadget);
+	freeGadgets.append(gadget);
+}
+
+int InstancePool::capacity() const
+{
+	return d->capacity;
+}
+
+int InstancePool::size() const
+{
+	QMutexLocker locker{&d->lock};
+	auto size = 0;
+	for (const auto &freeObjects : qAsConst(d->objects))
+		size += freeObjects.size();
+	for (const auto &freeGadgets : qAsConst(d->gadgets))
+		size += freeGadgets.size();
+	return size;
+}
+
+void InstancePool::clear()
+{
+	QMutexLocker locker{&d->lock};
+	const auto objects = std::exchange(d->objects, {});
+	const auto gadgets = std::exchange(d->gadgets, {});
+	locker.unlock();
+
+	for (const auto &freeObjects : objects)
+		qDeleteAll(freeObjects);
+	for (auto it = gadgets.constBegin(), end = gadgets.constEnd(); it != end; ++it) {
+		for (const auto gadget : it.value())
+			InstancePoolPrivate::destroyGadget(it.key(), gadget);
+	}
+}
+
+// ------------- private implementation -------------
+
+InstancePoolPrivate::InstancePoolPrivate(int capacity) :
+	capacity{capacity}
+{}
+
+QObject *InstancePoolPrivate::prototype(const QMetaObject *metaObject)
+{
+	QMutexLocker locker{&lock};
+	if (const auto it = prototypes.constFind(metaObject); it != prototypes.constEnd())
+		return *it;
+	locker.unlock();
+
+	// the constructor runs user code, which must not be called while the pool is locked
+	const auto prototype = metaObject->newInstance(Q_ARG(QObject*, nullptr));
+	locker.relock();
+	if (const auto it = prototypes.constFind(metaObject); it != prototypes.constEnd()) {
+		// another thread created one in the meantime
+		const auto existing = *it;
+		locker.unlock();
+		delete prototype;
+		return existing;
+	}
+	prototypes.insert(metaObject, prototype);
+	return prototype;
+}
+
+int InstancePoolPrivate::ownedChildCount(const QObject *object, const QObject *prototype)
+{
+	// the constructor creates its children before anything else can, so they come first and
+	// match the children of the prototype by class and name
+	if (!prototype)
+		return 0;
+	const auto &children = object->children();
+	const auto &protoChildren = prototype->children();
+	auto count = 0;
+	while (count < children.size() &&
+		   count < protoChildren.size() &&
+		   children[count]->metaObject() == protoChildren[count]->metaObject() &&
+		   children[count]->objectName() == protoChildren[count]->objectName() &&
+		   !children[count]->property(PooledProperty).toBool())
+		++count;
+	return count;
+}
+
+void InstancePoolPrivate::recycleChildren(InstancePool *pool, QObject *object, const QObject *prototype)
+{
+	// children the constructor created stay and are reset as well, children created by a pool are
+	// recycled, and all others are destroyed, as a reused object must not come with the children
+	// of its previous use
+	const auto sameThread = object->thread() == QThread::currentThread();
+	const auto ownedCount = ownedChildCount(object, prototype);
+	const auto children = object->children();
+	for (auto i = 0; i < children.size(); ++i) {
+		const auto child = children[i];
+		if (i < ownedCount) {
+			const auto protoChild = prototype->children()[i];
+			recycleChildren(pool, child, protoChild);
+			resetObject(child, protoChild);
+		} else if (child->property(PooledProperty).toBool())
+			pool->recycle(child);
+		else if (sameThread)
+			delete child;
+		else {
+			// the object may be reused before the child's thread gets to delete it
+			child->setParent(nullptr);
+			child->deleteLater();
+		}
+	}
+}
+
+void InstancePoolPrivate::resetObject(QObject *object, const QObject *prototype)
+{
+	// the object is not in use anymore -> nobody needs to be notified
+	QSignalBlocker blocker{object};
+	const auto metaObject = object->metaObject();
+	const auto ownedCount = ownedChildCount(object, prototype);
+	for (auto i = 0; i < metaObject->propertyCount(); ++i) {
+		const auto property = metaObject->property(i);
+		if (!property.isWritable())
+			continue;
+		if (property.isResettable())
+			property.reset(object);
+		else if (QMetaType(property.userType()).flags().testFlag(QMetaType::PointerToQObject)) {
+			// objects of the prototype must never leak into the pool -> point to the own child the
+			// prototype points to, or to nothing
+			const auto index = prototype->children().indexOf(property.read(prototype).value<QObject*>());
+			const auto child = index >= 0 && index < ownedCount ? object->children()[index] : nullptr;
+			if (property.read(object).value<QObject*>() != child)
+				property.write(object, QVariant::fromValue(child));
+		} else if (const auto value = property.read(prototype); property.read(object) != value)
+			property.write(object, value);
+	}
+
+	const auto dynamicProperties = object->dynamicPropertyNames();
+	for (const auto &name : dynamicProperties) {
+		if (name != PooledProperty)
+			object->setProperty(name, QVariant{});
+	}
+}
+
+void InstancePoolPrivate::resetGadget(int gadgetType, void *gadget)
+{
+	// construct it anew in the same place, which needs no allocation
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QMetaType::destruct(gadgetType, gadget);
+	QMetaType::construct(gadgetType, gadget, nullptr);
+#else
+	const QMetaType metaType{gadgetType};
+	metaType.destruct(gadget);
+	metaType.construct(gadget);
+#endif
+}
+
+void InstancePoolPrivate::destroyGadget(int gadgetType, void *gadget)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QMetaType::destroy(gadgetType, gadget);
+#else
+	QMetaType(gadgetType).destroy(gadget);
+#endif
+}
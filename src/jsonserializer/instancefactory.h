@@ -0,0 +1,74 @@
+#ifndef QTJSONSERIALIZER_INSTANCEFACTORY_H
+#define QTJSONSERIALIZER_INSTANCEFACTORY_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <QtCore/qobject.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qscopedpointer.h>
+
+#include <type_traits>
+
+namespace QtJsonSerializer {
+
+//! Creates the QObjects and gadget pointers the serializers deserialize into
+class Q_JSONSERIALIZER_EXPORT InstanceFactory
+{
+	Q_DISABLE_COPY(InstanceFactory)
+
+public:
+	//! Default constructor
+	InstanceFactory();
+	//! Destructor
+	virtual ~InstanceFactory();
+
+	//! Creates an object of the given class, with the given parent
+	virtual QObject *createObject(const QMetaObject *metaObject, QObject *parent);
+	//! Creates a gadget of the given type on the heap
+	virtual void *createGadget(const QMetaObject *metaObject, int gadgetType);
+};
+
+class InstancePoolPrivate;
+//! An instance factory that reuses recycled instances instead of creating new ones
+class Q_JSONSERIALIZER_EXPORT InstancePool : public InstanceFactory
+{
+public:
+	//! Constructor, with the number of recycled instances to keep per type
+	explicit InstancePool(int capacity = 64);
+	~InstancePool() override;
+
+	QObject *createObject(const QMetaObject *metaObject, QObject *parent) override;
+	void *createGadget(const QMetaObject *metaObject, int gadgetType) override;
+
+	//! Resets the object to its default state and keeps it for reuse
+	void recycle(QObject *object);
+	//! Resets the gadget to its default state and keeps it for reuse
+	void recycle(int gadgetType, void *gadget);
+	//! @copybrief InstancePool::recycle(int, void *)
+	template <typename T>
+	void recycle(T *gadget);
+
+	//! Returns the number of recycled instances kept per type
+	int capacity() const;
+	//! Returns the number of recycled instances the pool currently holds
+	int size() const;
+	//! Destroys all recycled instances
+	void clear();
+
+private:
+	QScopedPointer<InstancePoolPrivate> d;
+};
+
+template<typename T>
+void InstancePool::recycle(T *gadget)
+{
+	if constexpr (std::is_base_of_v<QObject, T>)
+		recycle(static_cast<QObject*>(gadget));
+	else
+		recycle(qMetaTypeId<T>(), gadget);
+}
+
+}
+
+//! @file instancefactory.h The InstanceFactory header file
+#endif // QTJSONSERIALIZER_INSTANCEFACTORY_H
@@ -0,0 +1,39 @@
+#ifndef QTJSONSERIALIZER_INSTANCEFACTORY_P_H
+#define QTJSONSERIALIZER_INSTANCEFACTORY_P_H
+
+#include "qtjsonserializer_global.h"
+#include "instancefactory.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QMutex>
+
+namespace QtJsonSerializer {
+
+class Q_JSONSERIALIZER_EXPORT InstancePoolPrivate
+{
+public:
+	// marks objects created by a pool, so their children are recycled together with them
+	static const char * const PooledProperty;
+
+	int capacity;
+	mutable QMutex lock;
+	QHash<const QMetaObject*, QVector<QObject*>> objects;
+	// default constructed instances, which recycled objects are reset to
+	QHash<const QMetaObject*, QObject*> prototypes;
+	QHash<int, QVector<void*>> gadgets;
+
+	InstancePoolPrivate(int capacity);
+
+	QObject *prototype(const QMetaObject *metaObject);
+	// the number of leading children of object that its constructor created, like the prototype's
+	static int ownedChildCount(const QObject *object, const QObject *prototype);
+	void recycleChildren(InstancePool *pool, QObject *object, const QObject *prototype);
+	static void resetObject(QObject *object, const QObject *prototype);
+	static void resetGadget(int gadgetType, void *gadget);
+	static void destroyGadget(int gadgetType, void *gadget);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_INSTANCEFACTORY_P_H
@@ -0,0 +1,205 @@
+#include "isodatetime_p.h"
+using namespace QtJsonSerializer;
+
+namespace {
+
+inline QChar *writeDigits(QChar *out, int value, int digits)
+{
+	for (auto i = digits - 1; i >= 0; --i) {
+		out[i] = QLatin1Char(static_cast<char>('0' + value % 10));
+		value /= 10;
+	}
+	return out + digits;
+}
+
+inline bool readDigits(QStringView text, qsizetype offset, int digits, int &value)
+{
+	if (text.size() < offset + digits)
+		return false;
+	value = 0;
+	for (auto i = offset; i < offset + digits; ++i) {
+		const auto c = text[i].unicode();
+		if (c < u'0' || c > u'9')
+			return false;
+		value = value * 10 + (c - u'0');
+	}
+	return true;
+}
+
+inline bool isAt(QStringView text, qsizetype offset, char16_t c)
+{
+	return text.size() > offset && text[offset].unicode() == c;
+}
+
+}
+
+QString IsoDateTime::formatDate(QDate date)
+{
+	if (!date.isValid() || date.year() < 1 || date.year() > 9999)
+		return date.toString(Qt::ISODate);
+
+	QString result(DateLength, Qt::Uninitialized);
+	writeDate(result.data(), date);
+	return result;
+}
+
+QString IsoDateTime::formatTime(QTime time)
+{
+	if (!time.isValid())
+		return time.toString(Qt::ISODateWithMs);
+
+	QString result(TimeLength, Qt::Uninitialized);
+	writeTime(result.data(), time);
+	return result;
+}
+
+QString IsoDateTime::formatDateTime(const QDateTime &dateTime)
+{
+	if (!dateTime.isValid())
+		return dateTime.toString(Qt::ISODateWithMs);
+	const auto date = dateTime.date();
+	if (date.year() < 1 || date.year() > 9999)
+		return dateTime.toString(Qt::ISODateWithMs);
+
+	qsizetype suffixLength = 0;
+	auto offset = 0;
+	switch (dateTime.timeSpec()) {
+	case Qt::LocalTime:
+		break;
+	case Qt::UTC:
+		suffixLength = 1;
+		break;
+	default:
+		offset = dateTime.offsetFromUtc();
+		if (offset % 60 != 0)
+			return dateTime.toString(Qt::ISODateWithMs);
+		suffixLength = OffsetLength;
+		break;
+	}
+
+	QString result(DateLength + 1 + TimeLength + suffixLength, Qt::Uninitialized);
+	auto out = writeDate(result.data(), date);
+	*out++ = QLatin1Char('T');
+	out = writeTime(out, dateTime.time());
+	if (suffixLength == 1)
+		*out = QLatin1Char('Z');
+	else if (suffixLength == OffsetLength) {
+		*out++ = QLatin1Char(offset < 0 ? '-' : '+');
+		const auto minutes = qAbs(offset) / 60;
+		out = writeDigits(out, minutes / 60, 2);
+		*out++ = QLatin1Char(':');
+		writeDigits(out, minutes % 60, 2);
+	}
+	return result;
+}
+
+std::optional<QDate> IsoDateTime::parseDate(QStringView text)
+{
+	int year, month, day;
+	if (text.size() != DateLength ||
+		!readDigits(text, 0, 4, year) ||
+		!isAt(text, 4, u'-') ||
+		!readDigits(text, 5, 2, month) ||
+		!isAt(text, 7, u'-') ||
+		!readDigits(text, 8, 2, day) ||
+		!QDate::isValid(year, month, day))
+		return std::nullopt;
+	return QDate{year, month, day};
+}
+
+std::optional<QTime> IsoDateTime::parseTime(QStringView text)
+{
+	qsizetype consumed = 0;
+	auto time = parseTime(text, consumed);
+	if (time && consumed == text.size())
+		return time;
+	else
+		return std::nullopt;
+}
+
+std::optional<QDateTime> IsoDateTime::parseDateTime(QStringView text)
+{
+	if (text.size() <= DateLength || text[DateLength].unicode() != u'T')
+		return std::nullopt;
+	const auto date = parseDate(text.left(DateLength));
+	if (!date)
+		return std::nullopt;
+
+	const auto timeText = text.mid(DateLength + 1);
+	qsizetype consumed = 0;
+	const auto time = parseTime(timeText, consumed);
+	if (!time)
+		return std::nullopt;
+
+	const auto suffix = timeText.mid(consumed);
+	if (suffix.isEmpty())
+		return QDateTime{*date, *time};
+	else if (suffix.size() == 1 && suffix[0].unicode() == u'Z')
+		return QDateTime{*date, *time, Qt::UTC};
+	else if (suffix.size() == OffsetLength &&
+			 (isAt(suffix, 0, u'+') || isAt(suffix, 0, u'-'))) {
+		int hours, minutes;
+		if (!readDigits(suffix, 1, 2, hours) ||
+			!isAt(suffix, 3, u':') ||
+			!readDigits(suffix, 4, 2, minutes) ||
+			hours > 14 || minutes > 59)
+			return std::nullopt;
+		const auto offset = (hours * 60 + minutes) * 60;
+		return QDateTime{*date, *time, Qt::OffsetFromUTC, isAt(suffix, 0, u'-') ? -offset : offset};
+	} else
+		return std::nullopt;
+}
+
+QChar *IsoDateTime::writeDate(QChar *out, QDate date)
+{
+	out = writeDigits(out, date.year(), 4);
+	*out++ = QLatin1Char('-');
+	out = writeDigits(out, date.month(), 2);
+	*out++ = QLatin1Char('-');
+	return writeDigits(out, date.day(), 2);
+}
+
+QChar *IsoDateTime::writeTime(QChar *out, QTime time)
+{
+	out = writeDigits(out, time.hour(), 2);
+	*out++ = QLatin1Char(':');
+	out = writeDigits(out, time.minute(), 2);
+	*out++ = QLatin1Char(':');
+	out = writeDigits(out, time.second(), 2);
+	*out++ = QLatin1Char('.');
+	return writeDigits(out, time.msec(), 3);
+}
+
+std::optional<QTime> IsoDateTime::parseTime(QStringView text, qsizetype &consumed)
+{
+	// HH:mm:ss with an optional fraction of up to three digits
+	int hour, minute, second;
+	if (!readDigits(text, 0, 2, hour) ||
+		!isAt(text, 2, u':') ||
+		!readDigits(text, 3, 2, minute) ||
+		!isAt(text, 5, u':') ||
+		!readDigits(text, 6, 2, second))
+		return std::nullopt;
+	consumed = 8;
+
+	auto msec = 0;
+	if (isAt(text, consumed, u'.') || isAt(text, consumed, u',')) {
+		auto digits = 0;
+		for (++consumed; consumed < text.size(); ++consumed, ++digits) {
+			const auto c = text[consumed].unicode();
+			if (c < u'0' || c > u'9')
+				break;
+			if (digits == 3)  // more precision than Qt keeps -> let Qt decide how to round
+				return std::nullopt;
+			msec = msec * 10 + (c - u'0');
+		}
+		if (digits == 0)
+			return std::nullopt;
+		for (; digits < 3; ++digits)
+			msec *= 10;
+	}
+
+	if (!QTime::isValid(hour, minute, second, msec))
+		return std::nullopt;
+	return QTime{hour, minute, second, msec};
+}
@@ -0,0 +1,42 @@
+#ifndef QTJSONSERIALIZER_ISODATETIME_P_H
+#define QTJSONSERIALIZER_ISODATETIME_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <optional>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QStringView>
+
+namespace QtJsonSerializer {
+
+// Fixed-format ISO-8601 codec for the common layouts produced by the serializer.
+// The format functions fall back to Qt for anything outside of that layout, the
+// parse functions return std::nullopt so the caller can fall back to Qt instead
+class Q_JSONSERIALIZER_EXPORT IsoDateTime
+{
+public:
+	// yyyy-MM-dd
+	static QString formatDate(QDate date);
+	// HH:mm:ss.zzz
+	static QString formatTime(QTime time);
+	// yyyy-MM-ddTHH:mm:ss.zzz[Z|+HH:mm]
+	static QString formatDateTime(const QDateTime &dateTime);
+
+	static std::optional<QDate> parseDate(QStringView text);
+	static std::optional<QTime> parseTime(QStringView text);
+	static std::optional<QDateTime> parseDateTime(QStringView text);
+
+private:
+	static constexpr qsizetype DateLength = 10;
+	static constexpr qsizetype TimeLength = 12;
+	static constexpr qsizetype OffsetLength = 6;
+
+	static QChar *writeDate(QChar *out, QDate date);
+	static QChar *writeTime(QChar *out, QTime time);
+	static std::optional<QTime> parseTime(QStringView text, qsizetype &consumed);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_ISODATETIME_P_H
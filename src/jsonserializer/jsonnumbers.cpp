@@ -0,0 +1,164 @@
+#include "jsonnumbers_p.h"
+
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include <QtCore/QLocale>
+using namespace QtJsonSerializer;
+
+namespace {
+
+// all powers of ten up to 1e22 are exactly representable as double
+constexpr double ExactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+}
+
+void JsonNumbers::append(QByteArray &buffer, qint64 value)
+{
+	char digits[24];
+	auto ptr = std::end(digits);
+	auto magnitude = value < 0 ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+	do {
+		*--ptr = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0)
+		*--ptr = '-';
+	buffer.append(ptr, static_cast<int>(std::end(digits) - ptr));
+}
+
+void JsonNumbers::append(QByteArray &buffer, double value)
+{
+	// +INF || -INF || NaN (see RFC4627#section2.4), same as QJsonDocument
+	if (!std::isfinite(value)) {
+		buffer.append("null", 4);
+		return;
+	}
+
+#ifdef QTJSONSERIALIZER_FLOAT_CHARCONV
+	char digits[32];
+	const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+	buffer.append(digits, static_cast<int>(result.ptr - digits));
+#else
+	buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+#endif
+}
+
+const char *JsonNumbers::parse(const char *begin, const char *end, Number &number)
+{
+	auto ptr = begin;
+	const auto negative = ptr != end && *ptr == '-';
+	if (negative)
+		++ptr;
+	if (ptr == end || !isDigit(*ptr))
+		return nullptr;
+
+	// collect up to 19 significant digits, the rest only affects the exponent
+	quint64 mantissa = 0;
+	auto digits = 0;
+	auto exponent = 0;
+	auto truncated = false;
+	const auto addDigit = [&](char c, bool fraction) {
+		if (digits < MaxMantissaDigits) {
+			mantissa = mantissa * 10 + static_cast<quint64>(c - '0');
+			if (mantissa != 0)
+				++digits;
+			if (fraction)
+				--exponent;
+		} else {
+			truncated = truncated || c != '0';
+			if (!fraction)
+				++exponent;
+		}
+	};
+
+	// integer part, without leading zeros
+	if (*ptr == '0') {
+		++ptr;
+		if (ptr != end && isDigit(*ptr))
+			return nullptr;
+	} else {
+		for (; ptr != end && isDigit(*ptr); ++ptr)
+			addDigit(*ptr, false);
+	}
+
+	// fraction
+	number.isInteger = true;
+	if (ptr != end && *ptr == '.') {
+		number.isInteger = false;
+		++ptr;
+		if (ptr == end || !isDigit(*ptr))
+			return nullptr;
+		for (; ptr != end && isDigit(*ptr); ++ptr)
+			addDigit(*ptr, true);
+	}
+
+	// exponent
+	if (ptr != end && (*ptr == 'e' || *ptr == 'E')) {
+		number.isInteger = false;
+		++ptr;
+		auto negativeExponent = false;
+		if (ptr != end && (*ptr == '+' || *ptr == '-'))
+			negativeExponent = *ptr++ == '-';
+		if (ptr == end || !isDigit(*ptr))
+			return nullptr;
+		auto explicitExponent = 0;
+		for (; ptr != end && isDigit(*ptr); ++ptr) {
+			if (explicitExponent < 100000)
+				explicitExponent = explicitExponent * 10 + (*ptr - '0');
+		}
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+
+	// exact integers
+	if (number.isInteger && !truncated && exponent == 0) {
+		constexpr auto MaxInteger = static_cast<quint64>(std::numeric_limits<qint64>::max());
+		if (!negative && mantissa <= MaxInteger) {
+			number.integer = static_cast<qint64>(mantissa);
+			return ptr;
+		} else if (negative && mantissa <= MaxInteger + 1) {
+			number.integer = static_cast<qint64>(0 - mantissa);
+			return ptr;
+		}
+	}
+
+	// doubles that can be computed exactly with a single rounding (Clinger's fast path)
+	number.isInteger = false;
+	if (!truncated &&
+		mantissa <= MaxExactMantissa &&
+		exponent >= -MaxExactPower &&
+		exponent <= MaxExactPower) {
+		auto value = static_cast<double>(mantissa);
+		if (exponent < 0)
+			value /= ExactPowersOfTen[-exponent];
+		else
+			value *= ExactPowersOfTen[exponent];
+		number.real = negative ? -value : value;
+		return ptr;
+	}
+
+	if (!parseSlow(begin, ptr, number.real))
+		return nullptr;
+	return ptr;
+}
+
+bool JsonNumbers::parseSlow(const char *begin, const char *end, double &value)
+{
+#ifdef QTJSONSERIALIZER_FLOAT_CHARCONV
+	const auto result = std::from_chars(begin, end, value);
+	return result.ec == std::errc{} && result.ptr == end;
+#else
+	auto ok = false;
+	value = QByteArray::fromRawData(begin, static_cast<int>(end - begin)).toDouble(&ok);
+	return ok;
+#endif
+}
@@ -0,0 +1,45 @@
+#ifndef QTJSONSERIALIZER_JSONNUMBERS_P_H
+#define QTJSONSERIALIZER_JSONNUMBERS_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QByteArray>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define QTJSONSERIALIZER_FLOAT_CHARCONV
+#endif
+
+namespace QtJsonSerializer {
+
+// Number formatting and parsing for the JsonWriter and JsonReader. Integers are kept as exact
+// 64 bit values and never pass through double. Doubles are written in their shortest form that
+// reads back to the same value.
+class Q_JSONSERIALIZER_EXPORT JsonNumbers
+{
+public:
+	struct Number {
+		bool isInteger = true;
+		qint64 integer = 0;
+		double real = 0.0;
+	};
+
+	static void append(QByteArray &buffer, qint64 value);
+	static void append(QByteArray &buffer, double value);
+
+	// parses a JSON number starting at begin. Returns the end of the number, or nullptr if invalid
+	static const char *parse(const char *begin, const char *end, Number &number);
+
+private:
+	static constexpr int MaxMantissaDigits = 19;
+	static constexpr quint64 MaxExactMantissa = Q_UINT64_C(1) << 53;
+	static constexpr int MaxExactPower = 22;
+
+	static bool parseSlow(const char *begin, const char *end, double &value);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_JSONNUMBERS_P_H
@@ -0,0 +1,508 @@
+#include "jsonreader_p.h"
+#include "jsonnumbers_p.h"
+#include "jsonstructuralindex_p.h"
+#include "projection_p.h"
+
+#include <QtCore/QCborArray>
+#include <QtCore/QCborMap>
+
+#include <cstring>
+using namespace QtJsonSerializer;
+
+namespace {
+
+inline bool isWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline int hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	else if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	else if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	else
+		return -1;
+}
+
+bool sameContainer(const QCborValue &lhs, const QCborValue &rhs)
+{
+	// copies of a decoded container share its data, which is what the iterators compare. Empty
+	// containers might not have any data, so they cannot be told apart
+	if (lhs.type() != rhs.type())
+		return false;
+	else if (lhs.isArray()) {
+		const auto lArray = lhs.toArray();
+		const auto rArray = rhs.toArray();
+		return !lArray.isEmpty() && lArray.constBegin() == rArray.constBegin();
+	} else if (lhs.isMap()) {
+		const auto lMap = lhs.toMap();
+		const auto rMap = rhs.toMap();
+		return !lMap.isEmpty() && lMap.constBegin() == rMap.constBegin();
+	} else
+		return false;
+}
+
+void appendUtf8(QByteArray &buffer, char32_t codePoint)
+{
+	if (codePoint < 0x80)
+		buffer.append(static_cast<char>(codePoint));
+	else if (codePoint < 0x800) {
+		buffer.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+		buffer.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	} else if (codePoint < 0x10000) {
+		buffer.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+		buffer.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		buffer.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	} else {
+		buffer.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+		buffer.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+		buffer.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+		buffer.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+	}
+}
+
+}
+
+QCborValue JsonReader::read(const QByteArray &data, QJsonParseError &error, bool structuralIndex, const ProjectionNode *projection, QVector<Span> *spans)
+{
+	QByteArray cbor;
+	JsonReader reader{data, &cbor};
+	if (projection)
+		reader._projection = projection;
+	reader._spans = spans;
+	// if the index cannot be built, the sequential parsing finds the exact error
+	if (structuralIndex)
+		reader._indexed = JsonStructuralIndex::build(data.constData(), data.size(), reader._index);
+	reader.skipWhitespace();
+	if (reader.parseValue(0)) {
+		reader.skipWhitespace();
+		if (reader._ptr != reader._end)
+			reader.fail(QJsonParseError::GarbageAtEnd);
+	}
+
+	error.offset = static_cast<int>(reader._ptr - reader._begin);
+	error.error = reader._error;
+	if (reader._error != QJsonParseError::NoError)
+		return {};
+	else
+		return QCborValue::fromCbor(cbor);
+}
+
+JsonReader::JsonReader(const QByteArray &data, QByteArray *cbor) :
+	_begin{data.constData()},
+	_end{data.constData() + data.size()},
+	_ptr{_begin},
+	_writer{cbor},
+	_projection{ProjectionNode::all()}
+{}
+
+bool JsonReader::parseValue(int depth)
+{
+	if (_ptr == _end)
+		return fail(QJsonParseError::IllegalValue);
+
+	switch (*_ptr) {
+	case '{':
+		return parseMap(depth + 1);
+	case '[':
+		return parseArray(depth + 1);
+	case '"':
+		return parseString();
+	case 't':
+		if (!parseLiteral("true", 4))
+			return false;
+		if (!_skipping)
+			_writer.append(true);
+		return true;
+	case 'f':
+		if (!parseLiteral("false", 5))
+			return false;
+		if (!_skipping)
+			_writer.append(false);
+		return true;
+	case 'n':
+		if (!parseLiteral("null", 4))
+			return false;
+		if (!_skipping)
+			_writer.append(nullptr);
+		return true;
+	case '-':
+	case '0': case '1': case '2': case '3': case '4':
+	case '5': case '6': case '7': case '8': case '9':
+		return parseNumber();
+	default:
+		return fail(QJsonParseError::IllegalValue);
+	}
+}
+
+bool JsonReader::parseArray(int depth)
+{
+	if (depth > NestingLimit)
+		return fail(QJsonParseError::DeepNesting);
+
+	const auto span = beginSpan();
+	++_ptr;
+	if (!_skipping)
+		_writer.startArray();
+	skipWhitespace();
+	if (_ptr != _end && *_ptr == ']') {
+		++_ptr;
+		if (!_skipping)
+			_writer.endArray();
+		endSpan(span);
+		return true;
+	}
+
+	forever {
+		if (!parseValue(depth))
+			return false;
+		skipWhitespace();
+		if (_ptr == _end)
+			return fail(QJsonParseError::UnterminatedArray);
+		else if (*_ptr == ',') {
+			++_ptr;
+			skipWhitespace();
+		} else if (*_ptr == ']') {
+			++_ptr;
+			if (!_skipping)
+				_writer.endArray();
+			endSpan(span);
+			return true;
+		} else
+			return fail(QJsonParseError::MissingValueSeparator);
+	}
+}
+
+bool JsonReader::parseMap(int depth)
+{
+	if (depth > NestingLimit)
+		return fail(QJsonParseError::DeepNesting);
+
+	const auto span = beginSpan();
+	++_ptr;
+	if (!_skipping)
+		_writer.startMap();
+	skipWhitespace();
+	if (_ptr != _end && *_ptr == '}') {
+		++_ptr;
+		if (!_skipping)
+			_writer.endMap();
+		endSpan(span);
+		return true;
+	}
+
+	// keys are only looked at if the projection does not select the whole map
+	const auto projection = _projection;
+	const auto filtered = !_skipping && !projection->selectsAll();
+	forever {
+		if (_ptr == _end)
+			return fail(QJsonParseError::UnterminatedObject);
+		else if (*_ptr != '"')
+			return fail(QJsonParseError::IllegalValue);
+		_captureKey = filtered;
+		const auto keyOk = parseString();
+		_captureKey = false;
+		if (!keyOk)
+			return false;
+
+		skipWhitespace();
+		if (_ptr == _end || *_ptr != ':')
+			return fail(QJsonParseError::MissingNameSeparator);
+		++_ptr;
+		skipWhitespace();
+		if (filtered) {
+			// values of keys that are not selected are still validated, but never written
+			const auto selected = projection->select(QString::fromUtf8(_key));
+			if (selected) {
+				_writer.appendTextString(_key.constData(), _key.size());
+				_projection = selected;
+			} else
+				_skipping = true;
+			const auto valueOk = parseValue(depth);
+			_projection = projection;
+			_skipping = false;
+			if (!valueOk)
+				return false;
+		} else if (!parseValue(depth))
+			return false;
+
+		skipWhitespace();
+		if (_ptr == _end)
+			return fail(QJsonParseError::UnterminatedObject);
+		else if (*_ptr == ',') {
+			++_ptr;
+			skipWhitespace();
+		} else if (*_ptr == '}') {
+			++_ptr;
+			if (!_skipping)
+				_writer.endMap();
+			endSpan(span);
+			return true;
+		} else
+			return fail(QJsonParseError::MissingValueSeparator);
+	}
+}
+
+bool JsonReader::parseString()
+{
+	if (_indexed)
+		return parseIndexedString();
+
+	const auto begin = ++_ptr;
+	auto ascii = true;
+	for (; _ptr != _end; ++_ptr) {
+		const auto c = static_cast<uchar>(*_ptr);
+		if (c == '"') {
+			if (!ascii && !JsonStructuralIndex::isValidUtf8(begin, _ptr))
+				return fail(QJsonParseError::IllegalUTF8String);
+			appendText(begin, _ptr - begin);
+			++_ptr;
+			return true;
+		} else if (c == '\\')
+			return parseEscapedString(begin);
+		else if (c < 0x20)
+			return fail(QJsonParseError::IllegalValue);
+		ascii = ascii && c < 0x80;
+	}
+	return fail(QJsonParseError::UnterminatedString);
+}
+
+bool JsonReader::parseIndexedString()
+{
+	// the index entry after the opening quote is the closing one, and the whole input was already
+	// validated, so only escape sequences still need a closer look
+	advanceIndex();
+	if (_next == _index.size())
+		return fail(QJsonParseError::UnterminatedString);
+	const auto begin = ++_ptr;
+	const auto close = _begin + _index[_next];
+	if (std::memchr(begin, '\\', static_cast<size_t>(close - begin)))
+		return parseEscapedString(begin);
+	appendText(begin, close - begin);
+	_ptr = close + 1;
+	return true;
+}
+
+bool JsonReader::parseEscapedString(const char *begin)
+{
+	_scratch.clear();
+	_scratch.append(begin, static_cast<int>(_ptr - begin));
+	const auto readEscapedUnit = [this]() -> int {
+		if (_end - _ptr < 4)
+			return -1;
+		auto unit = 0;
+		for (auto i = 0; i < 4; ++i) {
+			const auto digit = hexValue(*_ptr++);
+			if (digit < 0)
+				return -1;
+			unit = (unit << 4) | digit;
+		}
+		return unit;
+	};
+
+	while (_ptr != _end) {
+		const auto c = static_cast<uchar>(*_ptr++);
+		if (c == '"') {
+			if (!JsonStructuralIndex::isValidUtf8(_scratch.constBegin(), _scratch.constEnd()))
+				return fail(QJsonParseError::IllegalUTF8String);
+			appendText(_scratch.constData(), _scratch.size());
+			return true;
+		} else if (c < 0x20)
+			return fail(QJsonParseError::IllegalValue);
+		else if (c != '\\') {
+			_scratch.append(static_cast<char>(c));
+			continue;
+		}
+
+		if (_ptr == _end)
+			break;
+		switch (*_ptr++) {
+		case '"':
+			_scratch.append('"');
+			break;
+		case '\\':
+			_scratch.append('\\');
+			break;
+		case '/':
+			_scratch.append('/');
+			break;
+		case 'b':
+			_scratch.append('\b');
+			break;
+		case 'f':
+			_scratch.append('\f');
+			break;
+		case 'n':
+			_scratch.append('\n');
+			break;
+		case 'r':
+			_scratch.append('\r');
+			break;
+		case 't':
+			_scratch.append('\t');
+			break;
+		case 'u': {
+			const auto unit = readEscapedUnit();
+			if (unit < 0)
+				return fail(QJsonParseError::IllegalEscapeSequence);
+			char32_t codePoint = static_cast<char32_t>(unit);
+			if (QChar::isHighSurrogate(codePoint) &&
+				_end - _ptr >= 6 &&
+				_ptr[0] == '\\' &&
+				_ptr[1] == 'u') {
+				const auto restore = _ptr;
+				_ptr += 2;
+				const auto low = readEscapedUnit();
+				if (low >= 0 && QChar::isLowSurrogate(static_cast<char32_t>(low)))
+					codePoint = QChar::surrogateToUcs4(static_cast<char16_t>(unit), static_cast<char16_t>(low));
+				else
+					_ptr = restore;
+			}
+			// unpaired surrogates cannot be represented in UTF-8
+			if (QChar::isSurrogate(codePoint))
+				codePoint = QChar::ReplacementCharacter;
+			appendUtf8(_scratch, codePoint);
+			break;
+		}
+		default:
+			return fail(QJsonParseError::IllegalEscapeSequence);
+		}
+	}
+	return fail(QJsonParseError::UnterminatedString);
+}
+
+bool JsonReader::parseNumber()
+{
+	JsonNumbers::Number number;
+	const auto end = JsonNumbers::parse(_ptr, _end, number);
+	if (!end)
+		return fail(QJsonParseError::IllegalNumber);
+	_ptr = end;
+	if (_skipping)
+		return true;
+	else if (number.isInteger)
+		_writer.append(number.integer);
+	else
+		_writer.append(number.real);
+	return true;
+}
+
+bool JsonReader::parseLiteral(const char *literal, int size)
+{
+	if (_end - _ptr < size || std::memcmp(_ptr, literal, static_cast<size_t>(size)) != 0)
+		return fail(QJsonParseError::IllegalValue);
+	_ptr += size;
+	return true;
+}
+
+void JsonReader::skipWhitespace()
+{
+	if (_indexed) {
+		// whitespace is never indexed, so anything after it is found at the next entry
+		if (_ptr != _end && isWhitespace(*_ptr)) {
+			advanceIndex();
+			_ptr = _next < _index.size() ? _begin + _index[_next] : _end;
+		}
+		return;
+	}
+
+	while (_ptr != _end && isWhitespace(*_ptr))
+		++_ptr;
+}
+
+void JsonReader::advanceIndex()
+{
+	const auto position = static_cast<quint32>(_ptr - _begin);
+	while (_next < _index.size() && _index[_next] <= position)
+		++_next;
+}
+
+void JsonReader::appendText(const char *data, qsizetype size)
+{
+	if (_captureKey)
+		_key = QByteArray{data, static_cast<int>(size)};
+	else if (!_skipping)
+		_writer.appendTextString(data, size);
+}
+
+int JsonReader::beginSpan()
+{
+	// skipped values are not decoded, so they must not have a span either
+	if (!_spans || _skipping)
+		return -1;
+	_spans->append({static_cast<quint32>(_ptr - _begin), 0});
+	return _spans->size() - 1;
+}
+
+void JsonReader::endSpan(int span)
+{
+	if (span >= 0)
+		(*_spans)[span].end = static_cast<quint32>(_ptr - _begin);
+}
+
+bool JsonReader::fail(QJsonParseError::ParseError error)
+{
+	_error = error;
+	return false;
+}
+
+
+
+JsonSourceContext::JsonSourceContext(const QByteArray &source, const QCborValue &root, const ProjectionNode *projection) :
+	_scope{this},
+	_source{source},
+	_root{root},
+	_projection{projection}
+{}
+
+QByteArray JsonSourceContext::capture(const QCborValue &value)
+{
+	const auto context = Scope::current();
+	if (!context || (!value.isArray() && !value.isMap()))
+		return {};
+
+	// the source is read a second time to record the spans, which then are in the same order
+	// as the decoded containers. Only documents that contain raw fragments get here
+	if (!context->_collected) {
+		context->_collected = true;
+		QJsonParseError error;
+		JsonReader::read(context->_source, error, false, context->_projection, &context->_spans);
+		if (error.error != QJsonParseError::NoError)
+			return {};
+		context->collectContainers(context->_root);
+		if (context->_containers.size() != context->_spans.size())
+			context->_containers.clear();
+	}
+
+	// converters mostly read in document order, so the search continues behind the last match
+	const auto count = context->_containers.size();
+	for (auto i = 0; i < count; ++i) {
+		const auto index = (context->_cursor + i) % count;
+		if (sameContainer(context->_containers[index], value)) {
+			context->_cursor = index + 1;
+			const auto &span = context->_spans[index];
+			return context->_source.mid(static_cast<int>(span.begin), static_cast<int>(span.end - span.begin));
+		}
+	}
+	return {};
+}
+
+void JsonSourceContext::collectContainers(const QCborValue &value)
+{
+	// only const access, as detaching would create new containers that are not in the tree
+	if (value.isArray()) {
+		_containers.append(value);
+		const auto array = value.toArray();
+		for (auto it = array.constBegin(), end = array.constEnd(); it != end; ++it)
+			collectContainers(*it);
+	} else if (value.isMap()) {
+		_containers.append(value);
+		const auto map = value.toMap();
+		for (auto it = map.constBegin(), end = map.constEnd(); it != end; ++it)
+			collectContainers(it.value());
+	}
+}
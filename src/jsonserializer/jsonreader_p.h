@@ -0,0 +1,106 @@
+#ifndef QTJSONSERIALIZER_JSONREADER_P_H
+#define QTJSONSERIALIZER_JSONREADER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "ambientcontext_p.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCborValue>
+#include <QtCore/QCborStreamWriter>
+#include <QtCore/QJsonParseError>
+#include <QtCore/QVector>
+
+namespace QtJsonSerializer {
+
+class ProjectionNode;
+
+// Reads JSON text directly into the CBOR values the serializer works on, without the detour via
+// QJsonDocument and QJsonValue. The JSON is transcoded into a CBOR stream, which Qt then decodes
+// in a single pass. Integers are kept exact, any top level value is accepted. With a structural
+// index, strings and whitespace are skipped via the positions found by JsonStructuralIndex. With a
+// projection, values of keys that are not selected are only validated, but never decoded.
+class Q_JSONSERIALIZER_EXPORT JsonReader
+{
+public:
+	// position of an object or array in the JSON text, from the opening to behind the closing bracket
+	struct Span {
+		quint32 begin;
+		quint32 end;
+	};
+
+	// if spans are given, the spans of all objects and arrays that are decoded are added in document order
+	static QCborValue read(const QByteArray &data,
+						   QJsonParseError &error,
+						   bool structuralIndex = false,
+						   const ProjectionNode *projection = nullptr,
+						   QVector<Span> *spans = nullptr);
+
+private:
+	static constexpr int NestingLimit = 1024;
+
+	const char *const _begin;
+	const char *const _end;
+	const char *_ptr;
+	QCborStreamWriter _writer;
+	QByteArray _scratch;
+	QJsonParseError::ParseError _error = QJsonParseError::NoError;
+	QVector<quint32> _index;
+	int _next = 0;
+	bool _indexed = false;
+	const ProjectionNode *_projection;
+	QByteArray _key;
+	bool _captureKey = false;
+	bool _skipping = false;
+	QVector<Span> *_spans = nullptr;
+
+	JsonReader(const QByteArray &data, QByteArray *cbor);
+
+	bool parseValue(int depth);
+	bool parseArray(int depth);
+	bool parseMap(int depth);
+	bool parseString();
+	bool parseIndexedString();
+	bool parseEscapedString(const char *begin);
+	bool parseNumber();
+	bool parseLiteral(const char *literal, int size);
+
+	void appendText(const char *data, qsizetype size);
+	void skipWhitespace();
+	void advanceIndex();
+	int beginSpan();
+	void endSpan(int span);
+	bool fail(QJsonParseError::ParseError error);
+};
+
+// Makes a JSON document the current source of this thread, for as long as the context exists.
+// Raw fragments look up the original text of the objects and arrays they were decoded from, so
+// the text can be written back without any changes. The spans of the containers are only
+// determined by the first lookup, so documents without raw fragments do not pay for them.
+class Q_JSONSERIALIZER_EXPORT JsonSourceContext
+{
+	Q_DISABLE_COPY(JsonSourceContext)
+public:
+	// the projection must be the one the root was read with, and outlive the context
+	JsonSourceContext(const QByteArray &source, const QCborValue &root, const ProjectionNode *projection = nullptr);
+
+	// returns the original text of value, or a null bytearray if it was not decoded from the current source
+	static QByteArray capture(const QCborValue &value);
+
+private:
+	using Scope = AmbientScope<JsonSourceContext, JsonSourceContext*>;
+
+	Scope _scope;
+	QByteArray _source;
+	QCborValue _root;
+	const ProjectionNode *_projection;
+	QVector<JsonReader::Span> _spans;
+	QVector<QCborValue> _containers;
+	bool _collected = false;
+	int _cursor = 0;
+
+	void collectContainers(const QCborValue &value);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_JSONREADER_P_H
@@ -1,7 +1,10 @@
 #include "jsonserializer.h"
 #include "jsonserializer_p.h"
-
-#include <QtCore/QBuffer>
+#include "jsonreader_p.h"
+#include "jsonwriter_p.h"
+#include "changetracker_p.h"
+#include "patch_p.h"
+#include "projection_p.h"
 using namespace QtJsonSerializer;
 
 JsonSerializer::JsonSerializer(QObject *parent) :
@@ -10,65 +13,135 @@ JsonSerializer::JsonSerializer(QObject *parent) :
 
 QJsonValue JsonSerializer::serialize(const QVariant &data) const
 {
-	return serializeVariant(data.userType(), data).toJsonValue();
+	return serializeJsonVariant(data.userType(), data);
+}
+
+QJsonValue JsonSerializer::serializeChanges(const QVariant &data) const
+{
+	if (!changeTracker())
+		throw SerializationException{"Serializing changes requires a changeTracker to be set"};
+	if (!QMetaType(data.userType()).flags().testFlag(QMetaType::PointerToQObject))
+		throw SerializationException{"Only the changes of QObjects can be serialized"};
+	ChangeTrackingContext _{ChangeTrackingContext::Mode::Changes};
+	return serializeJsonVariant(data.userType(), data);
 }
 
 void JsonSerializer::serializeTo(QIODevice *device, const QVariant &data, QJsonDocument::JsonFormat format) const
 {
 	if (!device->isOpen() || !device->isWritable())
 		throw SerializationException{"QIODevice must be open and writable!"};
-	QJsonDocument doc;
-	const auto jData = serialize(data);
-	if (jData.isArray())
-		doc = QJsonDocument{jData.toArray()};
-	else if (jData.isObject())
-		doc = QJsonDocument{jData.toObject()};
-	else
-		throw SerializationException{"Only objects or arrays can be written to a device!"};
-	device->write(doc.toJson(format));
+	device->write(serializeTo(data, format));
 }
 
 QByteArray JsonSerializer::serializeTo(const QVariant &data, QJsonDocument::JsonFormat format) const
 {
-	QBuffer buffer;
-	if (!buffer.open(QIODevice::WriteOnly))
-		throw SerializationException{"Failed to write to bytearray buffer with error: " + buffer.errorString().toUtf8()};
-	serializeTo(&buffer, data, format);
-	buffer.close();
-	return buffer.data();
+	// the value goes to the JsonWriter, so raw JSON text can be passed on as it is
+	JsonTextContext _;
+	auto cData = serializeVariant(data.userType(), data);
+	// tagged or extended values might still turn into an object or array
+	if (!JsonWriter::isContainer(cData))
+		cData = QCborValue::fromJsonValue(cData.toJsonValue());
+	if (!JsonWriter::isContainer(cData))
+		throw SerializationException{"Only objects or arrays can be written to a device!"};
+	return JsonWriter::write(cData, format);
 }
 
 QVariant JsonSerializer::deserialize(const QJsonValue &json, int metaTypeId, QObject *parent) const
 {
-	return deserializeVariant(metaTypeId, QCborValue::fromJsonValue(json), parent);
+	return deserializeJsonVariant(metaTypeId, json, parent);
 }
 
 QVariant JsonSerializer::deserializeFrom(QIODevice *device, int metaTypeId, QObject *parent) const
 {
 	if (!device->isOpen() || !device->isReadable())
 		throw DeserializationException{"QIODevice must be open and readable!"};
+	return deserializeFrom(device->readAll(), metaTypeId, parent);
+}
+
+QVariant JsonSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
+{
+	return deserializeFrom(data, metaTypeId, QStringList{}, parent);
+}
+
+QVariant JsonSerializer::deserialize(const QJsonValue &json, int metaTypeId, const QStringList &projection, QObject *parent) const
+{
+	const auto root = ProjectionNode::fromPaths(projection);
+	ProjectionContext _{&root};
+	return deserializeJsonVariant(metaTypeId, json, parent);
+}
+
+QVariant JsonSerializer::deserializeFrom(QIODevice *device, int metaTypeId, const QStringList &projection, QObject *parent) const
+{
+	if (!device->isOpen() || !device->isReadable())
+		throw DeserializationException{"QIODevice must be open and readable!"};
+	return deserializeFrom(device->readAll(), metaTypeId, projection, parent);
+}
+
+QVariant JsonSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, const QStringList &projection, QObject *parent) const
+{
+	Q_D(const JsonSerializer);
+	// unselected values are already dropped by the reader, the converters skip them in addition
+	const auto root = ProjectionNode::fromPaths(projection);
 	QJsonParseError error;
-	auto doc = QJsonDocument::fromJson(device->readAll(), &error);
+	const auto cData = JsonReader::read(data, error, d->structuralIndexing, &root);
 	if (error.error != QJsonParseError::NoError)
 		throw DeserializationException{"Failed to read file as JSON with error: " + error.errorString().toUtf8()};
-	if (doc.isArray())
-		return deserialize(doc.array(), metaTypeId, parent);
-	else if (doc.isObject())
-		return deserialize(doc.object(), metaTypeId, parent);
-	else if (doc.isNull())
-		return deserialize(QJsonValue::Null, metaTypeId, parent);
-	else
-		return QVariant{};
+	ProjectionContext _{&root};
+	JsonSourceContext source{data, cData, &root};
+	return deserializeVariant(metaTypeId, cData, parent);
 }
 
-QVariant JsonSerializer::deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
+void JsonSerializer::deserializeInto(QVariant &value, const QJsonValue &json, QObject *parent) const
+{
+	if (!value.isValid())
+		throw DeserializationException{"Cannot deserialize into an invalid value - use deserialize instead"};
+	deserializeVariantInto(value.userType(), value, QCborValue::fromJsonValue(json), parent);
+}
+
+void JsonSerializer::applyMergePatch(QVariant &value, const QJsonValue &patch, QObject *parent) const
 {
-	QBuffer buffer(const_cast<QByteArray*>(&data));
-	if (!buffer.open(QIODevice::ReadOnly))
-		throw DeserializationException{"Failed to read from bytearray buffer with error: " + buffer.errorString().toUtf8()};
-	auto res = deserializeFrom(&buffer, metaTypeId, parent);
-	buffer.close();
-	return res;
+	if (!value.isValid())
+		throw DeserializationException{"Cannot apply a patch to an invalid value"};
+	MergePatchContext _{true};
+	deserializeVariantInto(value.userType(), value, QCborValue::fromJsonValue(patch), parent);
+}
+
+void JsonSerializer::applyPatch(QVariant &value, const QJsonArray &operations, QObject *parent) const
+{
+	if (!value.isValid())
+		throw DeserializationException{"Cannot apply a patch to an invalid value"};
+	// the operations work on the serialized value, only their differences are written back in place
+	const auto document = QCborValue::fromJsonValue(serialize(value));
+	const auto patched = JsonPatch::applyOperations(document, QCborArray::fromJsonArray(operations));
+	if (JsonPatch::canMerge(document, patched)) {
+		MergePatchContext _{true};
+		deserializeVariantInto(value.userType(), value, JsonPatch::createMergePatch(document, patched), parent);
+	} else
+		deserializeVariantInto(value.userType(), value, patched, parent);
+}
+
+QJsonValue JsonSerializer::createMergePatch(const QVariant &from, const QVariant &to) const
+{
+	return JsonPatch::createMergePatch(QCborValue::fromJsonValue(serialize(from)), QCborValue::fromJsonValue(serialize(to))).toJsonValue();
+}
+
+DeserializationResult JsonSerializer::tryDeserialize(const QJsonValue &json, int metaTypeId, QObject *parent) const
+{
+	return tryDeserializeJsonVariant(metaTypeId, json, parent);
+}
+
+DeserializationResult JsonSerializer::tryDeserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent) const
+{
+	Q_D(const JsonSerializer);
+	QJsonParseError error;
+	const auto cData = JsonReader::read(data, error, d->structuralIndexing);
+	if (error.error != QJsonParseError::NoError) {
+		return {[error]() {
+			return "Failed to read file as JSON with error: " + error.errorString().toUtf8();
+		}, {}};
+	}
+	JsonSourceContext source{data, cData};
+	return tryDeserializeVariant(metaTypeId, cData, parent);
 }
 
 JsonSerializer::ByteArrayFormat JsonSerializer::byteArrayFormat() const
@@ -83,6 +156,12 @@ bool JsonSerializer::validateBase64() const
 	return d->validateBase64;
 }
 
+bool JsonSerializer::structuralIndexing() const
+{
+	Q_D(const JsonSerializer);
+	return d->structuralIndexing;
+}
+
 std::variant<QCborValue, QJsonValue> JsonSerializer::serializeGeneric(const QVariant &value) const
 {
 	return serialize(value);
@@ -113,6 +192,16 @@ void JsonSerializer::setValidateBase64(bool validateBase64)
 	emit validateBase64Changed(d->validateBase64, {});
 }
 
+void JsonSerializer::setStructuralIndexing(bool structuralIndexing)
+{
+	Q_D(JsonSerializer);
+	if(d->structuralIndexing == structuralIndexing)
+		return;
+
+	d->structuralIndexing = structuralIndexing;
+	emit structuralIndexingChanged(d->structuralIndexing, {});
+}
+
 bool JsonSerializer::jsonMode() const
 {
 	return true;
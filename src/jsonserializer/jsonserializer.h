@@ -7,6 +7,7 @@
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
+#include <QtCore/qstringlist.h>
 
 namespace QtJsonSerializer {
 
@@ -20,6 +21,8 @@ class Q_JSONSERIALIZER_EXPORT JsonSerializer : public SerializerBase
 	Q_PROPERTY(ByteArrayFormat byteArrayFormat READ byteArrayFormat WRITE setByteArrayFormat NOTIFY byteArrayFormatChanged)
 	//! Specify whether deserializing a QByteArray should verify the data as base64 instead of silent discarding
 	Q_PROPERTY(bool validateBase64 READ validateBase64 WRITE setValidateBase64 NOTIFY validateBase64Changed)
+	//! Specify whether JSON text is scanned for a structural index before parsing it
+	Q_PROPERTY(bool structuralIndexing READ structuralIndexing WRITE setStructuralIndexing NOTIFY structuralIndexingChanged)
 
 public:
 	//! Defines the different supported bytearray formats
@@ -39,6 +42,8 @@ public:
 	void serializeTo(QIODevice *device, const QVariant &data, QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
 	//! Serializers a QVariant value to a byte array
 	QByteArray serializeTo(const QVariant &data, QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
+	//! Serializers only the properties of a tracked QObject that changed since the last time, as merge patch
+	QJsonValue serializeChanges(const QVariant &data) const;
 
 	//! Serializers a generic c++ type to json
 	template <typename T>
@@ -49,6 +54,9 @@ public:
 	//! Serializers a generic c++ type to a byte array
 	template <typename T>
 	QByteArray serializeTo(const T &data, QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
+	//! Serializers only the properties of a tracked QObject that changed since the last time, as merge patch
+	template <typename T>
+	QJsonValue serializeChanges(T *object) const;
 
 	//! Deserializes a QJsonValue to a QVariant value, based on the given type id
 	QVariant deserialize(const QJsonValue &json, int metaTypeId, QObject *parent = nullptr) const;
@@ -56,6 +64,26 @@ public:
 	QVariant deserializeFrom(QIODevice *device, int metaTypeId, QObject *parent = nullptr) const;
 	//! Deserializes data from a device to a QVariant value, based on the given type id
 	QVariant deserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of a QJsonValue to a QVariant value, based on the given type id
+	QVariant deserialize(const QJsonValue &json, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a device to a QVariant value, based on the given type id
+	QVariant deserializeFrom(QIODevice *device, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a byte array to a QVariant value, based on the given type id
+	QVariant deserializeFrom(const QByteArray &data, int metaTypeId, const QStringList &projection, QObject *parent = nullptr) const;
+
+	//! Updates an existing value in place from a QJsonValue, only writing what changed
+	void deserializeInto(QVariant &value, const QJsonValue &json, QObject *parent = nullptr) const;
+	//! Applies a merge patch (RFC 7386) to an existing value in place, only writing what changed
+	void applyMergePatch(QVariant &value, const QJsonValue &patch, QObject *parent = nullptr) const;
+	//! Applies patch operations (RFC 6902) to an existing value in place, only writing what changed
+	void applyPatch(QVariant &value, const QJsonArray &operations, QObject *parent = nullptr) const;
+	//! Creates the smallest merge patch (RFC 7386) that turns one value into the other
+	QJsonValue createMergePatch(const QVariant &from, const QVariant &to) const;
+
+	//! Deserializes a QJsonValue to a QVariant value, based on the given type id, without throwing on errors
+	DeserializationResult tryDeserialize(const QJsonValue &json, int metaTypeId, QObject *parent = nullptr) const;
+	//! Deserializes data from a byte array to a QVariant value, based on the given type id, without throwing on errors
+	DeserializationResult tryDeserializeFrom(const QByteArray &data, int metaTypeId, QObject *parent = nullptr) const;
 
 	//! Deserializes a json to the given c++ type
 	template <typename T>
@@ -66,11 +94,40 @@ public:
 	//! Deserializes data from a byte array to the given c++ type
 	template <typename T>
 	T deserializeFrom(const QByteArray &data, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of a json to the given c++ type
+	template <typename T>
+	T deserialize(const typename QtJsonSerializer::__private::json_type<T>::type &json, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a device to the given c++ type
+	template <typename T>
+	T deserializeFrom(QIODevice *device, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Deserializes only the selected properties of data from a byte array to the given c++ type
+	template <typename T>
+	T deserializeFrom(const QByteArray &data, const QStringList &projection, QObject *parent = nullptr) const;
+	//! Updates an existing c++ value in place from json, only writing what changed
+	template <typename T>
+	void deserializeInto(T &value, const typename QtJsonSerializer::__private::json_type<T>::type &json, QObject *parent = nullptr) const;
+	//! Applies a merge patch (RFC 7386) to an existing c++ value in place, only writing what changed
+	template <typename T>
+	void applyMergePatch(T &value, const QJsonValue &patch, QObject *parent = nullptr) const;
+	//! Applies patch operations (RFC 6902) to an existing c++ value in place, only writing what changed
+	template <typename T>
+	void applyPatch(T &value, const QJsonArray &operations, QObject *parent = nullptr) const;
+	//! Creates the smallest merge patch (RFC 7386) that turns one c++ value into the other
+	template <typename T>
+	QJsonValue createMergePatch(const T &from, const T &to) const;
+	//! Deserializes a json to the given c++ type, without throwing on errors
+	template <typename T>
+	DeserializationResult tryDeserialize(const typename QtJsonSerializer::__private::json_type<T>::type &json, QObject *parent = nullptr) const;
+	//! Deserializes data from a byte array to the given c++ type, without throwing on errors
+	template <typename T>
+	DeserializationResult tryDeserializeFrom(const QByteArray &data, QObject *parent = nullptr) const;
 
 	//! @readAcFn{QJsonSerializer::byteArrayFormat}
 	ByteArrayFormat byteArrayFormat() const;
 	//! @readAcFn{QJsonSerializer::validateBase64}
 	bool validateBase64() const;
+	//! @readAcFn{QJsonSerializer::structuralIndexing}
+	bool structuralIndexing() const;
 
 	std::variant<QCborValue, QJsonValue> serializeGeneric(const QVariant &value) const override;
 	QVariant deserializeGeneric(const std::variant<QCborValue, QJsonValue> &value, int metaTypeId, QObject *parent) const override;
@@ -80,12 +137,16 @@ public Q_SLOTS:
 	void setByteArrayFormat(ByteArrayFormat byteArrayFormat);
 	//! @writeAcFn{QJsonSerializer::validateBase64}
 	void setValidateBase64(bool validateBase64);
+	//! @writeAcFn{QJsonSerializer::structuralIndexing}
+	void setStructuralIndexing(bool structuralIndexing);
 
 Q_SIGNALS:
 	//! @notifyAcFn{QJsonSerializer::byteArrayFormat}
 	void byteArrayFormatChanged(ByteArrayFormat byteArrayFormat, QPrivateSignal);
 	//! @notifyAcFn{QJsonSerializer::validateBase64}
 	void validateBase64Changed(bool validateBase64, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::structuralIndexing}
+	void structuralIndexingChanged(bool structuralIndexing, QPrivateSignal);
 
 protected:
 	// protected implementation -> internal use for the type converters
@@ -120,6 +181,13 @@ QByteArray JsonSerializer::serializeTo(const T &data, QJsonDocument::JsonFormat
 	return serializeTo(__private::variant_helper<T>::toVariant(data), format);
 }
 
+template<typename T>
+QJsonValue JsonSerializer::serializeChanges(T *object) const
+{
+	static_assert(std::is_base_of_v<QObject, T>, "T must inherit QObject");
+	return serializeChanges(__private::variant_helper<T*>::toVariant(object));
+}
+
 template<typename T>
 T JsonSerializer::deserialize(const typename __private::json_type<T>::type &json, QObject *parent) const
 {
@@ -141,6 +209,83 @@ T JsonSerializer::deserializeFrom(const QByteArray &data, QObject *parent) const
 	return QtJsonSerializer::__private::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), parent));
 }
 
+template<typename T>
+T JsonSerializer::deserialize(const typename __private::json_type<T>::type &json, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserialize(json, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+T JsonSerializer::deserializeFrom(QIODevice *device, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserializeFrom(device, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+T JsonSerializer::deserializeFrom(const QByteArray &data, const QStringList &projection, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return __private::variant_helper<T>::fromVariant(deserializeFrom(data, qMetaTypeId<T>(), projection, parent));
+}
+
+template<typename T>
+void JsonSerializer::deserializeInto(T &value, const typename __private::json_type<T>::type &json, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	// hand the data over to the variant, so containers can be updated without detaching
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	deserializeInto(variant, json, parent);
+}
+
+template<typename T>
+void JsonSerializer::applyMergePatch(T &value, const QJsonValue &patch, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	applyMergePatch(variant, patch, parent);
+}
+
+template<typename T>
+void JsonSerializer::applyPatch(T &value, const QJsonArray &operations, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	auto variant = __private::variant_helper<T>::toVariant(std::exchange(value, T{}));
+	auto writeBack = qScopeGuard([&]() {
+		value = __private::variant_helper<T>::fromVariant(variant);
+	});
+	applyPatch(variant, operations, parent);
+}
+
+template<typename T>
+QJsonValue JsonSerializer::createMergePatch(const T &from, const T &to) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be serialized");
+	return createMergePatch(__private::variant_helper<T>::toVariant(from),
+							__private::variant_helper<T>::toVariant(to));
+}
+
+template<typename T>
+DeserializationResult JsonSerializer::tryDeserialize(const typename __private::json_type<T>::type &json, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return tryDeserialize(json, qMetaTypeId<T>(), parent);
+}
+
+template<typename T>
+DeserializationResult JsonSerializer::tryDeserializeFrom(const QByteArray &data, QObject *parent) const
+{
+	static_assert(__private::is_serializable<T>::value, "T cannot be deserialized");
+	return tryDeserializeFrom(data, qMetaTypeId<T>(), parent);
+}
+
 }
 
 #endif // QTJSONSERIALIZER_JSONSERIALIZER_H
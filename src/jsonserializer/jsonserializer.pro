@@ -3,17 +3,32 @@ TARGET = QtJsonSerializer
 QT = core core-private
 
 HEADERS += \
+	ambientcontext_p.h \
 	cborserializer.h \
 	cborserializer_p.h \
+	changetracker.h \
+	changetracker_p.h \
 	exception.h \
 	exception_p.h \
 	exceptioncontext_p.h \
+	instancefactory.h \
+	instancefactory_p.h \
+	isodatetime_p.h \
+	jsonnumbers_p.h \
+	jsonreader_p.h \
 	jsonserializer.h \
 	jsonserializer_p.h \
+	jsonstructuralindex_p.h \
+	jsonwriter_p.h \
 	metawriters.h \
 	metawriters_p.h \
+	patch_p.h \
+	projection_p.h \
+	propertyschema_p.h \
 	qtjsonserializer_global.h \
 	qtjsonserializer_helpertypes.h \
+	rawfragment.h \
+	rawvalue_p.h \
 	serializerbase.h \
 	serializerbase_p.h \
 	typeconverter.h \
@@ -21,10 +36,22 @@ HEADERS += \
 
 SOURCES += \
 	cborserializer.cpp \
+	changetracker.cpp \
 	exception.cpp \
 	exceptioncontext.cpp \
+	instancefactory.cpp \
+	isodatetime.cpp \
+	jsonnumbers.cpp \
+	jsonreader.cpp \
 	jsonserializer.cpp \
+	jsonstructuralindex.cpp \
+	jsonwriter.cpp \
 	metawriters.cpp \
+	patch.cpp \
+	projection.cpp \
+	propertyschema.cpp \
+	rawfragment.cpp \
+	rawvalue.cpp \
 	serializerbase.cpp \
 	typeconverter.cpp
 
@@ -14,6 +14,7 @@ public:
 	using ByteArrayFormat = JsonSerializer::ByteArrayFormat;
 	ByteArrayFormat byteArrayFormat = ByteArrayFormat::Base64;
 	bool validateBase64 = true;
+	bool structuralIndexing = false;
 };
 
 }
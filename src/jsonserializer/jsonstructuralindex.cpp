@@ -0,0 +1,252 @@
+#include "jsonstructuralindex_p.h"
+
+#include <QtCore/qalgorithms.h>
+
+#include <cstring>
+#include <limits>
+
+#include <QtCore/private/qsimd_p.h>
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#define QTJSONSERIALIZER_STRUCTURAL_AVX2
+#include <immintrin.h>
+#endif
+using namespace QtJsonSerializer;
+
+#ifdef QTJSONSERIALIZER_STRUCTURAL_AVX2
+namespace {
+
+QT_FUNCTION_TARGET(AVX2) inline quint64 toMask(__m256i low, __m256i high)
+{
+	return static_cast<quint32>(_mm256_movemask_epi8(low)) |
+		(static_cast<quint64>(static_cast<quint32>(_mm256_movemask_epi8(high))) << 32);
+}
+
+QT_FUNCTION_TARGET(AVX2) inline __m256i matches(__m256i data, char c)
+{
+	return _mm256_cmpeq_epi8(data, _mm256_set1_epi8(c));
+}
+
+QT_FUNCTION_TARGET(AVX2) inline __m256i matchesOp(__m256i data)
+{
+	return _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(matches(data, '{'), matches(data, '}')),
+										   _mm256_or_si256(matches(data, '['), matches(data, ']'))),
+						   _mm256_or_si256(matches(data, ':'), matches(data, ',')));
+}
+
+QT_FUNCTION_TARGET(AVX2) inline __m256i matchesWhitespace(__m256i data)
+{
+	return _mm256_or_si256(_mm256_or_si256(matches(data, ' '), matches(data, '\t')),
+						   _mm256_or_si256(matches(data, '\n'), matches(data, '\r')));
+}
+
+QT_FUNCTION_TARGET(AVX2) inline __m256i matchesControl(__m256i data)
+{
+	// unsigned data <= 0x1F  <=>  max(data, 0x1F) == 0x1F
+	const auto limit = _mm256_set1_epi8(0x1F);
+	return _mm256_cmpeq_epi8(_mm256_max_epu8(data, limit), limit);
+}
+
+}
+#endif
+
+bool JsonStructuralIndex::build(const char *data, qsizetype size, QVector<quint32> &index)
+{
+	index.clear();
+	if (size > static_cast<qsizetype>(std::numeric_limits<quint32>::max()))
+		return false;
+	// roughly one structural per 8 bytes for typical documents
+	index.reserve(static_cast<int>(size / 8 + 16));
+
+	const auto classify = selectClassifier();
+	auto escapeCarry = false;
+	quint64 stringCarry = 0;
+	quint64 scalarCarry = 0;
+	auto firstNonAscii = size;
+	for (qsizetype offset = 0; offset < size; offset += BlockSize) {
+		BlockMasks masks;
+		if (size - offset >= BlockSize)
+			classify(data + offset, masks);
+		else {
+			// the tail is padded with whitespace, which never creates a structural
+			char block[BlockSize];
+			std::memset(block, ' ', sizeof(block));
+			std::memcpy(block, data + offset, static_cast<size_t>(size - offset));
+			classify(block, masks);
+		}
+		if (masks.nonAscii != 0 && firstNonAscii == size)
+			firstNonAscii = offset;
+
+		const auto quote = masks.quote & ~escapedBits(masks.backslash, escapeCarry);
+		// set for the opening quote and everything up to, but excluding the closing quote
+		const auto inString = prefixXor(quote) ^ stringCarry;
+		stringCarry = 0 - (inString >> 63);
+		if ((masks.control & inString) != 0)
+			return false;
+
+		const auto scalar = ~(masks.op | masks.whitespace | quote) & ~inString;
+		const auto scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+		scalarCarry = scalar >> 63;
+
+		auto structurals = (masks.op & ~inString) | quote | scalarStart;
+		while (structurals != 0) {
+			index.append(static_cast<quint32>(offset + qCountTrailingZeroBits(structurals)));
+			structurals &= structurals - 1;
+		}
+	}
+
+	// unterminated strings and invalid UTF-8 are left for the sequential reader to report
+	if (stringCarry != 0)
+		return false;
+	return firstNonAscii == size || isValidUtf8(data + firstNonAscii, data + size);
+}
+
+// CBOR text strings must be valid UTF-8, so check them before Qt rejects the whole stream
+bool JsonStructuralIndex::isValidUtf8(const char *begin, const char *end)
+{
+	auto ptr = reinterpret_cast<const uchar*>(begin);
+	const auto uEnd = reinterpret_cast<const uchar*>(end);
+	while (ptr != uEnd) {
+#ifdef __SSE2__
+		// the ASCII runs between multibyte sequences are skipped 16 bytes at a time
+		while (uEnd - ptr >= 16) {
+			const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+			const auto mask = static_cast<uint>(_mm_movemask_epi8(chunk));
+			if (mask == 0)
+				ptr += 16;
+			else {
+				ptr += qCountTrailingZeroBits(mask);
+				break;
+			}
+		}
+		if (ptr == uEnd)
+			break;
+#endif
+
+		const auto c = *ptr++;
+		if (c < 0x80)
+			continue;
+
+		auto extra = 0;
+		char32_t codePoint = 0;
+		char32_t minimum = 0;
+		if ((c & 0xE0) == 0xC0) {
+			extra = 1;
+			codePoint = c & 0x1F;
+			minimum = 0x80;
+		} else if ((c & 0xF0) == 0xE0) {
+			extra = 2;
+			codePoint = c & 0x0F;
+			minimum = 0x800;
+		} else if ((c & 0xF8) == 0xF0) {
+			extra = 3;
+			codePoint = c & 0x07;
+			minimum = 0x10000;
+		} else
+			return false;
+
+		if (uEnd - ptr < extra)
+			return false;
+		for (; extra > 0; --extra) {
+			const auto cc = *ptr++;
+			if ((cc & 0xC0) != 0x80)
+				return false;
+			codePoint = (codePoint << 6) | (cc & 0x3F);
+		}
+		if (codePoint < minimum ||
+			codePoint > 0x10FFFF ||
+			(codePoint >= 0xD800 && codePoint <= 0xDFFF))
+			return false;
+	}
+	return true;
+}
+
+JsonStructuralIndex::ClassifyFn JsonStructuralIndex::selectClassifier()
+{
+#ifdef QTJSONSERIALIZER_STRUCTURAL_AVX2
+	if (qCpuHasFeature(AVX2))
+		return &JsonStructuralIndex::classifyAvx2;
+#endif
+	return &JsonStructuralIndex::classifyScalar;
+}
+
+void JsonStructuralIndex::classifyScalar(const char *block, BlockMasks &masks)
+{
+	for (auto i = 0; i < BlockSize; ++i) {
+		const auto bit = quint64{1} << i;
+		const auto c = static_cast<uchar>(block[i]);
+		switch (c) {
+		case '"':
+			masks.quote |= bit;
+			break;
+		case '\\':
+			masks.backslash |= bit;
+			break;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ':':
+		case ',':
+			masks.op |= bit;
+			break;
+		case ' ':
+			masks.whitespace |= bit;
+			break;
+		case '\t':
+		case '\n':
+		case '\r':
+			masks.whitespace |= bit;
+			masks.control |= bit;
+			break;
+		default:
+			if (c < 0x20)
+				masks.control |= bit;
+			else if (c >= 0x80)
+				masks.nonAscii |= bit;
+			break;
+		}
+	}
+}
+
+#ifdef QTJSONSERIALIZER_STRUCTURAL_AVX2
+QT_FUNCTION_TARGET(AVX2) void JsonStructuralIndex::classifyAvx2(const char *block, BlockMasks &masks)
+{
+	const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+	const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+	masks.quote = toMask(matches(low, '"'), matches(high, '"'));
+	masks.backslash = toMask(matches(low, '\\'), matches(high, '\\'));
+	masks.op = toMask(matchesOp(low), matchesOp(high));
+	masks.whitespace = toMask(matchesWhitespace(low), matchesWhitespace(high));
+	masks.control = toMask(matchesControl(low), matchesControl(high));
+	masks.nonAscii = toMask(low, high);
+}
+#endif
+
+quint64 JsonStructuralIndex::escapedBits(quint64 backslash, bool &escapeCarry)
+{
+	// a backslash escapes the next character, unless it is escaped itself. Within a run of
+	// backslashes, every second one escapes, so which characters behind a run are escaped only
+	// depends on whether the run starts on an even or odd bit. Adding the odd starts to the
+	// backslashes carries through each run at once and flips the parity of the runs starting
+	// on odd bits, all without branches (the approach of simdjson)
+	constexpr quint64 EvenBits = 0x5555555555555555ull;
+	const quint64 carry = escapeCarry ? 1 : 0;
+	backslash &= ~carry;
+	const auto followsEscape = (backslash << 1) | carry;
+	const auto oddStarts = backslash & ~EvenBits & ~followsEscape;
+	const auto evenSequences = oddStarts + backslash;
+	// an overflow means the last run reaches the end of the block and escapes the next one
+	escapeCarry = evenSequences < oddStarts;
+	return (EvenBits ^ (evenSequences << 1)) & followsEscape;
+}
+
+quint64 JsonStructuralIndex::prefixXor(quint64 bits)
+{
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	return bits;
+}
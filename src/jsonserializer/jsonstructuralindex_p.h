@@ -0,0 +1,46 @@
+#ifndef QTJSONSERIALIZER_JSONSTRUCTURALINDEX_P_H
+#define QTJSONSERIALIZER_JSONSTRUCTURALINDEX_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <QtCore/QVector>
+
+namespace QtJsonSerializer {
+
+// First stage of the indexed JSON parsing: Scans the input in blocks of 64 bytes and records the
+// positions of all structural characters, string quotes and starts of scalar values, so the
+// JsonReader can jump between them instead of looking at every byte. The blocks are classified
+// with AVX2 if the CPU supports it, with a scalar implementation otherwise.
+class Q_JSONSERIALIZER_EXPORT JsonStructuralIndex
+{
+public:
+	// returns false if the data contains anything the sequential reader has to report as error
+	static bool build(const char *data, qsizetype size, QVector<quint32> &index);
+
+	static bool isValidUtf8(const char *begin, const char *end);
+
+private:
+	static constexpr qsizetype BlockSize = 64;
+
+	struct BlockMasks {
+		quint64 quote = 0;
+		quint64 backslash = 0;
+		quint64 op = 0;
+		quint64 whitespace = 0;
+		quint64 control = 0;
+		quint64 nonAscii = 0;
+	};
+
+	using ClassifyFn = void(*)(const char *, BlockMasks &);
+
+	static ClassifyFn selectClassifier();
+	static void classifyScalar(const char *block, BlockMasks &masks);
+	static void classifyAvx2(const char *block, BlockMasks &masks);
+
+	static quint64 escapedBits(quint64 backslash, bool &escapeCarry);
+	static quint64 prefixXor(quint64 bits);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_JSONSTRUCTURALINDEX_P_H
@@ -0,0 +1,290 @@
+#include "jsonwriter_p.h"
+#include "jsonnumbers_p.h"
+#include "exception.h"
+
+#include <QtCore/QJsonValue>
+#include <QtCore/qalgorithms.h>
+
+#include <limits>
+
+#include <QtCore/private/qsimd_p.h>
+using namespace QtJsonSerializer;
+
+namespace {
+
+constexpr char HexDigits[] = "0123456789abcdef";
+
+}
+
+QByteArray JsonWriter::write(const QCborValue &value, QJsonDocument::JsonFormat format)
+{
+	JsonWriter writer{format};
+	writer.writeValue(value, 0);
+	if (!writer._compact)
+		writer._buffer.append('\n');
+	return writer._buffer;
+}
+
+QCborValue JsonWriter::text(const QByteArray &json)
+{
+	return {TextTag, json};
+}
+
+bool JsonWriter::isContainer(const QCborValue &value)
+{
+	if (value.isArray() || value.isMap())
+		return true;
+	else if (!value.isTag() || value.tag() != TextTag)
+		return false;
+
+	const auto json = value.taggedValue().toByteArray();
+	for (const auto c : json) {
+		if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+			return c == '{' || c == '[';
+	}
+	return false;
+}
+
+JsonWriter::JsonWriter(QJsonDocument::JsonFormat format) :
+	_compact{format == QJsonDocument::Compact}
+{}
+
+void JsonWriter::writeValue(const QCborValue &value, int indent)
+{
+	switch (value.type()) {
+	case QCborValue::Integer:
+		JsonNumbers::append(_buffer, value.toInteger());
+		break;
+	case QCborValue::Double:
+		JsonNumbers::append(_buffer, value.toDouble());
+		break;
+	case QCborValue::String:
+		writeString(value.toString());
+		break;
+	case QCborValue::True:
+		_buffer.append("true", 4);
+		break;
+	case QCborValue::False:
+		_buffer.append("false", 5);
+		break;
+	case QCborValue::Null:
+		_buffer.append("null", 4);
+		break;
+	case QCborValue::Array:
+		writeArray(value.toArray(), indent);
+		break;
+	case QCborValue::Map:
+		writeMap(value.toMap(), indent);
+		break;
+	case QCborValue::Tag:
+		// JSON text is written as it is, even if it does not match the format
+		if (value.tag() == TextTag) {
+			_buffer.append(value.taggedValue().toByteArray());
+			break;
+		}
+		// tags are dropped, unless they specify the encoding of a bytearray
+		if (const auto tagged = value.taggedValue(); !tagged.isByteArray()) {
+			writeValue(tagged, indent);
+			break;
+		}
+		Q_FALLTHROUGH();
+	default: {
+		// everything else is converted the way QCborValue::toJsonValue does it
+		const auto jValue = value.toJsonValue();
+		switch (jValue.type()) {
+		case QJsonValue::String:
+			writeString(jValue.toString());
+			break;
+		case QJsonValue::Double:
+			JsonNumbers::append(_buffer, jValue.toDouble());
+			break;
+		case QJsonValue::Bool:
+			if (jValue.toBool())
+				_buffer.append("true", 4);
+			else
+				_buffer.append("false", 5);
+			break;
+		case QJsonValue::Array:
+		case QJsonValue::Object:
+			writeValue(QCborValue::fromJsonValue(jValue), indent);
+			break;
+		default:
+			_buffer.append("null", 4);
+			break;
+		}
+		break;
+	}
+	}
+}
+
+void JsonWriter::writeArray(const QCborArray &array, int indent)
+{
+	_buffer.append(_compact ? "[" : "[\n");
+	for (auto it = array.constBegin(), end = array.constEnd(); it != end;) {
+		writeIndent(indent + 1);
+		writeValue(*it, indent + 1);
+		if (++it != end)
+			_buffer.append(_compact ? "," : ",\n");
+		else if (!_compact)
+			_buffer.append('\n');
+	}
+	writeIndent(indent);
+	_buffer.append(']');
+}
+
+void JsonWriter::writeMap(const QCborMap &map, int indent)
+{
+	// JSON only knows string keys -> let Qt decide how to stringify anything else
+	for (auto it = map.constBegin(), end = map.constEnd(); it != end; ++it) {
+		if (const auto key = it.key(); !key.isString() && !key.isInteger()) {
+			writeValue(QCborValue::fromJsonValue(QCborValue{map}.toJsonValue()), indent);
+			return;
+		}
+	}
+
+	_buffer.append(_compact ? "{" : "{\n");
+	for (auto it = map.constBegin(), end = map.constEnd(); it != end;) {
+		writeIndent(indent + 1);
+		if (const auto key = it.key(); key.isInteger()) {
+			_buffer.append('"');
+			JsonNumbers::append(_buffer, key.toInteger());
+			_buffer.append('"');
+		} else {
+			// keys are not pre-escaped: the writer only sees the decoded map, and matching them
+			// against cached bytes costs as much as escaping them on the ASCII fast path
+			writeString(key.toString());
+		}
+		_buffer.append(_compact ? ":" : ": ");
+		writeValue(it.value(), indent + 1);
+		if (++it != end)
+			_buffer.append(_compact ? "," : ",\n");
+		else if (!_compact)
+			_buffer.append('\n');
+	}
+	writeIndent(indent);
+	_buffer.append('}');
+}
+
+void JsonWriter::writeString(const QString &string)
+{
+	// worst case: every UTF-16 unit becomes a 6 byte \u00XX escape, transcoding needs at most 3
+	using SizeType = decltype(_buffer.size());
+	const qsizetype offset = _buffer.size();
+	const qsizetype length = string.size();
+	if (length > (static_cast<qsizetype>(std::numeric_limits<SizeType>::max()) - offset - 2) / 6)
+		throw SerializationException{"String is too long to be written as JSON"};
+	_buffer.resize(static_cast<SizeType>(offset + length * 6 + 2));
+	auto out = _buffer.data() + offset;
+	*out++ = '"';
+
+	auto src = string.utf16();
+	const auto end = src + string.size();
+	while (src != end) {
+#ifdef __SSE2__
+		// plain ASCII runs are narrowed 8 units at a time
+		while (end - src >= 8) {
+			const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			// signed compare: units >= 0x8000 are negative and thus caught as < 0x20
+			const auto special = _mm_or_si128(_mm_or_si128(_mm_cmplt_epi16(chunk, _mm_set1_epi16(0x20)),
+														   _mm_cmpgt_epi16(chunk, _mm_set1_epi16(0x7F))),
+											  _mm_or_si128(_mm_cmpeq_epi16(chunk, _mm_set1_epi16('"')),
+														   _mm_cmpeq_epi16(chunk, _mm_set1_epi16('\\'))));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(chunk, chunk));
+			const auto mask = static_cast<uint>(_mm_movemask_epi8(special));
+			if (mask == 0) {
+				src += 8;
+				out += 8;
+			} else {
+				const auto plain = qCountTrailingZeroBits(mask) / 2;
+				src += plain;
+				out += plain;
+				break;
+			}
+		}
+		if (src == end)
+			break;
+#endif
+
+		const auto unit = *src++;
+		if (unit < 0x80) {
+			switch (unit) {
+			case '"':
+				*out++ = '\\';
+				*out++ = '"';
+				break;
+			case '\\':
+				*out++ = '\\';
+				*out++ = '\\';
+				break;
+			case '\b':
+				*out++ = '\\';
+				*out++ = 'b';
+				break;
+			case '\f':
+				*out++ = '\\';
+				*out++ = 'f';
+				break;
+			case '\n':
+				*out++ = '\\';
+				*out++ = 'n';
+				break;
+			case '\r':
+				*out++ = '\\';
+				*out++ = 'r';
+				break;
+			case '\t':
+				*out++ = '\\';
+				*out++ = 't';
+				break;
+			default:
+				if (unit < 0x20) {
+					*out++ = '\\';
+					*out++ = 'u';
+					*out++ = '0';
+					*out++ = '0';
+					*out++ = HexDigits[unit >> 4];
+					*out++ = HexDigits[unit & 0xf];
+				} else
+					*out++ = static_cast<char>(unit);
+				break;
+			}
+		} else if (unit < 0x800) {
+			*out++ = static_cast<char>(0xC0 | (unit >> 6));
+			*out++ = static_cast<char>(0x80 | (unit & 0x3F));
+		} else if (QChar::isHighSurrogate(unit) && src != end && QChar::isLowSurrogate(*src)) {
+			const auto codePoint = QChar::surrogateToUcs4(unit, *src++);
+			*out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		} else {
+			// unpaired surrogates cannot be represented in UTF-8
+			const auto codePoint = QChar::isSurrogate(unit) ? static_cast<uint>(QChar::ReplacementCharacter) : static_cast<uint>(unit);
+			*out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+			*out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	*out++ = '"';
+	_buffer.resize(static_cast<SizeType>(out - _buffer.constData()));
+}
+
+void JsonWriter::writeIndent(int indent)
+{
+	if (_compact)
+		return;
+	for (auto i = 0; i < indent; ++i)
+		_buffer.append("    ", 4);
+}
+
+
+
+JsonTextContext::JsonTextContext() :
+	_scope{true}
+{}
+
+bool JsonTextContext::isActive()
+{
+	return Scope::current();
+}
@@ -0,0 +1,63 @@
+#ifndef QTJSONSERIALIZER_JSONWRITER_P_H
+#define QTJSONSERIALIZER_JSONWRITER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "ambientcontext_p.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCborValue>
+#include <QtCore/QCborArray>
+#include <QtCore/QCborMap>
+#include <QtCore/QJsonDocument>
+
+namespace QtJsonSerializer {
+
+// Writes the CBOR values created by the serializer directly as JSON text, without the detour via
+// QJsonValue and QJsonDocument. The layout matches QJsonDocument::toJson, but objects keep the
+// order of the serialized map instead of being sorted by key.
+class Q_JSONSERIALIZER_EXPORT JsonWriter
+{
+public:
+	// marks JSON text that is written as it is. The tag is reserved as invalid by the CBOR standard,
+	// so it cannot clash with real data
+	static constexpr auto TextTag = static_cast<QCborTag>(65535);
+
+	static QByteArray write(const QCborValue &value, QJsonDocument::JsonFormat format);
+
+	// creates a value that is written as the given JSON text, without any changes
+	static QCborValue text(const QByteArray &json);
+	// checks if the value is written as JSON object or array
+	static bool isContainer(const QCborValue &value);
+
+private:
+	QByteArray _buffer;
+	const bool _compact;
+
+	explicit JsonWriter(QJsonDocument::JsonFormat format);
+
+	void writeValue(const QCborValue &value, int indent);
+	void writeArray(const QCborArray &array, int indent);
+	void writeMap(const QCborMap &map, int indent);
+	void writeString(const QString &string);
+	void writeIndent(int indent);
+};
+
+// Marks values as being serialized for the JsonWriter, for as long as the context exists. Only
+// then, converters may pass on JSON text via JsonWriter::text.
+class Q_JSONSERIALIZER_EXPORT JsonTextContext
+{
+	Q_DISABLE_COPY(JsonTextContext)
+public:
+	JsonTextContext();
+
+	static bool isActive();
+
+private:
+	using Scope = AmbientScope<JsonTextContext, bool>;
+
+	Scope _scope;
+};
+
+}
+
+#endif // QTJSONSERIALIZER_JSONWRITER_P_H
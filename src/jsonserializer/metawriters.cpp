@@ -1,5 +1,6 @@
 #include "metawriters.h"
 #include "metawriters_p.h"
+#include "serializerbase_p.h"
 
 #include <QtCore/QRegularExpression>
 using namespace QtJsonSerializer;
@@ -15,19 +16,33 @@ void SequentialWriter::registerWriter(int metaTypeId, SequentialWriterFactory *f
 	QWriteLocker _{&MetaWritersPrivate::sequenceLock};
 	MetaWritersPrivate::sequenceFactories.insert(metaTypeId, factory);
 	MetaWritersPrivate::sequenceInfoCache.remove(metaTypeId);
+	SerializerBasePrivate::registryRevision.ref();
 	qCDebug(logSeqWriter) << "Added factory for type:" << QMetaTypeName(metaTypeId);
 }
 
 bool SequentialWriter::canWrite(int metaTypeId)
 {
-	QReadLocker _{&MetaWritersPrivate::sequenceLock};
-	return MetaWritersPrivate::sequenceFactories.contains(metaTypeId);
+	return MetaWritersPrivate::sequenceFactory(metaTypeId);
+}
+
+SequentialWriter *SequentialWriter::getWriter(QVariant &data, void *storage, QSharedPointer<SequentialWriter> &sharedWriter)
+{
+	const auto factory = MetaWritersPrivate::sequenceFactory(data.userType());
+	if (factory) {
+		qCDebug(logSeqWriter) << "Found factory for data of type:" << QMetaTypeName(data.userType());
+		if (const auto writer = factory->createInPlace(data.data(), storage); writer)
+			return writer;
+		sharedWriter = factory->create(data.data());
+		return sharedWriter.data();
+	} else {
+		qCWarning(logSeqWriter) << "Unable to find factory for data of type:" << QMetaTypeName(data.userType());
+		return nullptr;
+	}
 }
 
 QSharedPointer<SequentialWriter> SequentialWriter::getWriter(QVariant &data)
 {
-	QReadLocker _{&MetaWritersPrivate::sequenceLock};
-	const auto factory = MetaWritersPrivate::sequenceFactories.value(data.userType());
+	const auto factory = MetaWritersPrivate::sequenceFactory(data.userType());
 	if (factory) {
 		qCDebug(logSeqWriter) << "Found factory for data of type:" << QMetaTypeName(data.userType());
 		return factory->create(data.data());
@@ -39,30 +54,31 @@ QSharedPointer<SequentialWriter> SequentialWriter::getWriter(QVariant &data)
 
 SequentialWriter::SequenceInfo SequentialWriter::getInfo(int metaTypeId)
 {
-	QReadLocker rLocker{&MetaWritersPrivate::sequenceLock};
-	auto it = MetaWritersPrivate::sequenceInfoCache.find(metaTypeId);
-	if (it != MetaWritersPrivate::sequenceInfoCache.end()) {
-		qCDebug(logSeqWriter) << "Found SequenceInfo for type" << QMetaTypeName(metaTypeId)
-							  << "in cache";
-		return *it;
-	} else {
-		rLocker.unlock();
-		QWriteLocker wLocker{&MetaWritersPrivate::sequenceLock};
-		const auto factory = MetaWritersPrivate::sequenceFactories.value(metaTypeId);
-		if (factory) {
-			qCDebug(logSeqWriter) << "Found factory to generate SequenceInfo for type:" << QMetaTypeName(metaTypeId);
-			it = MetaWritersPrivate::sequenceInfoCache.insert(metaTypeId, factory->create(nullptr)->info());
-		} else {
-			qCWarning(logSeqWriter) << "Unable to find SequenceInfo for type" << QMetaTypeName(metaTypeId)
-									<< "- trying to guess by parsing the types name";
-			it = MetaWritersPrivate::sequenceInfoCache.insert(metaTypeId, MetaWritersPrivate::tryParseSequenceInfo(metaTypeId));
-		}
-		return *it;
-	}
+	thread_local QHash<int, SequenceInfo> cache;
+	thread_local int cacheRevision = -1;
+	return MetaWritersPrivate::threadCached(cache, cacheRevision, metaTypeId, [metaTypeId]() {
+		return MetaWritersPrivate::resolveSequenceInfo(metaTypeId);
+	});
 }
 
 SequentialWriter::~SequentialWriter() = default;
 
+void SequentialWriter::add(QVariant &&value)
+{
+	add(static_cast<const QVariant&>(value));
+}
+
+void SequentialWriter::addRange(QVariantList &&values)
+{
+	for (auto &value : values)
+		add(std::move(value));
+}
+
+bool SequentialWriter::clear()
+{
+	return false;
+}
+
 SequentialWriter::SequentialWriter() = default;
 
 
@@ -71,6 +87,13 @@ SequentialWriterFactory::SequentialWriterFactory() = default;
 
 SequentialWriterFactory::~SequentialWriterFactory() = default;
 
+SequentialWriter *SequentialWriterFactory::createInPlace(void *data, void *storage) const
+{
+	Q_UNUSED(data)
+	Q_UNUSED(storage)
+	return nullptr;
+}
+
 
 
 void AssociativeWriter::registerWriter(int metaTypeId, AssociativeWriterFactory *factory)
@@ -79,19 +102,33 @@ void AssociativeWriter::registerWriter(int metaTypeId, AssociativeWriterFactory
 	QWriteLocker _{&MetaWritersPrivate::associationLock};
 	MetaWritersPrivate::associationFactories.insert(metaTypeId, factory);
 	MetaWritersPrivate::associationInfoCache.remove(metaTypeId);
+	SerializerBasePrivate::registryRevision.ref();
 	qCDebug(logAsocWriter) << "Added factory for type:" << QMetaTypeName(metaTypeId);
 }
 
 bool AssociativeWriter::canWrite(int metaTypeId)
 {
-	QReadLocker _{&MetaWritersPrivate::associationLock};
-	return MetaWritersPrivate::associationFactories.contains(metaTypeId);
+	return MetaWritersPrivate::associationFactory(metaTypeId);
+}
+
+AssociativeWriter *AssociativeWriter::getWriter(QVariant &data, void *storage, QSharedPointer<AssociativeWriter> &sharedWriter)
+{
+	const auto factory = MetaWritersPrivate::associationFactory(data.userType());
+	if (factory) {
+		qCDebug(logAsocWriter) << "Found factory for data of type:" << QMetaTypeName(data.userType());
+		if (const auto writer = factory->createInPlace(data.data(), storage); writer)
+			return writer;
+		sharedWriter = factory->create(data.data());
+		return sharedWriter.data();
+	} else {
+		qCWarning(logAsocWriter) << "Unable to find factory for data of type:" << QMetaTypeName(data.userType());
+		return nullptr;
+	}
 }
 
 QSharedPointer<AssociativeWriter> AssociativeWriter::getWriter(QVariant &data)
 {
-	QReadLocker _{&MetaWritersPrivate::associationLock};
-	const auto factory = MetaWritersPrivate::associationFactories.value(data.userType());
+	const auto factory = MetaWritersPrivate::associationFactory(data.userType());
 	if (factory) {
 		qCDebug(logAsocWriter) << "Found factory for data of type:" << QMetaTypeName(data.userType());
 		return factory->create(data.data());
@@ -103,30 +140,30 @@ QSharedPointer<AssociativeWriter> AssociativeWriter::getWriter(QVariant &data)
 
 AssociativeWriter::AssociationInfo AssociativeWriter::getInfo(int metaTypeId)
 {
-	QReadLocker rLocker{&MetaWritersPrivate::associationLock};
-	auto it = MetaWritersPrivate::associationInfoCache.find(metaTypeId);
-	if (it != MetaWritersPrivate::associationInfoCache.end()) {
-		qCDebug(logAsocWriter) << "Found SequenceInfo for type" << QMetaTypeName(metaTypeId)
-							   << "in cache";
-		return *it;
-	} else {
-		rLocker.unlock();
-		QWriteLocker wLocker{&MetaWritersPrivate::associationLock};
-		const auto factory = MetaWritersPrivate::associationFactories.value(metaTypeId);
-		if (factory) {
-			qCDebug(logAsocWriter) << "Found factory to generate SequenceInfo for type:" << QMetaTypeName(metaTypeId);
-			it = MetaWritersPrivate::associationInfoCache.insert(metaTypeId, factory->create(nullptr)->info());
-		} else {
-			qCWarning(logAsocWriter) << "Unable to find SequenceInfo for type" << QMetaTypeName(metaTypeId)
-									 << "- trying to guess by parsing the types name";
-			it = MetaWritersPrivate::associationInfoCache.insert(metaTypeId, MetaWritersPrivate::tryParseAssociationInfo(metaTypeId));
-		}
-		return *it;
-	}
+	thread_local QHash<int, AssociationInfo> cache;
+	thread_local int cacheRevision = -1;
+	return MetaWritersPrivate::threadCached(cache, cacheRevision, metaTypeId, [metaTypeId]() {
+		return MetaWritersPrivate::resolveAssociationInfo(metaTypeId);
+	});
 }
 
 AssociativeWriter::~AssociativeWriter() = default;
 
+void AssociativeWriter::reserve(int size)
+{
+	Q_UNUSED(size)
+}
+
+void AssociativeWriter::add(QVariant &&key, QVariant &&value)
+{
+	add(static_cast<const QVariant&>(key), static_cast<const QVariant&>(value));
+}
+
+bool AssociativeWriter::clear()
+{
+	return false;
+}
+
 AssociativeWriter::AssociativeWriter() = default;
 
 
@@ -135,6 +172,13 @@ AssociativeWriterFactory::AssociativeWriterFactory() = default;
 
 AssociativeWriterFactory::~AssociativeWriterFactory() = default;
 
+AssociativeWriter *AssociativeWriterFactory::createInPlace(void *data, void *storage) const
+{
+	Q_UNUSED(data)
+	Q_UNUSED(storage)
+	return nullptr;
+}
+
 
 
 SequentialWriterImpl<QList, QVariant>::SequentialWriterImpl(QVariantList *data)
@@ -156,6 +200,25 @@ void SequentialWriterImpl<QList, QVariant>::add(const QVariant &value)
 	_data->append(value);
 }
 
+void SequentialWriterImpl<QList, QVariant>::add(QVariant &&value)
+{
+	_data->append(std::move(value));
+}
+
+void SequentialWriterImpl<QList, QVariant>::addRange(QVariantList &&values)
+{
+	if (_data->isEmpty())
+		*_data = std::move(values);
+	else
+		_data->append(std::move(values));
+}
+
+bool SequentialWriterImpl<QList, QVariant>::clear()
+{
+	_data->clear();
+	return true;
+}
+
 
 
 AssociativeWriterImpl<QMap, QString, QVariant>::AssociativeWriterImpl(QVariantMap *data)
@@ -167,11 +230,28 @@ AssociativeWriter::AssociationInfo AssociativeWriterImpl<QMap, QString, QVariant
 	return {QMetaType::QString, QMetaType::UnknownType};
 }
 
+void AssociativeWriterImpl<QMap, QString, QVariant>::reserve(int size)
+{
+	// QMap cannot preallocate its nodes
+	Q_UNUSED(size)
+}
+
 void AssociativeWriterImpl<QMap, QString, QVariant>::add(const QVariant &key, const QVariant &value)
 {
 	_data->insert(key.toString(), value);
 }
 
+void AssociativeWriterImpl<QMap, QString, QVariant>::add(QVariant &&key, QVariant &&value)
+{
+	_data->insert(key.toString(), std::move(value));
+}
+
+bool AssociativeWriterImpl<QMap, QString, QVariant>::clear()
+{
+	_data->clear();
+	return true;
+}
+
 AssociativeWriterImpl<QHash, QString, QVariant>::AssociativeWriterImpl(QVariantHash *data)
 	: _data{data}
 {}
@@ -181,11 +261,27 @@ AssociativeWriter::AssociationInfo AssociativeWriterImpl<QHash, QString, QVarian
 	return {QMetaType::QString, QMetaType::UnknownType};
 }
 
+void AssociativeWriterImpl<QHash, QString, QVariant>::reserve(int size)
+{
+	_data->reserve(size);
+}
+
 void AssociativeWriterImpl<QHash, QString, QVariant>::add(const QVariant &key, const QVariant &value)
 {
 	_data->insert(key.toString(), value);
 }
 
+void AssociativeWriterImpl<QHash, QString, QVariant>::add(QVariant &&key, QVariant &&value)
+{
+	_data->insert(key.toString(), std::move(value));
+}
+
+bool AssociativeWriterImpl<QHash, QString, QVariant>::clear()
+{
+	_data->clear();
+	return true;
+}
+
 // ------------- private implementation -------------
 
 QReadWriteLock MetaWritersPrivate::sequenceLock;
@@ -203,6 +299,89 @@ QHash<int, AssociativeWriterFactory*> MetaWritersPrivate::associationFactories {
 };
 QHash<int, AssociativeWriter::AssociationInfo> MetaWritersPrivate::associationInfoCache;
 
+template <typename TValue, typename TResolver>
+TValue MetaWritersPrivate::threadCached(QHash<int, TValue> &cache, int &cacheRevision, int metaTypeId, TResolver &&resolve)
+{
+	// every registration bumps the revision, which drops all thread caches
+	if (const auto revision = SerializerBasePrivate::registryRevision.loadAcquire(); revision != cacheRevision) {
+		cache.clear();
+		cacheRevision = revision;
+	}
+
+	auto it = cache.constFind(metaTypeId);
+	if (it == cache.constEnd())
+		it = cache.insert(metaTypeId, resolve());
+	return *it;
+}
+
+SequentialWriterFactory *MetaWritersPrivate::sequenceFactory(int metaTypeId)
+{
+	thread_local QHash<int, SequentialWriterFactory*> cache;
+	thread_local int cacheRevision = -1;
+	return threadCached(cache, cacheRevision, metaTypeId, [metaTypeId]() {
+		QReadLocker _{&sequenceLock};
+		return sequenceFactories.value(metaTypeId);
+	});
+}
+
+AssociativeWriterFactory *MetaWritersPrivate::associationFactory(int metaTypeId)
+{
+	thread_local QHash<int, AssociativeWriterFactory*> cache;
+	thread_local int cacheRevision = -1;
+	return threadCached(cache, cacheRevision, metaTypeId, [metaTypeId]() {
+		QReadLocker _{&associationLock};
+		return associationFactories.value(metaTypeId);
+	});
+}
+
+SequentialWriter::SequenceInfo MetaWritersPrivate::resolveSequenceInfo(int metaTypeId)
+{
+	QReadLocker rLocker{&sequenceLock};
+	auto it = sequenceInfoCache.find(metaTypeId);
+	if (it != sequenceInfoCache.end()) {
+		qCDebug(logSeqWriter) << "Found SequenceInfo for type" << QMetaTypeName(metaTypeId)
+							  << "in cache";
+		return *it;
+	} else {
+		rLocker.unlock();
+		QWriteLocker wLocker{&sequenceLock};
+		const auto factory = sequenceFactories.value(metaTypeId);
+		if (factory) {
+			qCDebug(logSeqWriter) << "Found factory to generate SequenceInfo for type:" << QMetaTypeName(metaTypeId);
+			it = sequenceInfoCache.insert(metaTypeId, factory->create(nullptr)->info());
+		} else {
+			qCWarning(logSeqWriter) << "Unable to find SequenceInfo for type" << QMetaTypeName(metaTypeId)
+									<< "- trying to guess by parsing the types name";
+			it = sequenceInfoCache.insert(metaTypeId, tryParseSequenceInfo(metaTypeId));
+		}
+		return *it;
+	}
+}
+
+AssociativeWriter::AssociationInfo MetaWritersPrivate::resolveAssociationInfo(int metaTypeId)
+{
+	QReadLocker rLocker{&associationLock};
+	auto it = associationInfoCache.find(metaTypeId);
+	if (it != associationInfoCache.end()) {
+		qCDebug(logAsocWriter) << "Found SequenceInfo for type" << QMetaTypeName(metaTypeId)
+							   << "in cache";
+		return *it;
+	} else {
+		rLocker.unlock();
+		QWriteLocker wLocker{&associationLock};
+		const auto factory = associationFactories.value(metaTypeId);
+		if (factory) {
+			qCDebug(logAsocWriter) << "Found factory to generate SequenceInfo for type:" << QMetaTypeName(metaTypeId);
+			it = associationInfoCache.insert(metaTypeId, factory->create(nullptr)->info());
+		} else {
+			qCWarning(logAsocWriter) << "Unable to find SequenceInfo for type" << QMetaTypeName(metaTypeId)
+									 << "- trying to guess by parsing the types name";
+			it = associationInfoCache.insert(metaTypeId, tryParseAssociationInfo(metaTypeId));
+		}
+		return *it;
+	}
+}
+
 SequentialWriter::SequenceInfo MetaWritersPrivate::tryParseSequenceInfo(int metaTypeId)
 {
 	if (metaTypeId == QMetaType::QStringList)
@@ -15,8 +15,16 @@
 #include <QtCore/qlinkedlist.h>
 #endif
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace QtJsonSerializer::MetaWriters {
 
+//! The size of the storage writers are created in by ScopedWriter
+constexpr std::size_t WriterStorageSize = 4 * sizeof(void*);
+
 class SequentialWriterFactory;
 //! The writer class for sequential containers
 class Q_JSONSERIALIZER_EXPORT SequentialWriter
@@ -41,6 +49,8 @@ public:
 	static bool canWrite(int metaTypeId);
 	//! Returns a writer instance for the given data, or nullptr if none found
 	static QSharedPointer<SequentialWriter> getWriter(QVariant &data);
+	//! @private
+	static SequentialWriter *getWriter(QVariant &data, void *storage, QSharedPointer<SequentialWriter> &sharedWriter);
 	//! Returns the information details of the given type
 	static SequenceInfo getInfo(int metaTypeId);
 
@@ -51,6 +61,12 @@ public:
 	virtual void reserve(int size) = 0;
 	//! Adds an element to the "end" of the container
 	virtual void add(const QVariant &value) = 0;
+	//! Moves an element to the "end" of the container
+	virtual void add(QVariant &&value);
+	//! Moves all of the elements to the "end" of the container
+	virtual void addRange(QVariantList &&values);
+	//! Removes all elements from the container, or returns false if the writer cannot do so
+	virtual bool clear();
 
 protected:
 	//! @private
@@ -67,6 +83,8 @@ public:
 	virtual ~SequentialWriterFactory();
 	//! Factory method to create the instance. data can be null for read-only writers
 	virtual QSharedPointer<SequentialWriter> create(void *data) const = 0;
+	//! Creates the instance in storage of WriterStorageSize bytes, or returns nullptr if not supported
+	virtual SequentialWriter *createInPlace(void *data, void *storage) const;
 };
 
 
@@ -95,14 +113,22 @@ public:
 	static bool canWrite(int metaTypeId);
 	//! Returns a writer instance for the given data, or nullptr if none found
 	static QSharedPointer<AssociativeWriter> getWriter(QVariant &data);
+	//! @private
+	static AssociativeWriter *getWriter(QVariant &data, void *storage, QSharedPointer<AssociativeWriter> &sharedWriter);
 	//! Returns the information details of the given type
 	static AssociationInfo getInfo(int metaTypeId);
 
 	virtual ~AssociativeWriter();
 	//! Return the information for the wrapped container
 	virtual AssociationInfo info() const = 0;
+	//! Reserves space for size entries in the container, if the container supports it
+	virtual void reserve(int size);
 	//! Inserts the given value for the given key into the container
 	virtual void add(const QVariant &key, const QVariant &value) = 0;
+	//! Moves the given value for the given key into the container
+	virtual void add(QVariant &&key, QVariant &&value);
+	//! Removes all entries from the container, or returns false if the writer cannot do so
+	virtual bool clear();
 
 protected:
 	//! @private
@@ -119,12 +145,60 @@ public:
 	virtual ~AssociativeWriterFactory();
 	//! Factory method to create the instance. data can be null for read-only writers
 	virtual QSharedPointer<AssociativeWriter> create(void *data) const = 0;
+	//! Creates the instance in storage of WriterStorageSize bytes, or returns nullptr if not supported
+	virtual AssociativeWriter *createInPlace(void *data, void *storage) const;
 };
 
+//! Holds the writer for a container for as long as it is in scope, without a heap allocation if possible
+template <typename TWriter>
+class ScopedWriter
+{
+	Q_DISABLE_COPY(ScopedWriter)
+
+public:
+	//! Creates a writer for the given data, which is invalid if no writer was found
+	explicit ScopedWriter(QVariant &data);
+	~ScopedWriter();
+
+	//! Returns the writer, or nullptr if none was found
+	TWriter *data() const;
+	//! Access the writer
+	TWriter *operator->() const;
+	//! Checks if a writer was found
+	explicit operator bool() const;
+
+private:
+	alignas(std::max_align_t) char _storage[WriterStorageSize];
+	QSharedPointer<TWriter> _sharedWriter;
+	TWriter *_writer;
+};
+
+//! A ScopedWriter for sequential containers
+using ScopedSequentialWriter = ScopedWriter<SequentialWriter>;
+//! A ScopedWriter for associative containers
+using ScopedAssociativeWriter = ScopedWriter<AssociativeWriter>;
+
 // ------------- Generic Implementation classes -------------
 
 namespace Implementations {
 
+// moves the value out of the variant if it holds exactly that type, and converts it otherwise
+template <typename T>
+T takeValue(QVariant &&value)
+{
+	if constexpr (std::is_same_v<T, QVariant>)
+		return std::move(value);
+	else if (value.userType() == qMetaTypeId<T>())
+		return std::move(*static_cast<T*>(value.data()));
+	else
+		return value.template value<T>();
+}
+
+template <typename T, typename = void>
+struct has_reserve : public std::false_type {};
+template <typename T>
+struct has_reserve<T, std::void_t<decltype(std::declval<T&>().reserve(0))>> : public std::true_type {};
+
 template <template<typename> class TContainer, typename TClass>
 class SequentialWriterImpl final : public SequentialWriter
 {
@@ -145,6 +219,21 @@ public:
 		_data->append(value.template value<TClass>());
 	}
 
+	void add(QVariant &&value) final {
+		_data->append(takeValue<TClass>(std::move(value)));
+	}
+
+	void addRange(QVariantList &&values) final {
+		_data->reserve(_data->size() + values.size());
+		for (auto &value : values)
+			_data->append(takeValue<TClass>(std::move(value)));
+	}
+
+	bool clear() final {
+		_data->clear();
+		return true;
+	}
+
 private:
 	TContainer<TClass> *_data;
 };
@@ -156,6 +245,12 @@ public:
 	QSharedPointer<SequentialWriter> create(void *data) const final {
 		return QSharedPointer<SequentialWriterImpl<TContainer, TClass>>::create(reinterpret_cast<TContainer<TClass>*>(data));
 	}
+
+	SequentialWriter *createInPlace(void *data, void *storage) const final {
+		using Writer = SequentialWriterImpl<TContainer, TClass>;
+		static_assert(sizeof(Writer) <= WriterStorageSize && alignof(Writer) <= alignof(std::max_align_t));
+		return new (storage) Writer{reinterpret_cast<TContainer<TClass>*>(data)};
+	}
 };
 
 
@@ -172,11 +267,28 @@ public:
 		return {qMetaTypeId<TKey>(), qMetaTypeId<TValue>()};
 	}
 
+	void reserve(int size) final {
+		if constexpr (has_reserve<TContainer<TKey, TValue>>::value)
+			_data->reserve(size);
+		else
+			Q_UNUSED(size)
+	}
+
 	void add(const QVariant &key, const QVariant &value) final {
 		_data->insert(key.template value<TKey>(),
 					  value.template value<TValue>());
 	}
 
+	void add(QVariant &&key, QVariant &&value) final {
+		_data->insert(takeValue<TKey>(std::move(key)),
+					  takeValue<TValue>(std::move(value)));
+	}
+
+	bool clear() final {
+		_data->clear();
+		return true;
+	}
+
 private:
 	TContainer<TKey, TValue> *_data;
 };
@@ -188,6 +300,12 @@ public:
 	QSharedPointer<AssociativeWriter> create(void *data) const final {
 		return QSharedPointer<AssociativeWriterImpl<TContainer, TKey, TValue>>::create(reinterpret_cast<TContainer<TKey, TValue>*>(data));
 	}
+
+	AssociativeWriter *createInPlace(void *data, void *storage) const final {
+		using Writer = AssociativeWriterImpl<TContainer, TKey, TValue>;
+		static_assert(sizeof(Writer) <= WriterStorageSize && alignof(Writer) <= alignof(std::max_align_t));
+		return new (storage) Writer{reinterpret_cast<TContainer<TKey, TValue>*>(data)};
+	}
 };
 
 // ------------- Specializations and base generic implementations -------------
@@ -212,6 +330,21 @@ public:
 		_data->insert(value.template value<TClass>());
 	}
 
+	void add(QVariant &&value) final {
+		_data->insert(takeValue<TClass>(std::move(value)));
+	}
+
+	void addRange(QVariantList &&values) final {
+		_data->reserve(_data->size() + values.size());
+		for (auto &value : values)
+			_data->insert(takeValue<TClass>(std::move(value)));
+	}
+
+	bool clear() final {
+		_data->clear();
+		return true;
+	}
+
 private:
 	QSet<TClass> *_data;
 };
@@ -235,6 +368,15 @@ public:
 		_data->append(value.template value<TClass>());
 	}
 
+	void add(QVariant &&value) final {
+		_data->append(takeValue<TClass>(std::move(value)));
+	}
+
+	bool clear() final {
+		_data->clear();
+		return true;
+	}
+
 private:
 	QLinkedList<TClass> *_data;
 };
@@ -249,6 +391,9 @@ public:
 	SequenceInfo info() const final;
 	void reserve(int size) final;
 	void add(const QVariant &value) final;
+	void add(QVariant &&value) final;
+	void addRange(QVariantList &&values) final;
+	bool clear() final;
 
 private:
 	QVariantList *_data;
@@ -263,7 +408,10 @@ public:
 	AssociativeWriterImpl(QVariantMap *data);
 
 	AssociationInfo info() const final;
+	void reserve(int size) final;
 	void add(const QVariant &key, const QVariant &value) final;
+	void add(QVariant &&key, QVariant &&value) final;
+	bool clear() final;
 
 private:
 	QVariantMap *_data;
@@ -276,7 +424,10 @@ public:
 	AssociativeWriterImpl(QVariantHash *data);
 
 	AssociationInfo info() const final;
+	void reserve(int size) final;
 	void add(const QVariant &key, const QVariant &value) final;
+	void add(QVariant &&key, QVariant &&value) final;
+	bool clear() final;
 
 private:
 	QVariantHash *_data;
@@ -298,6 +449,37 @@ void AssociativeWriter::registerWriter()
 				   new Implementations::AssociativeWriterFactoryImpl<TContainer, TKey, TValue>{});
 }
 
+template<typename TWriter>
+ScopedWriter<TWriter>::ScopedWriter(QVariant &data) :
+	_writer{TWriter::getWriter(data, _storage, _sharedWriter)}
+{}
+
+template<typename TWriter>
+ScopedWriter<TWriter>::~ScopedWriter()
+{
+	// only writers created in the storage have to be destroyed manually
+	if (_writer && !_sharedWriter)
+		_writer->~TWriter();
+}
+
+template<typename TWriter>
+TWriter *ScopedWriter<TWriter>::data() const
+{
+	return _writer;
+}
+
+template<typename TWriter>
+TWriter *ScopedWriter<TWriter>::operator->() const
+{
+	return _writer;
+}
+
+template<typename TWriter>
+ScopedWriter<TWriter>::operator bool() const
+{
+	return _writer;
+}
+
 }
 
 #endif // QTJSONSERIALIZER_METAWRITERS_H
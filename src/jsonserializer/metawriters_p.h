@@ -18,6 +18,14 @@ public:
 	static QHash<int, AssociativeWriterFactory*> associationFactories;
 	static QHash<int, AssociativeWriter::AssociationInfo> associationInfoCache;
 
+	// lookups without the locks, via per thread caches that are dropped whenever something is registered
+	template <typename TValue, typename TResolver>
+	static TValue threadCached(QHash<int, TValue> &cache, int &cacheRevision, int metaTypeId, TResolver &&resolve);
+	static SequentialWriterFactory *sequenceFactory(int metaTypeId);
+	static AssociativeWriterFactory *associationFactory(int metaTypeId);
+
+	static SequentialWriter::SequenceInfo resolveSequenceInfo(int metaTypeId);
+	static AssociativeWriter::AssociationInfo resolveAssociationInfo(int metaTypeId);
 	static SequentialWriter::SequenceInfo tryParseSequenceInfo(int metaTypeId);
 	static AssociativeWriter::AssociationInfo tryParseAssociationInfo(int metaTypeId);
 };
@@ -35,6 +43,10 @@ public:
 	QSharedPointer<SequentialWriter> create(void *data) const final {
 		return QSharedPointer<SequentialWriterImpl<QList, QString>>::create(reinterpret_cast<QStringList*>(data));
 	}
+
+	SequentialWriter *createInPlace(void *data, void *storage) const final {
+		return new (storage) SequentialWriterImpl<QList, QString>{reinterpret_cast<QStringList*>(data)};
+	}
 };
 
 class SequentialWriterFactoryQByteArrayList : public SequentialWriterFactory
@@ -43,6 +55,10 @@ public:
 	QSharedPointer<SequentialWriter> create(void *data) const final {
 		return QSharedPointer<SequentialWriterImpl<QList, QByteArray>>::create(reinterpret_cast<QByteArrayList*>(data));
 	}
+
+	SequentialWriter *createInPlace(void *data, void *storage) const final {
+		return new (storage) SequentialWriterImpl<QList, QByteArray>{reinterpret_cast<QByteArrayList*>(data)};
+	}
 };
 
 class SequentialWriterFactoryQVariantList : public SequentialWriterFactory
@@ -51,6 +67,10 @@ public:
 	QSharedPointer<SequentialWriter> create(void *data) const final {
 		return QSharedPointer<SequentialWriterImpl<QList, QVariant>>::create(reinterpret_cast<QVariantList*>(data));
 	}
+
+	SequentialWriter *createInPlace(void *data, void *storage) const final {
+		return new (storage) SequentialWriterImpl<QList, QVariant>{reinterpret_cast<QVariantList*>(data)};
+	}
 };
 
 
@@ -61,6 +81,10 @@ public:
 	QSharedPointer<AssociativeWriter> create(void *data) const final {
 		return QSharedPointer<AssociativeWriterImpl<QMap, QString, QVariant>>::create(reinterpret_cast<QVariantMap*>(data));
 	}
+
+	AssociativeWriter *createInPlace(void *data, void *storage) const final {
+		return new (storage) AssociativeWriterImpl<QMap, QString, QVariant>{reinterpret_cast<QVariantMap*>(data)};
+	}
 };
 
 class AssociativeWriterFactoryQVariantHash : public AssociativeWriterFactory
@@ -69,6 +93,10 @@ public:
 	QSharedPointer<AssociativeWriter> create(void *data) const final {
 		return QSharedPointer<AssociativeWriterImpl<QHash, QString, QVariant>>::create(reinterpret_cast<QVariantHash*>(data));
 	}
+
+	AssociativeWriter *createInPlace(void *data, void *storage) const final {
+		return new (storage) AssociativeWriterImpl<QHash, QString, QVariant>{reinterpret_cast<QVariantHash*>(data)};
+	}
 };
 
 }
@@ -0,0 +1,210 @@
+#include "patch_p.h"
+#include "exception.h"
+using namespace QtJsonSerializer;
+
+QCborValue JsonPatch::createMergePatch(const QCborValue &from, const QCborValue &to)
+{
+	// only maps can be patched partially, everything else is replaced as a whole
+	if (!from.isMap() || !to.isMap())
+		return to;
+
+	const auto fromMap = from.toMap();
+	const auto toMap = to.toMap();
+	QCborMap patch;
+	for (auto it = fromMap.constBegin(), end = fromMap.constEnd(); it != end; ++it) {
+		if (!toMap.contains(it.key()))
+			patch.insert(it.key(), QCborValue::Null);
+	}
+	for (auto it = toMap.constBegin(), end = toMap.constEnd(); it != end; ++it) {
+		const QCborValue toValue = it.value();
+		const auto fIt = fromMap.constFind(it.key());
+		if (fIt == fromMap.constEnd()) {
+			patch.insert(it.key(), toValue);
+			continue;
+		}
+		const QCborValue fromValue = fIt.value();
+		if (fromValue != toValue)
+			patch.insert(it.key(), createMergePatch(fromValue, toValue));
+	}
+	return patch;
+}
+
+bool JsonPatch::canMerge(const QCborValue &from, const QCborValue &to)
+{
+	if (!from.isMap() || !to.isMap())
+		return true;
+
+	// a null in the merge patch would remove the value instead of setting it to null
+	const auto fromMap = from.toMap();
+	const auto toMap = to.toMap();
+	for (auto it = toMap.constBegin(), end = toMap.constEnd(); it != end; ++it) {
+		const QCborValue toValue = it.value();
+		const auto fIt = fromMap.constFind(it.key());
+		if (fIt == fromMap.constEnd()) {
+			if (toValue.isNull())
+				return false;
+			continue;
+		}
+		const QCborValue fromValue = fIt.value();
+		if (fromValue == toValue)
+			continue;
+		if (toValue.isNull() || !canMerge(fromValue, toValue))
+			return false;
+	}
+	return true;
+}
+
+QCborValue JsonPatch::applyOperations(QCborValue document, const QCborArray &operations)
+{
+	for (const auto &opValue : operations) {
+		const auto opMap = opValue.toMap();
+		const auto op = opMap.value(QStringLiteral("op")).toString();
+		const auto path = parsePointer(opMap.value(QStringLiteral("path")).toString());
+		if (op == QStringLiteral("add")) {
+			if (!opMap.contains(QStringLiteral("value")))
+				throw DeserializationException{"Patch operation \"add\" requires a value"};
+			document = applyAt(document, path, 0, Operation::Add, opMap.value(QStringLiteral("value")));
+		} else if (op == QStringLiteral("remove"))
+			document = applyAt(document, path, 0, Operation::Remove, {});
+		else if (op == QStringLiteral("replace")) {
+			if (!opMap.contains(QStringLiteral("value")))
+				throw DeserializationException{"Patch operation \"replace\" requires a value"};
+			document = applyAt(document, path, 0, Operation::Replace, opMap.value(QStringLiteral("value")));
+		} else if (op == QStringLiteral("move")) {
+			const auto from = parsePointer(opMap.value(QStringLiteral("from")).toString());
+			if (from.size() < path.size() && path.mid(0, from.size()) == from)
+				throw DeserializationException{"Patch operation \"move\" cannot move a value into one of its children"};
+			const auto value = valueAt(document, from);
+			document = applyAt(document, from, 0, Operation::Remove, {});
+			document = applyAt(document, path, 0, Operation::Add, value);
+		} else if (op == QStringLiteral("copy")) {
+			const auto from = parsePointer(opMap.value(QStringLiteral("from")).toString());
+			document = applyAt(document, path, 0, Operation::Add, valueAt(document, from));
+		} else if (op == QStringLiteral("test")) {
+			if (valueAt(document, path) != opMap.value(QStringLiteral("value")))
+				throw DeserializationException{"Patch operation \"test\" failed for path " + opMap.value(QStringLiteral("path")).toString().toUtf8()};
+		} else
+			throw DeserializationException{"Unknown patch operation: " + op.toUtf8()};
+	}
+	return document;
+}
+
+QVariant JsonPatch::defaultValue(int metaTypeId)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return QVariant{metaTypeId, nullptr};
+#else
+	return QVariant{QMetaType(metaTypeId), nullptr};
+#endif
+}
+
+QStringList JsonPatch::parsePointer(const QString &pointer)
+{
+	// the empty pointer references the whole document
+	if (pointer.isEmpty())
+		return {};
+	if (!pointer.startsWith(QLatin1Char('/')))
+		throw DeserializationException{"Invalid JSON pointer: " + pointer.toUtf8()};
+
+	auto tokens = pointer.mid(1).split(QLatin1Char('/'));
+	for (auto &token : tokens) {
+		token.replace(QStringLiteral("~1"), QStringLiteral("/"));
+		token.replace(QStringLiteral("~0"), QStringLiteral("~"));
+	}
+	return tokens;
+}
+
+qsizetype JsonPatch::parseIndex(const QString &token, qsizetype size, bool allowEnd)
+{
+	if (allowEnd && token == QStringLiteral("-"))
+		return size;
+
+	// leading zeros and signs are not allowed by RFC 6901
+	auto ok = !token.isEmpty() &&
+			  (token.size() == 1 || token[0] != QLatin1Char('0')) &&
+			  token[0].isDigit();
+	const auto index = ok ? static_cast<qsizetype>(token.toLongLong(&ok)) : -1;
+	if (!ok || index < 0 || index > size || (!allowEnd && index == size))
+		throw DeserializationException{"Invalid array index in JSON pointer: " + token.toUtf8()};
+	return index;
+}
+
+QCborValue JsonPatch::valueAt(const QCborValue &document, const QStringList &tokens)
+{
+	auto node = document;
+	for (const auto &token : tokens) {
+		// tags of CBOR values are transparent
+		while (node.isTag())
+			node = node.taggedValue();
+		if (node.isMap()) {
+			const auto map = node.toMap();
+			const auto it = map.constFind(token);
+			if (it == map.constEnd())
+				throw DeserializationException{"JSON pointer references a missing key: " + token.toUtf8()};
+			node = it.value();
+		} else if (node.isArray()) {
+			const auto array = node.toArray();
+			node = array.at(parseIndex(token, array.size(), false));
+		} else
+			throw DeserializationException{"JSON pointer descends into a value that is neither an object nor an array: " + token.toUtf8()};
+	}
+	return node;
+}
+
+QCborValue JsonPatch::applyAt(const QCborValue &node, const QStringList &tokens, int pos, Operation operation, const QCborValue &value)
+{
+	// the whole document is addressed
+	if (tokens.isEmpty()) {
+		if (operation == Operation::Remove)
+			throw DeserializationException{"The whole document cannot be removed"};
+		return value;
+	}
+
+	// tags of CBOR values are transparent, but kept
+	if (node.isTag())
+		return {node.tag(), applyAt(node.taggedValue(), tokens, pos, operation, value)};
+
+	const auto &token = tokens[pos];
+	const auto isLast = pos == tokens.size() - 1;
+	if (node.isMap()) {
+		auto map = node.toMap();
+		const auto exists = map.contains(token);
+		if (!isLast) {
+			if (!exists)
+				throw DeserializationException{"JSON pointer references a missing key: " + token.toUtf8()};
+			map.insert(token, applyAt(map.value(token), tokens, pos + 1, operation, value));
+		} else if (operation == Operation::Add)
+			map.insert(token, value);
+		else if (!exists)
+			throw DeserializationException{"JSON pointer references a missing key: " + token.toUtf8()};
+		else if (operation == Operation::Remove)
+			map.remove(token);
+		else
+			map.insert(token, value);
+		return map;
+	} else if (node.isArray()) {
+		auto array = node.toArray();
+		const auto index = parseIndex(token, array.size(), isLast && operation == Operation::Add);
+		if (!isLast)
+			array[index] = applyAt(array.at(index), tokens, pos + 1, operation, value);
+		else if (operation == Operation::Add)
+			array.insert(index, value);
+		else if (operation == Operation::Remove)
+			array.removeAt(index);
+		else
+			array[index] = value;
+		return array;
+	} else
+		throw DeserializationException{"JSON pointer descends into a value that is neither an object nor an array: " + token.toUtf8()};
+}
+
+
+
+MergePatchContext::MergePatchContext(bool active) :
+	_scope{active}
+{}
+
+bool MergePatchContext::isActive()
+{
+	return Scope::current();
+}
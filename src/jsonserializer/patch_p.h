@@ -0,0 +1,61 @@
+#ifndef QTJSONSERIALIZER_PATCH_P_H
+#define QTJSONSERIALIZER_PATCH_P_H
+
+#include "qtjsonserializer_global.h"
+#include "ambientcontext_p.h"
+
+#include <QtCore/QCborValue>
+#include <QtCore/QCborArray>
+#include <QtCore/QCborMap>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+namespace QtJsonSerializer {
+
+// Implements RFC 7386 merge patches and RFC 6902 patch operations on serialized documents.
+// Merge patches are applied to live values by the converters, inside of a MergePatchContext.
+class Q_JSONSERIALIZER_EXPORT JsonPatch
+{
+public:
+	// creates the smallest merge patch that turns from into to
+	static QCborValue createMergePatch(const QCborValue &from, const QCborValue &to);
+	// checks if the merge patch from from to to can express to, i.e. it does not set any value to null
+	static bool canMerge(const QCborValue &from, const QCborValue &to);
+	// applies a list of patch operations to the document, throws a DeserializationException on failure
+	static QCborValue applyOperations(QCborValue document, const QCborArray &operations);
+	// the value a property is reset to, if a merge patch removes it
+	static QVariant defaultValue(int metaTypeId);
+
+private:
+	enum class Operation {
+		Add,
+		Remove,
+		Replace
+	};
+
+	static QStringList parsePointer(const QString &pointer);
+	static qsizetype parseIndex(const QString &token, qsizetype size, bool allowEnd);
+	static QCborValue valueAt(const QCborValue &document, const QStringList &tokens);
+	static QCborValue applyAt(const QCborValue &node, const QStringList &tokens, int pos, Operation operation, const QCborValue &value);
+};
+
+// Marks the in place deserialization of this thread as merge patch, for as long as the context
+// exists. Converters then keep everything the patch does not mention and treat null as removal.
+// Values that are replaced instead of updated must disable it again.
+class Q_JSONSERIALIZER_EXPORT MergePatchContext
+{
+	Q_DISABLE_COPY(MergePatchContext)
+public:
+	MergePatchContext(bool active);
+
+	static bool isActive();
+
+private:
+	using Scope = AmbientScope<MergePatchContext, bool>;
+
+	Scope _scope;
+};
+
+}
+
+#endif // QTJSONSERIALIZER_PATCH_P_H
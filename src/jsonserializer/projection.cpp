@@ -0,0 +1,51 @@
+#include "projection_p.h"
+using namespace QtJsonSerializer;
+
+ProjectionNode ProjectionNode::fromPaths(const QStringList &paths)
+{
+	ProjectionNode root;
+	root._all = paths.isEmpty();
+	for (const auto &path : paths) {
+		auto node = &root;
+		for (const auto &key : path.split(QLatin1Char('.'))) {
+			// a shorter path already selected everything below
+			if (node->_all)
+				break;
+			if (key.isEmpty())
+				continue;
+			node = &node->_children[key];
+		}
+		node->_all = true;
+		node->_children.clear();
+	}
+	return root;
+}
+
+const ProjectionNode *ProjectionNode::all()
+{
+	static const auto allNode = fromPaths({});
+	return &allNode;
+}
+
+bool ProjectionNode::selectsAll() const
+{
+	return _all;
+}
+
+const ProjectionNode *ProjectionNode::select(const QString &key) const
+{
+	if (_all || key.startsWith(QLatin1Char('@')))
+		return this;
+	const auto it = _children.constFind(key);
+	return it != _children.constEnd() ? &it.value() : nullptr;
+}
+
+ProjectionContext::ProjectionContext(const ProjectionNode *node) :
+	_scope{node}
+{}
+
+const ProjectionNode *ProjectionContext::current()
+{
+	const auto node = Scope::current();
+	return node ? node : ProjectionNode::all();
+}
@@ -0,0 +1,49 @@
+#ifndef QTJSONSERIALIZER_PROJECTION_P_H
+#define QTJSONSERIALIZER_PROJECTION_P_H
+
+#include "qtjsonserializer_global.h"
+#include "ambientcontext_p.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+namespace QtJsonSerializer {
+
+// A tree of the object keys selected for deserialization. Paths are made of keys separated by
+// dots, arrays are transparent. Keys starting with an @ carry information of the converters
+// themselves (like "@class") and are always selected, without descending into the tree.
+class Q_JSONSERIALIZER_EXPORT ProjectionNode
+{
+public:
+	static ProjectionNode fromPaths(const QStringList &paths);
+	static const ProjectionNode *all();
+
+	bool selectsAll() const;
+	// returns the node for the value of key, or nullptr if it is not selected
+	const ProjectionNode *select(const QString &key) const;
+
+private:
+	QHash<QString, ProjectionNode> _children;
+	bool _all = false;
+};
+
+// Makes a projection node the current one of this thread, for as long as the context exists.
+// Converters descend via select() and skip all keys that are not selected.
+class Q_JSONSERIALIZER_EXPORT ProjectionContext
+{
+	Q_DISABLE_COPY(ProjectionContext)
+public:
+	ProjectionContext(const ProjectionNode *node);
+
+	static const ProjectionNode *current();
+
+private:
+	using Scope = AmbientScope<ProjectionContext, const ProjectionNode*>;
+
+	Scope _scope;
+};
+
+}
+
+#endif // QTJSONSERIALIZER_PROJECTION_P_H
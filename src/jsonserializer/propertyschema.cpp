@@ -0,0 +1,126 @@
+#include "propertyschema_p.h"
+#include "exception.h"
+
+#include <QtCore/QMetaProperty>
+using namespace QtJsonSerializer;
+
+namespace {
+
+// FNV-1a, to get a stable fingerprint across processes of the same binary
+constexpr quint32 FnvOffsetBasis = 2166136261u;
+constexpr quint32 FnvPrime = 16777619u;
+
+void hashAppend(quint32 &hash, const char *data)
+{
+	for (; data && *data; ++data) {
+		hash ^= static_cast<quint8>(*data);
+		hash *= FnvPrime;
+	}
+}
+
+void hashAppend(quint32 &hash, char c)
+{
+	hash ^= static_cast<quint8>(c);
+	hash *= FnvPrime;
+}
+
+}
+
+QReadWriteLock PropertySchema::lock;
+QHash<PropertySchema::SchemaKey, PropertySchema> PropertySchema::schemaCache;
+
+PropertySchema PropertySchema::get(const QMetaObject *metaObject, int firstIndex, bool ignoreStoredAttribute)
+{
+	const SchemaKey key {metaObject, (firstIndex << 1) | (ignoreStoredAttribute ? 1 : 0)};
+	QReadLocker rLocker{&lock};
+	if (const auto it = schemaCache.constFind(key); it != schemaCache.constEnd())
+		return *it;
+	rLocker.unlock();
+
+	auto schema = create(metaObject, firstIndex, ignoreStoredAttribute);
+	QWriteLocker wLocker{&lock};
+	schemaCache.insert(key, schema);
+	return schema;
+}
+
+std::optional<PropertySchema> PropertySchema::find(const QMetaObject *metaObject, quint32 fingerprint, std::initializer_list<int> firstIndices, bool ignoreStoredAttribute)
+{
+	// only schemas of the target and its base classes can be mapped back to the target by name,
+	// so they are the only candidates - independent of what else was serialized in this process
+	std::optional<PropertySchema> match;
+	for (auto level = metaObject; level; level = level->superClass()) {
+		for (const auto firstIndex : firstIndices) {
+			for (const auto ignore : {ignoreStoredAttribute, !ignoreStoredAttribute}) {
+				if (firstIndex > level->propertyCount())
+					continue;
+				auto schema = get(level, firstIndex, ignore);
+				if (schema.fingerprint != fingerprint)
+					continue;
+				if (!match)
+					match = std::move(schema);
+				else if (match->properties != schema.properties) {
+					throw DeserializationException{QByteArray{"Schema fingerprint "} +
+												   QByteArray::number(fingerprint) +
+												   " is ambiguous for " +
+												   metaObject->className() +
+												   ": it matches different property sets of " +
+												   match->metaObject->className() +
+												   " and " +
+												   level->className()};
+				}
+			}
+		}
+	}
+	return match;
+}
+
+quint32 PropertySchema::fingerprintOf(const QCborArray &positional)
+{
+	if (positional.isEmpty() || !positional.first().isInteger())
+		throw DeserializationException{"Positional data must start with the schema fingerprint as integer"};
+	return static_cast<quint32>(positional.first().toInteger());
+}
+
+QCborArray PropertySchema::createPositional() const
+{
+	QCborArray positional;
+	positional.append(static_cast<qint64>(fingerprint));
+	return positional;
+}
+
+QCborMap PropertySchema::toMap(const QCborArray &positional) const
+{
+	if (positional.size() != static_cast<qsizetype>(properties.size()) + 1) {
+		throw DeserializationException{QByteArray{"Positional data has "} +
+									   QByteArray::number(static_cast<qint64>(positional.size() - 1)) +
+									   " values, but the schema of " +
+									   metaObject->className() +
+									   " has " +
+									   QByteArray::number(static_cast<qint64>(properties.size())) +
+									   " properties"};
+	}
+
+	QCborMap cborMap;
+	for (auto i = 0; i < properties.size(); ++i)
+		cborMap.insert(QString::fromUtf8(metaObject->property(properties[i]).name()), positional[i + 1]);
+	return cborMap;
+}
+
+PropertySchema PropertySchema::create(const QMetaObject *metaObject, int firstIndex, bool ignoreStoredAttribute)
+{
+	PropertySchema schema;
+	schema.metaObject = metaObject;
+	schema.fingerprint = FnvOffsetBasis;
+	for (auto i = firstIndex; i < metaObject->propertyCount(); ++i) {
+		const auto property = metaObject->property(i);
+		if (!ignoreStoredAttribute && !property.isStored())
+			continue;
+		schema.properties.append(i);
+		schema.names.append(QString::fromUtf8(property.name()));
+		hashAppend(schema.fingerprint, property.name());
+		hashAppend(schema.fingerprint, ':');
+		hashAppend(schema.fingerprint, property.typeName());
+		hashAppend(schema.fingerprint, ';');
+	}
+	return schema;
+}
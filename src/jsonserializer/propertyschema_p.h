@@ -0,0 +1,48 @@
+#ifndef QTJSONSERIALIZER_PROPERTYSCHEMA_P_H
+#define QTJSONSERIALIZER_PROPERTYSCHEMA_P_H
+
+#include "qtjsonserializer_global.h"
+
+#include <optional>
+#include <initializer_list>
+
+#include <QtCore/QMetaObject>
+#include <QtCore/QVector>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QCborArray>
+#include <QtCore/QCborMap>
+
+namespace QtJsonSerializer {
+
+class Q_JSONSERIALIZER_EXPORT PropertySchema
+{
+public:
+	const QMetaObject *metaObject = nullptr;
+	quint32 fingerprint = 0;
+	QVector<int> properties;
+	QVector<QString> names;
+
+	static PropertySchema get(const QMetaObject *metaObject, int firstIndex, bool ignoreStoredAttribute);
+	static std::optional<PropertySchema> find(const QMetaObject *metaObject,
+											  quint32 fingerprint,
+											  std::initializer_list<int> firstIndices,
+											  bool ignoreStoredAttribute);
+	static quint32 fingerprintOf(const QCborArray &positional);
+
+	QCborArray createPositional() const;
+	QCborMap toMap(const QCborArray &positional) const;
+
+private:
+	using SchemaKey = QPair<const QMetaObject*, int>;
+
+	static QReadWriteLock lock;
+	static QHash<SchemaKey, PropertySchema> schemaCache;
+
+	static PropertySchema create(const QMetaObject *metaObject, int firstIndex, bool ignoreStoredAttribute);
+};
+
+}
+
+#endif // QTJSONSERIALIZER_PROPERTYSCHEMA_P_H
@@ -0,0 +1,147 @@
+#include "rawfragment.h"
+#include "jsonreader_p.h"
+#include "jsonwriter_p.h"
+using namespace QtJsonSerializer;
+
+RawFragment::RawFragment() = default;
+
+RawFragment::RawFragment(const QCborValue &value) :
+	_encoding{Encoding::CborValue},
+	_cborValue{value}
+{}
+
+RawFragment::RawFragment(const QJsonValue &value) :
+	_encoding{Encoding::JsonValue},
+	_jsonValue{value}
+{}
+
+RawFragment::RawFragment(const QByteArray &json, const QCborValue &value) :
+	_encoding{Encoding::JsonData},
+	_cborValue{value},
+	_data{json}
+{}
+
+RawFragment RawFragment::fromCbor(const QByteArray &data)
+{
+	RawFragment fragment;
+	fragment._encoding = Encoding::CborData;
+	fragment._data = data;
+	return fragment;
+}
+
+RawFragment RawFragment::fromJson(const QByteArray &data)
+{
+	RawFragment fragment;
+	fragment._encoding = Encoding::JsonData;
+	fragment._data = data;
+	return fragment;
+}
+
+RawFragment::Encoding RawFragment::encoding() const
+{
+	return _encoding;
+}
+
+bool RawFragment::isNull() const
+{
+	switch (_encoding) {
+	case Encoding::CborValue:
+		return _cborValue.isNull() || _cborValue.isUndefined();
+	case Encoding::JsonValue:
+		return _jsonValue.isNull() || _jsonValue.isUndefined();
+	case Encoding::CborData:
+	case Encoding::JsonData:
+		return _data.isEmpty();
+	default:
+		Q_UNREACHABLE();
+	}
+}
+
+QCborValue RawFragment::toCborValue() const
+{
+	switch (_encoding) {
+	case Encoding::CborValue:
+		return _cborValue;
+	case Encoding::JsonValue:
+		return QCborValue::fromJsonValue(_jsonValue);
+	case Encoding::CborData: {
+		QCborParserError error;
+		const auto value = QCborValue::fromCbor(_data, &error);
+		if (error.error != QCborError::NoError)
+			return QCborValue::Invalid;
+		return value;
+	}
+	case Encoding::JsonData: {
+		// text captured by the serializer keeps the value it was decoded to
+		if (!_cborValue.isUndefined())
+			return _cborValue;
+		QJsonParseError error;
+		const auto value = JsonReader::read(_data, error);
+		if (error.error != QJsonParseError::NoError)
+			return QCborValue::Invalid;
+		return value;
+	}
+	default:
+		Q_UNREACHABLE();
+	}
+}
+
+QJsonValue RawFragment::toJsonValue() const
+{
+	switch (_encoding) {
+	case Encoding::JsonValue:
+		return _jsonValue;
+	case Encoding::CborValue:
+		return _cborValue.toJsonValue();
+	case Encoding::CborData:
+	case Encoding::JsonData: {
+		const auto value = toCborValue();
+		if (value.isInvalid())
+			return QJsonValue::Undefined;
+		return value.toJsonValue();
+	}
+	default:
+		Q_UNREACHABLE();
+	}
+}
+
+QByteArray RawFragment::toCbor() const
+{
+	if (_encoding == Encoding::CborData)
+		return _data;
+	else
+		return toCborValue().toCbor();
+}
+
+QByteArray RawFragment::toJson(QJsonDocument::JsonFormat format) const
+{
+	if (_encoding == Encoding::JsonData)
+		return _data;
+	else
+		return JsonWriter::write(toCborValue(), format);
+}
+
+bool RawFragment::operator==(const RawFragment &other) const
+{
+	if (_encoding == other._encoding) {
+		switch (_encoding) {
+		case Encoding::CborValue:
+			return _cborValue == other._cborValue;
+		case Encoding::JsonValue:
+			return _jsonValue == other._jsonValue;
+		case Encoding::CborData:
+		case Encoding::JsonData:
+			if (_data == other._data)
+				return true;
+			break;
+		default:
+			Q_UNREACHABLE();
+		}
+	}
+	return toCborValue() == other.toCborValue();
+}
+
+bool RawFragment::operator!=(const RawFragment &other) const
+{
+	return !operator==(other);
+}
@@ -0,0 +1,77 @@
+#ifndef QTJSONSERIALIZER_RAWFRAGMENT_H
+#define QTJSONSERIALIZER_RAWFRAGMENT_H
+
+#include "QtJsonSerializer/qtjsonserializer_global.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qmetatype.h>
+
+namespace QtJsonSerializer {
+
+namespace TypeConverters {
+class RawFragmentConverter;
+}
+
+//! An opaque part of a serialized document, that is passed through without being converted
+class Q_JSONSERIALIZER_EXPORT RawFragment
+{
+public:
+	//! The representation the fragment currently holds its data in
+	enum class Encoding {
+		CborValue,  //!< A decoded CBOR value
+		JsonValue,  //!< A decoded JSON value
+		CborData,  //!< Encoded CBOR binary data
+		JsonData  //!< Encoded JSON text
+	};
+
+	//! Default constructor, creates a null fragment
+	RawFragment();
+	//! Creates a fragment from a decoded CBOR value
+	explicit RawFragment(const QCborValue &value);
+	//! Creates a fragment from a decoded JSON value
+	explicit RawFragment(const QJsonValue &value);
+
+	//! Creates a fragment from encoded CBOR data, without decoding it
+	static RawFragment fromCbor(const QByteArray &data);
+	//! Creates a fragment from encoded JSON text, without parsing it
+	static RawFragment fromJson(const QByteArray &data);
+
+	//! Returns the representation the fragment holds its data in
+	Encoding encoding() const;
+	//! Checks if the fragment is null or undefined
+	bool isNull() const;
+
+	//! Returns the fragment as CBOR value, decoding it if needed
+	QCborValue toCborValue() const;
+	//! Returns the fragment as JSON value, decoding it if needed
+	QJsonValue toJsonValue() const;
+	//! Returns the fragment as encoded CBOR data
+	QByteArray toCbor() const;
+	//! Returns the fragment as encoded JSON text
+	QByteArray toJson(QJsonDocument::JsonFormat format = QJsonDocument::Compact) const;
+
+	//! Equality operator
+	bool operator==(const RawFragment &other) const;
+	//! Inequality operator
+	bool operator!=(const RawFragment &other) const;
+
+private:
+	friend class TypeConverters::RawFragmentConverter;
+
+	Encoding _encoding = Encoding::CborValue;
+	QCborValue _cborValue;
+	QJsonValue _jsonValue;
+	QByteArray _data;
+
+	RawFragment(const QByteArray &json, const QCborValue &value);
+};
+
+}
+
+Q_DECLARE_METATYPE(QtJsonSerializer::RawFragment)
+
+//! @file rawfragment.h The RawFragment header file
+#endif // QTJSONSERIALIZER_RAWFRAGMENT_H
@@ -0,0 +1,176 @@
+#include "rawvalue_p.h"
+using namespace QtJsonSerializer;
+
+QVariant RawValue::box(int type, const void *value)
+{
+	// same as QVariant::fromValue, which does not nest variants
+	if (type == QMetaType::QVariant)
+		return *static_cast<const QVariant*>(value);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return QVariant{type, value};
+#else
+	return QVariant{QMetaType(type), value};
+#endif
+}
+
+QVariant RawValue::ofType(int type, const QVariant &value)
+{
+	if (value.userType() == type)
+		return value;
+
+	// like QVariant::value, values that cannot be converted become default constructed ones
+	auto converted = value;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	if (!converted.convert(type))
+		return QVariant{type, nullptr};
+#else
+	if (!converted.convert(QMetaType(type)))
+		return QVariant{QMetaType(type), nullptr};
+#endif
+	return converted;
+}
+
+QVariant RawValue::construct(int type)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return QVariant{type, nullptr};
+#else
+	return QVariant{QMetaType(type), nullptr};
+#endif
+}
+
+bool RawValue::assign(int type, void *target, QVariant value)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	if (value.userType() != type && !value.convert(type))
+		return false;
+	QMetaType::destruct(type, target);
+	QMetaType::construct(type, target, value.constData());
+#else
+	const QMetaType metaType{type};
+	if (value.userType() != type && !value.convert(metaType))
+		return false;
+	metaType.destruct(target);
+	metaType.construct(target, value.constData());
+#endif
+	return true;
+}
+
+QCborValue RawValue::serializeElement(const TypeConverter::SerializationHelper *helper, const TypeExtractor &extractor, int type, const void *value, int index, int elementType, const QByteArray &traceHint)
+{
+	if (const auto element = extractor.elementAt(value, index); element)
+		return helper->serializeSubtypeRaw(elementType, element, traceHint);
+	else
+		return helper->serializeSubtype(elementType, extractor.extract(box(type, value), index), traceHint);
+}
+
+RawProperty::RawProperty(const QMetaProperty &property, const QObject *object)
+{
+	if (!construct(property))
+		return;
+
+	// same as QMetaProperty::read, but without the QVariant around the storage
+	int status = -1;
+	void *argv[] = {_storage, nullptr, &status};
+	QMetaObject::metacall(const_cast<QObject*>(object), QMetaObject::ReadProperty, property.propertyIndex(), argv);
+	_data = argv[0];
+}
+
+RawProperty::RawProperty(const QMetaProperty &property, const void *gadget)
+{
+	const auto metaObject = property.enclosingMetaObject();
+	if (!metaObject || !metaObject->d.static_metacall || !construct(property))
+		return;
+
+	// same as QMetaProperty::readOnGadget, but without the QVariant around the storage
+	int status = -1;
+	void *argv[] = {_storage, nullptr, &status};
+	metaObject->d.static_metacall(reinterpret_cast<QObject*>(const_cast<void*>(gadget)),
+								  QMetaObject::ReadProperty,
+								  property.propertyIndex() - metaObject->propertyOffset(),
+								  argv);
+	_data = argv[0];
+}
+
+RawProperty::RawProperty(const QMetaProperty &property)
+{
+	if (property.isWritable() && construct(property))
+		_data = _storage;
+}
+
+RawProperty::~RawProperty()
+{
+	if (_type == QMetaType::UnknownType)
+		return;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QMetaType::destruct(_type, _storage);
+#else
+	QMetaType(_type).destruct(_storage);
+#endif
+}
+
+const void *RawProperty::data() const
+{
+	return _data;
+}
+
+void *RawProperty::data()
+{
+	return const_cast<void*>(_data);
+}
+
+bool RawProperty::write(const QMetaProperty &property, QObject *object)
+{
+	if (!_data)
+		return false;
+
+	// same as QMetaProperty::write, but without the QVariant around the storage
+	int status = -1;
+	int flags = 0;
+	void *argv[] = {_storage, nullptr, &status, &flags};
+	QMetaObject::metacall(object, QMetaObject::WriteProperty, property.propertyIndex(), argv);
+	return true;
+}
+
+bool RawProperty::writeOnGadget(const QMetaProperty &property, void *gadget)
+{
+	if (!_data)
+		return false;
+
+	// same as QMetaProperty::writeOnGadget, but without the QVariant around the storage
+	const auto metaObject = property.enclosingMetaObject();
+	if (!metaObject || !metaObject->d.static_metacall)
+		return property.writeOnGadget(gadget, RawValue::box(_type, _storage));
+	int status = -1;
+	int flags = 0;
+	void *argv[] = {_storage, nullptr, &status, &flags};
+	metaObject->d.static_metacall(reinterpret_cast<QObject*>(gadget),
+								  QMetaObject::WriteProperty,
+								  property.propertyIndex() - metaObject->propertyOffset(),
+								  argv);
+	return true;
+}
+
+bool RawProperty::construct(const QMetaProperty &property)
+{
+	// QVariants are boxed anyways, and enums are serialized as their enum type, not the property type
+	const auto type = property.userType();
+	if (type == QMetaType::UnknownType ||
+		type == QMetaType::QVariant ||
+		property.isEnumType())
+		return false;
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	if (static_cast<std::size_t>(QMetaType::sizeOf(type)) > StorageSize ||
+		!QMetaType::construct(type, _storage, nullptr))
+		return false;
+#else
+	const QMetaType metaType{type};
+	if (static_cast<std::size_t>(metaType.sizeOf()) > StorageSize ||
+		static_cast<std::size_t>(metaType.alignOf()) > alignof(std::max_align_t) ||
+		!metaType.construct(_storage))
+		return false;
+#endif
+	_type = type;
+	return true;
+}
@@ -0,0 +1,95 @@
+#ifndef QTJSONSERIALIZER_RAWVALUE_P_H
+#define QTJSONSERIALIZER_RAWVALUE_P_H
+
+#include "qtjsonserializer_global.h"
+#include "typeconverter.h"
+
+#include <cstddef>
+#include <type_traits>
+
+#include <QtCore/QMetaProperty>
+#include <QtCore/QVariant>
+
+namespace QtJsonSerializer {
+
+// Helpers to pass values around as pointers to instances of their metatype, instead of QVariants
+class Q_JSONSERIALIZER_EXPORT RawValue
+{
+public:
+	// wraps the value into a QVariant, for everything that has no raw implementation
+	static QVariant box(int type, const void *value);
+	// returns the value as exactly the given type, so its constData() can be passed as raw value
+	static QVariant ofType(int type, const QVariant &value);
+	// creates a default constructed value of the given type, whose data() can be deserialized into
+	static QVariant construct(int type);
+	// replaces the value at target with the value converted to the given type, or returns false if it cannot be converted
+	static bool assign(int type, void *target, QVariant value);
+	// serializes an element of the value, in place if the extractor supports it
+	static QCborValue serializeElement(const TypeConverter::SerializationHelper *helper,
+									   const TypeExtractor &extractor,
+									   int type,
+									   const void *value,
+									   int index,
+									   int elementType,
+									   const QByteArray &traceHint);
+};
+
+// Reads the value of a property into stack storage via the static metacall, or writes it from there.
+// Only small types can be accessed that way, data() is nullptr for all others, which have to be
+// read and written via QMetaProperty.
+class Q_JSONSERIALIZER_EXPORT RawProperty
+{
+	Q_DISABLE_COPY(RawProperty)
+public:
+	RawProperty(const QMetaProperty &property, const QObject *object);
+	RawProperty(const QMetaProperty &property, const void *gadget);
+	// only constructs the storage, so a value can be deserialized into it and then written
+	explicit RawProperty(const QMetaProperty &property);
+	~RawProperty();
+
+	const void *data() const;
+	void *data();
+
+	// write the value in the storage to the property of the object or gadget
+	bool write(const QMetaProperty &property, QObject *object);
+	bool writeOnGadget(const QMetaProperty &property, void *gadget);
+
+	// serializes the property of the object or gadget, with the raw helper API if possible
+	template <typename TValue, typename TInstance>
+	static TValue serialize(const TypeConverter::SerializationHelper *helper, const QMetaProperty &property, TInstance instance);
+
+private:
+	static constexpr std::size_t StorageSize = 4 * sizeof(void*);
+
+	alignas(std::max_align_t) char _storage[StorageSize];
+	int _type = QMetaType::UnknownType;
+	const void *_data = nullptr;
+
+	bool construct(const QMetaProperty &property);
+};
+
+template<typename TValue, typename TInstance>
+TValue RawProperty::serialize(const TypeConverter::SerializationHelper *helper, const QMetaProperty &property, TInstance instance)
+{
+	constexpr auto isObject = std::is_convertible_v<TInstance, const QObject*>;
+	if (const RawProperty raw{property, instance}; raw.data()) {
+		if constexpr (std::is_same_v<TValue, QJsonValue>)
+			return helper->serializeJsonSubtypeRaw(property, raw.data());
+		else
+			return helper->serializeSubtypeRaw(property, raw.data());
+	}
+
+	QVariant value;
+	if constexpr (isObject)
+		value = property.read(instance);
+	else
+		value = property.readOnGadget(instance);
+	if constexpr (std::is_same_v<TValue, QJsonValue>)
+		return helper->serializeJsonSubtype(property, value);
+	else
+		return helper->serializeSubtype(property, value);
+}
+
+}
+
+#endif // QTJSONSERIALIZER_RAWVALUE_P_H
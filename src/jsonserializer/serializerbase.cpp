@@ -1,6 +1,8 @@
 #include "serializerbase.h"
 #include "serializerbase_p.h"
 #include "exceptioncontext_p.h"
+#include "patch_p.h"
+#include "rawvalue_p.h"
 
 #include <optional>
 #include <variant>
@@ -24,6 +26,7 @@
 #include "typeconverters/multimapconverter_p.h"
 #include "typeconverters/objectconverter_p.h"
 #include "typeconverters/pairconverter_p.h"
+#include "typeconverters/rawfragmentconverter_p.h"
 #include "typeconverters/smartpointerconverter_p.h"
 #include "typeconverters/stdchronodurationconverter_p.h"
 #include "typeconverters/stdoptionalconverter_p.h"
@@ -74,6 +77,7 @@ SerializerBase::SerializerBase(SerializerBasePrivate &dd, QObject *parent) :
 void SerializerBase::registerExtractor(int metaTypeId, const QSharedPointer<TypeExtractor> &extractor)
 {
 	SerializerBasePrivate::extractors.add(metaTypeId, extractor);
+	SerializerBasePrivate::registryRevision.ref();
 	qCDebug(logSerializerExtractor) << "Added extractor for type:" << QMetaTypeName(metaTypeId);
 }
 
@@ -107,6 +111,12 @@ bool SerializerBase::dateAsTimeStamp() const
 	return d->dateAsTimeStamp;
 }
 
+bool SerializerBase::dateAsMsecsSinceEpoch() const
+{
+	Q_D(const SerializerBase);
+	return d->dateAsMsecsSinceEpoch;
+}
+
 bool SerializerBase::useBcp47Locale() const
 {
 	Q_D(const SerializerBase);
@@ -137,10 +147,35 @@ bool SerializerBase::ignoresStoredAttribute() const
 	return d->ignoreStoredAttribute;
 }
 
+bool SerializerBase::positionalEncoding() const
+{
+	Q_D(const SerializerBase);
+	return d->positionalEncoding;
+}
+
+bool SerializerBase::variantDiscriminator() const
+{
+	Q_D(const SerializerBase);
+	return d->variantDiscriminator;
+}
+
+ChangeTracker *SerializerBase::changeTracker() const
+{
+	Q_D(const SerializerBase);
+	return d->changeTracker;
+}
+
+bool SerializerBase::deferNotifications() const
+{
+	Q_D(const SerializerBase);
+	return d->deferNotifications;
+}
+
 void SerializerBase::addJsonTypeConverterFactory(TypeConverterFactory *factory)
 {
 	QWriteLocker _{&SerializerBasePrivate::typeConverterFactoryLock};
 	SerializerBasePrivate::typeConverterFactories.append(factory);
+	SerializerBasePrivate::registryRevision.ref();
 	qCDebug(logSerializer) << "Added new global converter factory:" << factory;
 }
 
@@ -152,9 +187,22 @@ void SerializerBase::addJsonTypeConverter(const QSharedPointer<TypeConverter> &c
 	d->typeConverters.insertSorted(converter);
 	d->serCache.clear();
 	d->deserCache.clear();
+	SerializerBasePrivate::registryRevision.ref();
 	qCDebug(logSerializer) << "Added new local converter:" << converter->name();
 }
 
+void SerializerBase::setInstanceFactory(const QMetaObject *metaObject, const QSharedPointer<InstanceFactory> &factory)
+{
+	Q_D(SerializerBase);
+	Q_ASSERT_X(metaObject, Q_FUNC_INFO, "metaObject must not be null!");
+	QWriteLocker _{&d->instanceFactoryLock};
+	if (factory)
+		d->instanceFactories.insert(metaObject, factory);
+	else
+		d->instanceFactories.remove(metaObject);
+	qCDebug(logSerializer) << (factory ? "Set" : "Removed") << "instance factory for class" << metaObject->className();
+}
+
 void SerializerBase::setAllowDefaultNull(bool allowDefaultNull)
 {
 	Q_D(SerializerBase);
@@ -205,6 +253,16 @@ void SerializerBase::setDateAsTimeStamp(bool dateAsTimeStamp)
 	emit dateAsTimeStampChanged(d->dateAsTimeStamp, {});
 }
 
+void SerializerBase::setDateAsMsecsSinceEpoch(bool dateAsMsecsSinceEpoch)
+{
+	Q_D(SerializerBase);
+	if(d->dateAsMsecsSinceEpoch == dateAsMsecsSinceEpoch)
+		return;
+
+	d->dateAsMsecsSinceEpoch = dateAsMsecsSinceEpoch;
+	emit dateAsMsecsSinceEpochChanged(d->dateAsMsecsSinceEpoch, {});
+}
+
 void SerializerBase::setUseBcp47Locale(bool useBcp47Locale)
 {
 	Q_D(SerializerBase);
@@ -222,6 +280,7 @@ void SerializerBase::setValidationFlags(ValidationFlags validationFlags)
 		return;
 
 	d->validationFlags = validationFlags;
+	d->deserCache.clear();  // strict validation changes which converters accept data
 	emit validationFlagsChanged(d->validationFlags, {});
 }
 
@@ -255,6 +314,46 @@ void SerializerBase::setIgnoreStoredAttribute(bool ignoreStoredAttribute)
 	emit ignoreStoredAttributeChanged(d->ignoreStoredAttribute, {});
 }
 
+void SerializerBase::setPositionalEncoding(bool positionalEncoding)
+{
+	Q_D(SerializerBase);
+	if(d->positionalEncoding == positionalEncoding)
+		return;
+
+	d->positionalEncoding = positionalEncoding;
+	emit positionalEncodingChanged(d->positionalEncoding, {});
+}
+
+void SerializerBase::setVariantDiscriminator(bool variantDiscriminator)
+{
+	Q_D(SerializerBase);
+	if(d->variantDiscriminator == variantDiscriminator)
+		return;
+
+	d->variantDiscriminator = variantDiscriminator;
+	emit variantDiscriminatorChanged(d->variantDiscriminator, {});
+}
+
+void SerializerBase::setChangeTracker(ChangeTracker *changeTracker)
+{
+	Q_D(SerializerBase);
+	if(d->changeTracker == changeTracker)
+		return;
+
+	d->changeTracker = changeTracker;
+	emit changeTrackerChanged(d->changeTracker, {});
+}
+
+void SerializerBase::setDeferNotifications(bool deferNotifications)
+{
+	Q_D(SerializerBase);
+	if(d->deferNotifications == deferNotifications)
+		return;
+
+	d->deferNotifications = deferNotifications;
+	emit deferNotificationsChanged(d->deferNotifications, {});
+}
+
 QVariant SerializerBase::getProperty(const char *name) const
 {
 	return property(name);
@@ -262,7 +361,18 @@ QVariant SerializerBase::getProperty(const char *name) const
 
 QSharedPointer<const TypeExtractor> SerializerBase::extractor(int metaTypeId) const
 {
-	const auto extractor = SerializerBasePrivate::extractors.get(metaTypeId);
+	// converters look extractors up for every value -> only lock the global store once per type and thread
+	thread_local QHash<int, QSharedPointer<const TypeExtractor>> cache;
+	thread_local int cacheRevision = -1;
+	if (const auto revision = SerializerBasePrivate::registryRevision.loadAcquire(); revision != cacheRevision) {
+		cache.clear();
+		cacheRevision = revision;
+	}
+
+	auto it = cache.find(metaTypeId);
+	if (it == cache.end())
+		it = cache.insert(metaTypeId, SerializerBasePrivate::extractors.get(metaTypeId));
+	const auto extractor = *it;
 	if (extractor)
 		qCDebug(logSerializerExtractor) << "Found extractor for type:" << QMetaTypeName(metaTypeId);
 	else
@@ -270,6 +380,13 @@ QSharedPointer<const TypeExtractor> SerializerBase::extractor(int metaTypeId) co
 	return extractor;
 }
 
+QSharedPointer<InstanceFactory> SerializerBase::instanceFactory(const QMetaObject *metaObject) const
+{
+	Q_D(const SerializerBase);
+	QReadLocker _{&d->instanceFactoryLock};
+	return d->instanceFactories.value(metaObject);
+}
+
 QCborValue SerializerBase::serializeSubtype(const QMetaProperty &property, const QVariant &value) const
 {
 	Q_D(const SerializerBase);
@@ -305,9 +422,59 @@ QCborValue SerializerBase::serializeSubtype(int propertyType, const QVariant &va
 	return serializeVariant(propertyType, value);
 }
 
+QCborValue SerializerBase::serializeSubtypeRaw(const QMetaProperty &property, const void *value) const
+{
+	// enums are serialized as their enum type, which only works with a QVariant
+	if (property.isEnumType())
+		return serializeSubtype(property, RawValue::box(property.userType(), value));
+
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing raw subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	return serializeRaw(property.userType(), value);
+}
+
+QCborValue SerializerBase::serializeSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const
+{
+	ExceptionContext ctx(propertyType, traceHint);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing raw subtype property" << traceHint
+						   << "of type" << QMetaTypeName(propertyType);
+	return serializeRaw(propertyType, value);
+}
+
+SerializerBase::SubtypeSerializer SerializerBase::subtypeSerializer(int propertyType) const
+{
+	Q_D(const SerializerBase);
+	// same as serializeRaw, but the converter and override tag are only looked up once
+	const auto converter = d->findSerConverter(propertyType);
+	const auto mTag = typeTag(propertyType);
+	return [d, converter, propertyType, mTag](const void *value) -> QCborValue {
+		const auto res = converter ?
+			converter->serializeRaw(propertyType, value) :
+			d->serializeRawValue(propertyType, value);
+		if (mTag != TypeConverter::NoTag)
+			return {mTag, res.isTag() ? res.taggedValue() : res};
+		else
+			return res;
+	};
+}
+
 QVariant SerializerBase::deserializeSubtype(const QMetaProperty &property, const QCborValue &value, QObject *parent) const
 {
 	Q_D(const SerializerBase);
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return {};
 	ExceptionContext ctx(property);
 	auto logGuard = qScopeGuard([](){
 		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
@@ -329,6 +496,9 @@ QVariant SerializerBase::deserializeSubtype(const QMetaProperty &property, const
 
 QVariant SerializerBase::deserializeSubtype(int propertyType, const QCborValue &value, QObject *parent, const QByteArray &traceHint) const
 {
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return {};
 	ExceptionContext ctx(propertyType, traceHint);
 	auto logGuard = qScopeGuard([](){
 		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
@@ -340,6 +510,147 @@ QVariant SerializerBase::deserializeSubtype(int propertyType, const QCborValue &
 	return deserializeVariant(propertyType, value, parent);
 }
 
+bool SerializerBase::deserializeSubtypeRaw(const QMetaProperty &property, const QCborValue &value, void *target, QObject *parent) const
+{
+	Q_D(const SerializerBase);
+	// enums are deserialized as their enum type, and null values may need the null handling of the
+	// type enforcement -> both use the QVariant path
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	if (ErrorSink::currentFailed() ||
+		property.isEnumType() ||
+		cValue.isNull() ||
+		cValue.isUndefined())
+		return false;
+
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Deserializing raw subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	const auto propertyType = property.userType();
+	const auto converter = d->findDeserConverter(propertyType,
+												 value.isTag() ? value.tag() : TypeConverter::NoTag,
+												 cValue.type());
+	if (ErrorSink::currentFailed())
+		return false;
+
+	if (converter)
+		converter->deserializeRaw(propertyType, value, target, parent);
+	else {
+		auto variant = jsonMode() ?
+						   d->deserializeJsonValue(propertyType, value) :
+						   d->deserializeCborValue(propertyType, value);
+		if (!ErrorSink::currentFailed())
+			variant = d->enforceType(propertyType, std::move(variant), false);
+		if (!ErrorSink::currentFailed())
+			RawValue::assign(propertyType, target, std::move(variant));
+	}
+	return !ErrorSink::currentFailed();
+}
+
+void SerializerBase::deserializeSubtypeInto(const QMetaProperty &property, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	// enums are converted from their underlying type -> nothing to be reused
+	if (property.isEnumType()) {
+		target = deserializeSubtype(property, value, parent);
+		return;
+	}
+
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return;
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Updating subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	deserializeVariantInto(property.userType(), target, value, parent);
+}
+
+void SerializerBase::deserializeSubtypeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent, const QByteArray &traceHint) const
+{
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return;
+	ExceptionContext ctx(propertyType, traceHint);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Updating subtype property" << traceHint
+						   << "of type" << QMetaTypeName(propertyType);
+	deserializeVariantInto(propertyType, target, value, parent);
+}
+
+bool SerializerBase::canDeserializeSubtype(int propertyType, const QCborValue &value) const
+{
+	Q_D(const SerializerBase);
+	const auto tag = value.isTag() ? value.tag() : TypeConverter::NoTag;
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+
+	// first: a converter for the type must accept the data, if one is found
+	{
+		ErrorSink probeSink;
+		auto testType = propertyType;
+		if (d->findDeserConverter(testType, tag, cValue.type()))
+			return true;  // converters can only be verified by running them
+		else if (probeSink.hasFailed())
+			return false;  // only reported for a wrong tag
+	}
+
+	// second: predict the default conversion for plain, untyped values
+	if (propertyType == QMetaType::UnknownType || tag != TypeConverter::NoTag)
+		return true;
+	if (d->allowNull && value.isNull())
+		return true;
+	switch (propertyType) {
+	case QMetaType::QString:
+	case QMetaType::QByteArray:
+		if (value.isNull())
+			return false;
+		break;
+	case QMetaType::QRegularExpression:
+		return true;
+	default:
+		break;
+	}
+
+	// containers are only checked by type, as converting them is as expensive as deserializing
+	QVariant variant;
+	if (value.isArray())
+		variant = QVariantList{};
+	else if (value.isMap())
+		variant = QVariantMap{};
+	else
+		variant = value.toVariant();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return variant.canConvert(propertyType) &&
+		   (value.isArray() || value.isMap() || variant.convert(propertyType));
+#else
+	return variant.canConvert(QMetaType(propertyType)) &&
+		   (value.isArray() || value.isMap() || variant.convert(QMetaType(propertyType)));
+#endif
+}
+
+bool SerializerBase::isPlainSubtype(int propertyType, QCborValue::Type valueType) const
+{
+	Q_D(const SerializerBase);
+	// a type tag must be validated, and converters can only be found for tag and data together
+	if (typeTag(propertyType) != TypeConverter::NoTag)
+		return false;
+	ErrorSink probeSink;
+	auto testType = propertyType;
+	return !d->findDeserConverter(testType, TypeConverter::NoTag, valueType) &&
+		   !probeSink.hasFailed();
+}
+
 QCborValue SerializerBase::serializeVariant(int propertyType, const QVariant &value) const
 {
 	Q_D(const SerializerBase);
@@ -358,6 +669,22 @@ QCborValue SerializerBase::serializeVariant(int propertyType, const QVariant &va
 		return res;
 }
 
+QCborValue SerializerBase::serializeRaw(int propertyType, const void *value) const
+{
+	Q_D(const SerializerBase);
+	auto converter = d->findSerConverter(propertyType);
+	QCborValue res;
+	if (converter)
+		res = converter->serializeRaw(propertyType, value);
+	else
+		res = d->serializeRawValue(propertyType, value);
+
+	if (const auto mTag = typeTag(propertyType); mTag != TypeConverter::NoTag)
+		return {mTag, res.isTag() ? res.taggedValue() : res};
+	else
+		return res;
+}
+
 QVariant SerializerBase::deserializeVariant(int propertyType, const QCborValue &value, QObject *parent, bool skipConversion) const
 {
 	Q_D(const SerializerBase);
@@ -365,6 +692,8 @@ QVariant SerializerBase::deserializeVariant(int propertyType, const QCborValue &
 	auto converter = d->findDeserConverter(propertyType,
 										   value.isTag() ? value.tag() : TypeConverter::NoTag,
 										   value.isTag() ? value.taggedValue().type() : value.type());
+	if (ErrorSink::currentFailed())
+		return {};
 
 	QVariant variant;
 	if (converter) {
@@ -378,49 +707,241 @@ QVariant SerializerBase::deserializeVariant(int propertyType, const QCborValue &
 		else
 			variant = d->deserializeCborValue(propertyType, value);
 	}
+	if (ErrorSink::currentFailed())
+		return {};
 
 	// second: if the type was given, enforce a conversion to that type (expect if skipped)
-	if(!skipConversion && propertyType != QMetaType::UnknownType) {
-		auto vType = variant.typeName();
+	if(!skipConversion && propertyType != QMetaType::UnknownType)
+		return d->enforceType(propertyType, std::move(variant), value.isNull());
+	else
+		return variant;
+}
 
-		// exclude special values that can convert from null, but should not do so
-		auto allowConvert = true;
-		switch (propertyType) {
-		case QMetaType::QString:
-		case QMetaType::QByteArray:
-			if (value.isNull())
-				allowConvert = false;
-			break;
-		default:
-			break;
-		}
+DeserializationResult SerializerBase::tryDeserializeVariant(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	ErrorSink sink;
+	try {
+		auto variant = deserializeVariant(propertyType, value, parent);
+		return sink.result(std::move(variant));
+	} catch (DeserializationException &exception) {
+		// not every converter reports its errors via the sink
+		return exception;
+	}
+}
 
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		if(allowConvert && variant.canConvert(propertyType) && variant.convert(propertyType))
-#else
-		if(allowConvert && variant.canConvert(QMetaType(propertyType)) && variant.convert(QMetaType(propertyType)))
-#endif
-			return variant;
-		else if(d->allowNull && value.isNull())
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-			return QVariant{propertyType, nullptr};
-#else
-			return QVariant{QMetaType(propertyType), nullptr};
-#endif
-		else {
-			throw DeserializationException(QByteArray("Failed to convert deserialized variant of type ") +
-										   (vType ? vType : "<unknown>") +
-										   QByteArray(" to property type ") +
-										   QMetaTypeName(propertyType) +
-										   QByteArray(". Make shure to register converters with the QJsonSerializer::register* methods"));
+void SerializerBase::deserializeVariantInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	Q_D(const SerializerBase);
+	// only existing values of the exact type can be updated, everything else is replaced
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	if (propertyType == QMetaType::UnknownType ||
+		target.userType() != propertyType ||
+		cValue.isNull() ||
+		cValue.isUndefined()) {
+		MergePatchContext _{false};
+		target = deserializeVariant(propertyType, value, parent);
+		return;
+	}
+
+	auto converter = d->findDeserConverter(propertyType,
+										   value.isTag() ? value.tag() : TypeConverter::NoTag,
+										   cValue.type());
+	if (ErrorSink::currentFailed())
+		return;
+
+	// values without a converter have no inner state to be reused
+	if (!converter) {
+		MergePatchContext _{false};
+		target = deserializeVariant(propertyType, value, parent);
+		return;
+	}
+
+	converter->deserializeInto(propertyType, target, value, parent);
+	if (!ErrorSink::currentFailed() && target.userType() != propertyType)
+		target = d->enforceType(propertyType, std::move(target), false);
+}
+
+QJsonValue SerializerBase::serializeJsonSubtype(const QMetaProperty &property, const QVariant &value) const
+{
+	// enums are never containers -> nothing to gain from the direct path
+	if (property.isEnumType())
+		return serializeSubtype(property, value).toJsonValue();
+
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	return serializeJsonVariant(property.userType(), value);
+}
+
+QJsonValue SerializerBase::serializeJsonSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const
+{
+	ExceptionContext ctx(propertyType, traceHint);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing subtype property" << traceHint
+						   << "of type" << QMetaTypeName(propertyType);
+	return serializeJsonVariant(propertyType, value);
+}
+
+QJsonValue SerializerBase::serializeJsonSubtypeRaw(const QMetaProperty &property, const void *value) const
+{
+	if (property.isEnumType())
+		return serializeSubtypeRaw(property, value).toJsonValue();
+
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing raw subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	return serializeJsonRaw(property.userType(), value);
+}
+
+QJsonValue SerializerBase::serializeJsonSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const
+{
+	ExceptionContext ctx(propertyType, traceHint);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Serializing raw subtype property" << traceHint
+						   << "of type" << QMetaTypeName(propertyType);
+	return serializeJsonRaw(propertyType, value);
+}
+
+SerializerBase::JsonSubtypeSerializer SerializerBase::jsonSubtypeSerializer(int propertyType) const
+{
+	Q_D(const SerializerBase);
+	// same as serializeJsonRaw, but the converter and override tag are only looked up once
+	if (typeTag(propertyType) == TypeConverter::NoTag) {
+		if (auto converter = d->findSerConverter(propertyType); converter) {
+			return [converter, propertyType](const void *value) {
+				return converter->serializeJsonRaw(propertyType, value);
+			};
 		}
-	} else
+	}
+	return [serializer = subtypeSerializer(propertyType)](const void *value) {
+		return serializer(value).toJsonValue();
+	};
+}
+
+QVariant SerializerBase::deserializeJsonSubtype(const QMetaProperty &property, const QJsonValue &value, QObject *parent) const
+{
+	// plain values are cheap to convert, only containers are read directly
+	if (property.isEnumType() || (!value.isArray() && !value.isObject()))
+		return deserializeSubtype(property, QCborValue::fromJsonValue(value), parent);
+
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return {};
+	ExceptionContext ctx(property);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Deserializing subtype property" << property.name()
+						   << "of type" << QMetaTypeName(property.userType());
+	return deserializeJsonVariant(property.userType(), value, parent);
+}
+
+QVariant SerializerBase::deserializeJsonSubtype(int propertyType, const QJsonValue &value, QObject *parent, const QByteArray &traceHint) const
+{
+	if (!value.isArray() && !value.isObject())
+		return deserializeSubtype(propertyType, QCborValue::fromJsonValue(value), parent, traceHint);
+
+	// an error was already reported -> skip the rest of the data
+	if (ErrorSink::currentFailed())
+		return {};
+	ExceptionContext ctx(propertyType, traceHint);
+	auto logGuard = qScopeGuard([](){
+		qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+							   << "done";
+	});
+	qCDebug(logSerializer) << QByteArray{">"}.repeated(ExceptionContext::currentDepth()).constData()
+						   << "Deserializing subtype property" << traceHint
+						   << "of type" << QMetaTypeName(propertyType);
+	return deserializeJsonVariant(propertyType, value, parent);
+}
+
+QJsonValue SerializerBase::serializeJsonVariant(int propertyType, const QVariant &value) const
+{
+	Q_D(const SerializerBase);
+	// override tags only exist to control the JSON representation -> let the CBOR path apply them
+	if (typeTag(propertyType) == TypeConverter::NoTag) {
+		if (auto converter = d->findSerConverter(propertyType); converter)
+			return converter->serializeJsonValue(propertyType, value);
+	}
+	return serializeVariant(propertyType, value).toJsonValue();
+}
+
+QJsonValue SerializerBase::serializeJsonRaw(int propertyType, const void *value) const
+{
+	Q_D(const SerializerBase);
+	if (typeTag(propertyType) == TypeConverter::NoTag) {
+		if (auto converter = d->findSerConverter(propertyType); converter)
+			return converter->serializeJsonRaw(propertyType, value);
+	}
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
+QVariant SerializerBase::deserializeJsonVariant(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	Q_D(const SerializerBase);
+	if (!jsonMode() || (!value.isArray() && !value.isObject()))
+		return deserializeVariant(propertyType, QCborValue::fromJsonValue(value), parent);
+
+	// first: find a converter and convert the data to QVariant
+	auto converter = d->findDeserConverter(propertyType,
+										   TypeConverter::NoTag,
+										   value.isArray() ? QCborValue::Array : QCborValue::Map);
+	if (ErrorSink::currentFailed())
+		return {};
+
+	QVariant variant;
+	if (converter)
+		variant = converter->deserializeJsonValue(propertyType, value, parent);
+	else
+		variant = d->deserializeJsonValue(propertyType, QCborValue::fromJsonValue(value));
+	if (ErrorSink::currentFailed())
+		return {};
+
+	// second: if the type was given, enforce a conversion to that type
+	if (propertyType != QMetaType::UnknownType)
+		return d->enforceType(propertyType, std::move(variant), false);
+	else
 		return variant;
 }
 
+DeserializationResult SerializerBase::tryDeserializeJsonVariant(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	ErrorSink sink;
+	try {
+		auto variant = deserializeJsonVariant(propertyType, value, parent);
+		return sink.result(std::move(variant));
+	} catch (DeserializationException &exception) {
+		// not every converter reports its errors via the sink
+		return exception;
+	}
+}
+
 // ------------- private implementation -------------
 
 SerializerBasePrivate::ThreadSafeStore<TypeExtractor> SerializerBasePrivate::extractors;
+QAtomicInt SerializerBasePrivate::registryRevision = 0;
+QReadWriteLock SerializerBasePrivate::enumIdLock;
+QHash<QPair<const QMetaObject*, const char*>, int> SerializerBasePrivate::enumIds;
 QReadWriteLock SerializerBasePrivate::typeConverterFactoryLock;
 QList<TypeConverterFactory*> SerializerBasePrivate::typeConverterFactories {
 	new TypeConverterStandardFactory<BitArrayConverter>{},
@@ -436,6 +957,7 @@ QList<TypeConverterFactory*> SerializerBasePrivate::typeConverterFactories {
 	new TypeConverterStandardFactory<MultiMapConverter>{},
 	new TypeConverterStandardFactory<ObjectConverter>{},
 	new TypeConverterStandardFactory<PairConverter>{},
+	new TypeConverterStandardFactory<RawFragmentConverter>{},
 	new TypeConverterStandardFactory<SmartPointerConverter>{},
 	new TypeConverterStandardFactory<StdChronoDurationConverter>{},
 	new TypeConverterStandardFactory<StdOptionalConverter>{},
@@ -482,32 +1004,58 @@ QSharedPointer<TypeConverter> SerializerBasePrivate::findDeserConverter(int &pro
 	// first: update converters from factories
 	updateConverterStore();
 
-	// second: if no property type is given, try out any types associated with the tag
+	// second: check if already cached - includes negative results
+	const DeserializationKey key {
+		{propertyType, static_cast<int>(type)},
+		{static_cast<quint64>(tag), q->jsonMode()}
+	};
+	auto entry = deserCache.get(key);
+	if (entry) {
+		qCDebug(logSerializer) << "Found cached deserialization converter" << (entry->converter ? entry->converter->name() : QByteArray{"<none>"})
+							   << "for type" <<  QMetaTypeName(propertyType)
+							   << LogTag{tag}
+							   << "and CBOR-type" << type;
+	} else {
+		// third: find the converter and cache the decision, no matter what it is
+		const auto revision = registryRevision.loadAcquire();
+		entry = resolveDeserConverter(propertyType, tag, type);
+		deserCache.add(key, *entry, revision);
+	}
+
+	// fourth: if a wrong tag mark was set, report an error
+	if (entry->wrongTag) {
+		ErrorSink::fail([propertyType, tag]() {
+			return QByteArray{"Found converter able to handle data of type "} +
+				   QMetaTypeName(propertyType) +
+				   ", but the given CBOR tag " +
+				   QByteArray::number(static_cast<quint64>(tag)) +
+				   " is not convertible to that type.";
+		});
+		return nullptr;
+	}
+
+	if (entry->converter)
+		propertyType = entry->metaTypeId;
+	return entry->converter;
+}
+
+SerializerBasePrivate::DeserializationEntry SerializerBasePrivate::resolveDeserConverter(int propertyType, QCborTag tag, QCborValue::Type type) const
+{
+	Q_Q(const SerializerBase);
+	// first: if no property type is given, try out any types associated with the tag
 	if (propertyType == QMetaType::UnknownType && tag != TypeConverter::NoTag) {
 		const auto tList = q->typesForTag(tag);
 		for (auto typeId : tList) {
 			// if any of those types has a working converter, just use that one
-			auto res = findDeserConverter(typeId, tag, type);
-			if (res) {
-				propertyType = typeId;
+			auto res = resolveDeserConverter(typeId, tag, type);
+			if (res.converter || res.wrongTag)
 				return res;
-			}
 		}
 	}
 
-	// third: check if already cached
-	if (auto converter = deserCache.get(propertyType);
-		converter && converter->canDeserialize(propertyType, tag, type) > 0) {
-		qCDebug(logSerializer) << "Found cached deserialization converter" << converter->name()
-							   << "for type" <<  QMetaTypeName(propertyType)
-							   << LogTag{tag}
-							   << "and CBOR-type" << type;
-		return converter;
-	}
-
-	// fourth: check if the list of explicit converters has a matching one
+	// second: check if the list of explicit converters has a matching one
 	QReadLocker cLocker{&typeConverters.lock};
-	auto throwWrongTag = false;
+	auto wrongTag = false;
 	std::optional<std::pair<QSharedPointer<TypeConverter>, int>> guessConverter;
 	for (const auto &converter : qAsConst(typeConverters.store)) {
 		if (converter) {
@@ -516,7 +1064,7 @@ QSharedPointer<TypeConverter> SerializerBasePrivate::findDeserConverter(int &pro
 			case TypeConverter::Negative:
 				continue;
 			case TypeConverter::WrongTag:
-				throwWrongTag = true;
+				wrongTag = true;
 				continue;
 			case TypeConverter::Guessed:
 				if (!guessConverter)
@@ -526,49 +1074,39 @@ QSharedPointer<TypeConverter> SerializerBasePrivate::findDeserConverter(int &pro
 				break;
 			}
 
-			// add converter to cache (only happens for positive cases)
-			deserCache.add(propertyType, converter);
-			qCDebug(logSerializer) << "Found and cached deserialization converter" << converter->name()
+			qCDebug(logSerializer) << "Found deserialization converter" << converter->name()
 								   << "for type" <<  QMetaTypeName(propertyType)
 								   << LogTag{tag}
 								   << "and CBOR-type" << type;
-			return converter;
+			return {converter, propertyType, false};
 		}
 	}
 	cLocker.unlock();
 
-	// fifth: if a guessed converter is available, use that one
+	// third: if a guessed converter is available, use that one
 	if (guessConverter) {
 		// extract converter from info;
 		auto &[converter, newType] = *guessConverter;
-		// if valid, add to cache, set the type and return
+		// if valid, set the type and return
 		if (converter) {
-			// add converter to list and cache
-			propertyType = newType;
-			deserCache.add(propertyType, converter);
-			qCDebug(logSerializer) << "Found and cached deserialization converter" << converter->name()
+			qCDebug(logSerializer) << "Found deserialization converter" << converter->name()
 								   << "by guessing the data with CBOR-tag" << tag
 								   << "and CBOR-type" << type
-								   << "is of type" << QMetaTypeName(propertyType);
-			return converter;
+								   << "is of type" << QMetaTypeName(newType);
+			return {converter, newType, false};
 		}
 	}
 
-	// sixth: if a wrong tag mark was set, throw an expection
-	if (throwWrongTag) {
-		throw DeserializationException{QByteArray{"Found converter able to handle data of type "} +
-									   QMetaTypeName(propertyType) +
-									   ", but the given CBOR tag " +
-									   QByteArray::number(static_cast<quint64>(tag)) +
-									   " is not convertible to that type."};
-	}
+	// fourth: if a wrong tag mark was set, remember that
+	if (wrongTag)
+		return {nullptr, propertyType, true};
 
-	// seventh: no converter found: return default converter
+	// fifth: no converter found: use the default converter
 	qCDebug(logSerializer) << "Unable to find deserialization converte for type" <<  QMetaTypeName(propertyType)
 						   << LogTag{tag}
 						   << "and CBOR-type" << type
 						   << "- falling back to default CBOR to QVariant conversion";
-	return nullptr;
+	return {};
 }
 
 void SerializerBasePrivate::updateConverterStore() const
@@ -594,6 +1132,13 @@ void SerializerBasePrivate::updateConverterStore() const
 
 int SerializerBasePrivate::getEnumId(QMetaEnum metaEnum, bool ser) const
 {
+	// the name is static data of the meta object, so the pointer identifies the enum
+	const QPair<const QMetaObject*, const char*> key {metaEnum.enclosingMetaObject(), metaEnum.name()};
+	QReadLocker rLocker{&enumIdLock};
+	if (const auto it = enumIds.constFind(key); it != enumIds.constEnd())
+		return *it;
+	rLocker.unlock();
+
 	QByteArray eName = metaEnum.name();
 	if (const QByteArray scope = metaEnum.scope(); !scope.isEmpty())
 		eName = scope + "::" + eName;
@@ -607,8 +1152,51 @@ int SerializerBasePrivate::getEnumId(QMetaEnum metaEnum, bool ser) const
 			throw SerializationException{"Unable to determine typeid of meta enum " + eName};
 		else
 			throw DeserializationException{"Unable to determine typeid of meta enum " + eName};
-	} else
-		return eTypeId;
+	}
+
+	QWriteLocker wLocker{&enumIdLock};
+	enumIds.insert(key, eTypeId);
+	return eTypeId;
+}
+
+QVariant SerializerBasePrivate::enforceType(int propertyType, QVariant variant, bool isNull) const
+{
+	auto vType = variant.typeName();
+
+	// exclude special values that can convert from null, but should not do so
+	auto allowConvert = true;
+	switch (propertyType) {
+	case QMetaType::QString:
+	case QMetaType::QByteArray:
+		if (isNull)
+			allowConvert = false;
+		break;
+	default:
+		break;
+	}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	if(allowConvert && variant.canConvert(propertyType) && variant.convert(propertyType))
+#else
+	if(allowConvert && variant.canConvert(QMetaType(propertyType)) && variant.convert(QMetaType(propertyType)))
+#endif
+		return variant;
+	else if(allowNull && isNull)
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+		return QVariant{propertyType, nullptr};
+#else
+		return QVariant{QMetaType(propertyType), nullptr};
+#endif
+	else {
+		ErrorSink::fail([vType, propertyType]() {
+			return QByteArray("Failed to convert deserialized variant of type ") +
+				   (vType ? vType : "<unknown>") +
+				   QByteArray(" to property type ") +
+				   QMetaTypeName(propertyType) +
+				   QByteArray(". Make shure to register converters with the QJsonSerializer::register* methods");
+		});
+		return {};
+	}
 }
 
 QCborValue SerializerBasePrivate::serializeValue(int propertyType, const QVariant &value) const
@@ -617,6 +1205,27 @@ QCborValue SerializerBasePrivate::serializeValue(int propertyType, const QVarian
 	return QCborValue::fromVariant(value);
 }
 
+QCborValue SerializerBasePrivate::serializeRawValue(int propertyType, const void *value) const
+{
+	// the most common types are converted directly, the same way QCborValue::fromVariant does
+	switch (propertyType) {
+	case QMetaType::Bool:
+		return *static_cast<const bool*>(value);
+	case QMetaType::Int:
+		return *static_cast<const int*>(value);
+	case QMetaType::UInt:
+		return static_cast<qint64>(*static_cast<const uint*>(value));
+	case QMetaType::LongLong:
+		return *static_cast<const qint64*>(value);
+	case QMetaType::Double:
+		return *static_cast<const double*>(value);
+	case QMetaType::QString:
+		return *static_cast<const QString*>(value);
+	default:
+		return serializeValue(propertyType, RawValue::box(propertyType, value));
+	}
+}
+
 QVariant SerializerBasePrivate::deserializeCborValue(int propertyType, const QCborValue &value) const
 {
 	Q_Q(const SerializerBase);
@@ -714,9 +1323,12 @@ QVariant SerializerBasePrivate::deserializeCborValue(int propertyType, const QCb
 			doThrow = true;
 
 		if (doThrow) {
-			throw DeserializationException(QByteArray("Failed to deserialze CBOR-value to type ") +
-										   QMetaTypeName(propertyType) +
-										   QByteArray(" because the given CBOR-value failed strict validation"));
+			ErrorSink::fail([propertyType]() {
+				return QByteArray("Failed to deserialze CBOR-value to type ") +
+					   QMetaTypeName(propertyType) +
+					   QByteArray(" because the given CBOR-value failed strict validation");
+			});
+			return {};
 		}
 	}
 
@@ -773,9 +1385,12 @@ QVariant SerializerBasePrivate::deserializeJsonValue(int propertyType, const QCb
 		}
 
 		if (doThrow) {
-			throw DeserializationException(QByteArray("Failed to deserialze JSON-value to type ") +
-										   QMetaTypeName(propertyType) +
-										   QByteArray("because the given JSON-value failed strict validation"));
+			ErrorSink::fail([propertyType]() {
+				return QByteArray("Failed to deserialze JSON-value to type ") +
+					   QMetaTypeName(propertyType) +
+					   QByteArray("because the given JSON-value failed strict validation");
+			});
+			return {};
 		}
 	}
 
@@ -786,3 +1401,36 @@ QVariant SerializerBasePrivate::deserializeJsonValue(int propertyType, const QCb
 	else
 		return value.toVariant();
 }
+
+
+
+std::optional<SerializerBasePrivate::DeserializationEntry> SerializerBasePrivate::DeserializationCache::get(const DeserializationKey &key) const
+{
+	QReadLocker _{&_lock};
+	// globally registered extractors and writers can change what converters accept
+	if (_revision != registryRevision.loadAcquire())
+		return std::nullopt;
+	if (const auto it = _store.constFind(key); it != _store.constEnd())
+		return *it;
+	else
+		return std::nullopt;
+}
+
+void SerializerBasePrivate::DeserializationCache::add(const DeserializationKey &key, const DeserializationEntry &entry, int revision)
+{
+	QWriteLocker _{&_lock};
+	// decisions made before a registration happend are outdated already
+	if (revision != registryRevision.loadAcquire())
+		return;
+	if (_revision != revision) {
+		_store.clear();
+		_revision = revision;
+	}
+	_store.insert(key, entry);
+}
+
+void SerializerBasePrivate::DeserializationCache::clear()
+{
+	QWriteLocker _{&_lock};
+	_store.clear();
+}
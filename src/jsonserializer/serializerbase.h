@@ -7,10 +7,13 @@
 #include "QtJsonSerializer/qtjsonserializer_helpertypes.h"
 #include "QtJsonSerializer/metawriters.h"
 #include "QtJsonSerializer/typeextractors.h"
+#include "QtJsonSerializer/changetracker.h"
+#include "QtJsonSerializer/instancefactory.h"
 
 #include <tuple>
 #include <optional>
 #include <variant>
+#include <utility>
 
 #include <QtCore/qobject.h>
 #include <QtCore/qmetaobject.h>
@@ -30,6 +33,7 @@
 #include <QtCore/qstack.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qmap.h>
+#include <QtCore/qscopeguard.h>
 
 namespace QtJsonSerializer {
 
@@ -49,6 +53,8 @@ class Q_JSONSERIALIZER_EXPORT SerializerBase : public QObject, protected TypeCon
 	Q_PROPERTY(bool versionAsString READ versionAsString WRITE setVersionAsString NOTIFY versionAsStringChanged)
 	//! Specifies whether datetimes should be serialized as datetime string or as unix timestamp
 	Q_PROPERTY(bool dateAsTimeStamp READ dateAsTimeStamp WRITE setDateAsTimeStamp NOTIFY dateAsTimeStampChanged)
+	//! Specifies whether datetimes should be serialized as milliseconds since epoch, instead of a string or unix timestamp
+	Q_PROPERTY(bool dateAsMsecsSinceEpoch READ dateAsMsecsSinceEpoch WRITE setDateAsMsecsSinceEpoch NOTIFY dateAsMsecsSinceEpochChanged)
 	//! Specifies whether serializing a QLocale should use the bcp47 format
 	Q_PROPERTY(bool useBcp47Locale READ useBcp47Locale WRITE setUseBcp47Locale NOTIFY useBcp47LocaleChanged)
 	//! Specifies how strictly the serializer should verify data when deserializing
@@ -59,6 +65,14 @@ class Q_JSONSERIALIZER_EXPORT SerializerBase : public QObject, protected TypeCon
 	Q_PROPERTY(MultiMapMode multiMapMode READ multiMapMode WRITE setMultiMapMode NOTIFY multiMapModeChanged)
 	//! Specifies whether the STORED attribute on properties has any effect
 	Q_PROPERTY(bool ignoreStoredAttribute READ ignoresStoredAttribute WRITE setIgnoreStoredAttribute NOTIFY ignoreStoredAttributeChanged)
+	//! Specifies whether gadgets and objects should be serialized as positional arrays instead of maps
+	Q_PROPERTY(bool positionalEncoding READ positionalEncoding WRITE setPositionalEncoding NOTIFY positionalEncodingChanged)
+	//! Specifies whether std::variant values are serialized together with the index of the contained alternative
+	Q_PROPERTY(bool variantDiscriminator READ variantDiscriminator WRITE setVariantDiscriminator NOTIFY variantDiscriminatorChanged)
+	//! An optional tracker that records the property changes of all objects that are serialized or deserialized
+	Q_PROPERTY(QtJsonSerializer::ChangeTracker* changeTracker READ changeTracker WRITE setChangeTracker NOTIFY changeTrackerChanged)
+	//! Specifies whether notify signals are only emitted once all properties of an object have been deserialized
+	Q_PROPERTY(bool deferNotifications READ deferNotifications WRITE setDeferNotifications NOTIFY deferNotificationsChanged)
 
 public:
 	//! Flags to specify how strict the serializer should validate when deserializing
@@ -139,6 +153,8 @@ public:
 	bool versionAsString() const;
 	//! @readAcFn{QJsonSerializer::dateAsTimeStamp}
 	bool dateAsTimeStamp() const;
+	//! @readAcFn{QJsonSerializer::dateAsMsecsSinceEpoch}
+	bool dateAsMsecsSinceEpoch() const;
 	//! @readAcFn{QJsonSerializer::useBcp47Locale}
 	bool useBcp47Locale() const;
 	//! @readAcFn{QJsonSerializer::validationFlags}
@@ -149,6 +165,14 @@ public:
 	MultiMapMode multiMapMode() const;
 	//! @readAcFn{QJsonSerializer::ignoreStoredAttribute}
 	bool ignoresStoredAttribute() const;
+	//! @readAcFn{QJsonSerializer::positionalEncoding}
+	bool positionalEncoding() const;
+	//! @readAcFn{QJsonSerializer::variantDiscriminator}
+	bool variantDiscriminator() const;
+	//! @readAcFn{QJsonSerializer::changeTracker}
+	ChangeTracker *changeTracker() const;
+	//! @readAcFn{QJsonSerializer::deferNotifications}
+	bool deferNotifications() const;
 
 	//! Globally registers a converter factory to provide converters for all QJsonSerializer instances
 	template <typename TConverter, int Priority = TypeConverter::Priority::Standard>
@@ -162,6 +186,12 @@ public:
 	//! @copybrief SerializerBase::addJsonTypeConverter()
 	void addJsonTypeConverter(const QSharedPointer<TypeConverter> &converter);
 
+	//! Sets the factory used to create instances of the given class when deserializing
+	void setInstanceFactory(const QMetaObject *metaObject, const QSharedPointer<InstanceFactory> &factory);
+	//! @copybrief SerializerBase::setInstanceFactory(const QMetaObject *, const QSharedPointer<InstanceFactory> &)
+	template <typename T>
+	void setInstanceFactory(const QSharedPointer<InstanceFactory> &factory);
+
 public Q_SLOTS:
 	//! @writeAcFn{QJsonSerializer::allowDefaultNull}
 	void setAllowDefaultNull(bool allowDefaultNull);
@@ -173,6 +203,8 @@ public Q_SLOTS:
 	void setVersionAsString(bool versionAsString);
 	//! @writeAcFn{QJsonSerializer::dateAsTimeStamp}
 	void setDateAsTimeStamp(bool dateAsTimeStamp);
+	//! @writeAcFn{QJsonSerializer::dateAsMsecsSinceEpoch}
+	void setDateAsMsecsSinceEpoch(bool dateAsMsecsSinceEpoch);
 	//! @writeAcFn{QJsonSerializer::useBcp47Locale}
 	void setUseBcp47Locale(bool useBcp47Locale);
 	//! @writeAcFn{QJsonSerializer::validationFlags}
@@ -183,6 +215,14 @@ public Q_SLOTS:
 	void setMultiMapMode(MultiMapMode multiMapMode);
 	//! @writeAcFn{QJsonSerializer::ignoreStoredAttribute}
 	void setIgnoreStoredAttribute(bool ignoreStoredAttribute);
+	//! @writeAcFn{QJsonSerializer::positionalEncoding}
+	void setPositionalEncoding(bool positionalEncoding);
+	//! @writeAcFn{QJsonSerializer::variantDiscriminator}
+	void setVariantDiscriminator(bool variantDiscriminator);
+	//! @writeAcFn{QJsonSerializer::changeTracker}
+	void setChangeTracker(ChangeTracker *changeTracker);
+	//! @writeAcFn{QJsonSerializer::deferNotifications}
+	void setDeferNotifications(bool deferNotifications);
 
 Q_SIGNALS:
 	//! @notifyAcFn{QJsonSerializer::allowDefaultNull}
@@ -195,6 +235,8 @@ Q_SIGNALS:
 	void versionAsStringChanged(bool versionAsString, QPrivateSignal);
 	//! @notifyAcFn{QJsonSerializer::dateAsTimeStamp}
 	void dateAsTimeStampChanged(bool dateAsTimeStamp, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::dateAsMsecsSinceEpoch}
+	void dateAsMsecsSinceEpochChanged(bool dateAsMsecsSinceEpoch, QPrivateSignal);
 	//! @notifyAcFn{QJsonSerializer::useBcp47Locale}
 	void useBcp47LocaleChanged(bool useBcp47Locale, QPrivateSignal);
 	//! @notifyAcFn{QJsonSerializer::validationFlags}
@@ -205,6 +247,14 @@ Q_SIGNALS:
 	void multiMapModeChanged(MultiMapMode multiMapMode, QPrivateSignal);
 	//! @notifyAcFn{QJsonSerializer::ignoreStoredAttribute}
 	void ignoreStoredAttributeChanged(bool ignoreStoredAttribute, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::positionalEncoding}
+	void positionalEncodingChanged(bool positionalEncoding, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::variantDiscriminator}
+	void variantDiscriminatorChanged(bool variantDiscriminator, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::changeTracker}
+	void changeTrackerChanged(QtJsonSerializer::ChangeTracker *changeTracker, QPrivateSignal);
+	//! @notifyAcFn{QJsonSerializer::deferNotifications}
+	void deferNotificationsChanged(bool deferNotifications, QPrivateSignal);
 
 protected:
 	//! Default constructor
@@ -217,15 +267,45 @@ protected:
 	// protected implementation -> internal use for the type converters
 	QVariant getProperty(const char *name) const override;
 	QSharedPointer<const TypeExtractor> extractor(int metaTypeId) const override;
+	QSharedPointer<InstanceFactory> instanceFactory(const QMetaObject *metaObject) const override;
 	QCborValue serializeSubtype(const QMetaProperty &property, const QVariant &value) const override;
 	QCborValue serializeSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const override;
+	QCborValue serializeSubtypeRaw(const QMetaProperty &property, const void *value) const override;
+	QCborValue serializeSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const override;
+	SubtypeSerializer subtypeSerializer(int propertyType) const override;
 	QVariant deserializeSubtype(const QMetaProperty &property, const QCborValue &value, QObject *parent) const override;
 	QVariant deserializeSubtype(int propertyType, const QCborValue &value, QObject *parent, const QByteArray &traceHint) const override;
+	bool deserializeSubtypeRaw(const QMetaProperty &property, const QCborValue &value, void *target, QObject *parent) const override;
+	bool canDeserializeSubtype(int propertyType, const QCborValue &value) const override;
+	QJsonValue serializeJsonSubtype(const QMetaProperty &property, const QVariant &value) const override;
+	QJsonValue serializeJsonSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const override;
+	QJsonValue serializeJsonSubtypeRaw(const QMetaProperty &property, const void *value) const override;
+	QJsonValue serializeJsonSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const override;
+	JsonSubtypeSerializer jsonSubtypeSerializer(int propertyType) const override;
+	QVariant deserializeJsonSubtype(const QMetaProperty &property, const QJsonValue &value, QObject *parent) const override;
+	QVariant deserializeJsonSubtype(int propertyType, const QJsonValue &value, QObject *parent, const QByteArray &traceHint) const override;
+	void deserializeSubtypeInto(const QMetaProperty &property, QVariant &target, const QCborValue &value, QObject *parent) const override;
+	void deserializeSubtypeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent, const QByteArray &traceHint) const override;
+	bool isPlainSubtype(int propertyType, QCborValue::Type valueType) const override;
 
 	//! @private
 	QCborValue serializeVariant(int propertyType, const QVariant &value) const;
 	//! @private
+	QCborValue serializeRaw(int propertyType, const void *value) const;
+	//! @private
 	QVariant deserializeVariant(int propertyType, const QCborValue &value, QObject *parent, bool skipConversion = false) const;
+	//! @private
+	DeserializationResult tryDeserializeVariant(int propertyType, const QCborValue &value, QObject *parent) const;
+	//! @private
+	void deserializeVariantInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const;
+	//! @private
+	QJsonValue serializeJsonVariant(int propertyType, const QVariant &value) const;
+	//! @private
+	QJsonValue serializeJsonRaw(int propertyType, const void *value) const;
+	//! @private
+	QVariant deserializeJsonVariant(int propertyType, const QJsonValue &value, QObject *parent) const;
+	//! @private
+	DeserializationResult tryDeserializeJsonVariant(int propertyType, const QJsonValue &value, QObject *parent) const;
 
 private:
 	Q_DECLARE_PRIVATE(SerializerBase)
@@ -339,6 +419,12 @@ void SerializerBase::addJsonTypeConverter()
 	addJsonTypeConverter(QSharedPointer<TConverter>::create());
 }
 
+template<typename T>
+void SerializerBase::setInstanceFactory(const QSharedPointer<InstanceFactory> &factory)
+{
+	setInstanceFactory(&T::staticMetaObject, factory);
+}
+
 }
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(QtJsonSerializer::SerializerBase::ValidationFlags)
@@ -8,6 +8,8 @@
 #include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 
+#include <optional>
+
 #include <QtCore/private/qobject_p.h>
 
 namespace QtJsonSerializer {
@@ -51,7 +53,32 @@ public:
 		void insertSorted(const QSharedPointer<TConverter> &converter, QWriteLocker &locker);
 	};
 
+	struct DeserializationEntry {
+		QSharedPointer<TypeConverter> converter;
+		int metaTypeId = QMetaType::UnknownType;
+		bool wrongTag = false;
+	};
+	// ((metaTypeId, CBOR-type), (CBOR-tag, jsonMode))
+	using DeserializationKey = QPair<QPair<int, int>, QPair<quint64, bool>>;
+
+	class DeserializationCache {
+	public:
+		std::optional<DeserializationEntry> get(const DeserializationKey &key) const;
+		void add(const DeserializationKey &key, const DeserializationEntry &entry, int revision);
+
+		void clear();
+
+	private:
+		mutable QReadWriteLock _lock {};
+		QHash<DeserializationKey, DeserializationEntry> _store;
+		int _revision = 0;
+	};
+
 	static ThreadSafeStore<TypeExtractor> extractors;
+	static QAtomicInt registryRevision;
+
+	static QReadWriteLock enumIdLock;
+	static QHash<QPair<const QMetaObject*, const char*>, int> enumIds;
 
 	static QReadWriteLock typeConverterFactoryLock;
 	static QList<TypeConverterFactory*> typeConverterFactories;
@@ -61,25 +88,36 @@ public:
 	bool enumAsString = false;
 	bool versionAsString = false;
 	bool dateAsTimeStamp = false;
+	bool dateAsMsecsSinceEpoch = false;
 	bool useBcp47Locale = true;
 	ValidationFlags validationFlags = ValidationFlag::StandardValidation;
 	Polymorphing polymorphing = Polymorphing::Enabled;
 	MultiMapMode multiMapMode = MultiMapMode::Map;
 	bool ignoreStoredAttribute = false;
+	bool positionalEncoding = false;
+	bool variantDiscriminator = false;
+	QPointer<ChangeTracker> changeTracker;
+	bool deferNotifications = false;
+
+	mutable QReadWriteLock instanceFactoryLock {};
+	QHash<const QMetaObject*, QSharedPointer<InstanceFactory>> instanceFactories;
 
 	mutable ConverterStore<TypeConverter> typeConverters;
 	mutable ThreadSafeStore<TypeConverter> serCache;
-	mutable ThreadSafeStore<TypeConverter> deserCache;
+	mutable DeserializationCache deserCache;
 
 	template <typename TConverter>
 	void insertSorted(const QSharedPointer<TConverter> &converter, QList<QSharedPointer<TConverter>> &list) const;
 
 	QSharedPointer<TypeConverter> findSerConverter(int propertyType) const;
 	QSharedPointer<TypeConverter> findDeserConverter(int &propertyType, QCborTag tag, QCborValue::Type type) const;
+	DeserializationEntry resolveDeserConverter(int propertyType, QCborTag tag, QCborValue::Type type) const;
 	void updateConverterStore() const;
 
 	int getEnumId(QMetaEnum metaEnum, bool ser) const;
+	QVariant enforceType(int propertyType, QVariant variant, bool isNull) const;
 	virtual QCborValue serializeValue(int propertyType, const QVariant &value) const;
+	QCborValue serializeRawValue(int propertyType, const void *value) const;
 	virtual QVariant deserializeCborValue(int propertyType, const QCborValue &value) const;
 	virtual QVariant deserializeJsonValue(int propertyType, const QCborValue &value) const;
 };
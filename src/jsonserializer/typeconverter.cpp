@@ -1,5 +1,7 @@
 #include "typeconverter.h"
 #include "serializerbase_p.h"
+#include "exceptioncontext_p.h"
+#include "rawvalue_p.h"
 using namespace QtJsonSerializer;
 
 namespace QtJsonSerializer {
@@ -47,6 +49,27 @@ QList<QCborTag> TypeConverter::allowedCborTags(int metaTypeId) const
 	return {};
 }
 
+TypeConverter::TagSupport TypeConverter::cborTagSupport(int metaTypeId, QCborTag tag) const
+{
+	// compatibility for converters that only implement allowedCborTags
+	const auto aTags = allowedCborTags(metaTypeId);
+	if (aTags.isEmpty())
+		return TagSupport::Unrestricted;
+	else if (aTags.contains(tag))
+		return TagSupport::Allowed;
+	else
+		return TagSupport::Rejected;
+}
+
+TypeConverter::CborTypeMask TypeConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
+{
+	// compatibility for converters that only implement allowedCborTypes
+	CborTypeMask mask = 0;
+	for (const auto type : allowedCborTypes(metaTypeId, tag))
+		mask |= cborTypeBit(type);
+	return mask;
+}
+
 int TypeConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 {
 	Q_UNUSED(tag)
@@ -57,9 +80,11 @@ int TypeConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 TypeConverter::DeserializationCapabilityResult TypeConverter::canDeserialize(int &metaTypeId, QCborTag tag, QCborValue::Type dataType) const
 {
 	const auto asJson = helper()->jsonMode();
-	const auto strict = helper()->getProperty("validationFlags")
-							.value<SerializerBase::ValidationFlags>()
-							.testFlag(SerializerBase::ValidationFlag::StrictBasicTypes);
+	const auto isStrict = [this]() {
+		return helper()->getProperty("validationFlags")
+			.value<SerializerBase::ValidationFlags>()
+			.testFlag(SerializerBase::ValidationFlag::StrictBasicTypes);
+	};
 
 	// case A: a metaTypeId is present
 	if (metaTypeId != QMetaType::UnknownType) {
@@ -70,28 +95,35 @@ TypeConverter::DeserializationCapabilityResult TypeConverter::canDeserialize(int
 		// second: verify the tag if not in json mode
 		if (!asJson) {
 			// if either we are in strict mode or a tag is given, the tag is verified
-			if (strict || tag != NoTag) {
-				// If there is a list of allowed tags, the given tag must be in it
-				auto aTags = allowedCborTags(metaTypeId);
-				// also, add the type specific override tag if set
-				if (const auto xTag = helper()->typeTag(metaTypeId); xTag != NoTag)
-					aTags.append(xTag);
-				if (!aTags.isEmpty()) {
-					if (!aTags.contains(tag))
+			if (tag != NoTag || isStrict()) {
+				// the type specific override tag is always allowed, if set
+				const auto xTag = helper()->typeTag(metaTypeId);
+				if (xTag == NoTag || xTag != tag) {
+					switch (cborTagSupport(metaTypeId, tag)) {
+					case TagSupport::Allowed:
+						break;
+					case TagSupport::Rejected:
 						return DeserializationCapabilityResult::WrongTag;
-				// otherwise, if in strict mode, an empty allowed tag list means the tag must not be set
-				} else if (strict && tag != NoTag)
-					return DeserializationCapabilityResult::WrongTag;
+					case TagSupport::Unrestricted:
+						// if only the override tag is allowed, the given tag must be it
+						if (xTag != NoTag)
+							return DeserializationCapabilityResult::WrongTag;
+						// otherwise, if in strict mode, no tag may be set at all
+						else if (tag != NoTag && isStrict())
+							return DeserializationCapabilityResult::WrongTag;
+						break;
+					}
+				}
 			}
 		}
 
 		// third: verify the datatype, based on type and tag
-		auto aTypes = allowedCborTypes(metaTypeId, tag);
+		auto aTypes = allowedCborTypeMask(metaTypeId, tag);
 		// if in json mode, convert the supported types to their json equivalent
 		if (asJson)
-			mapTypesToJson(aTypes);
+			aTypes = mapTypeMaskToJson(aTypes);
 		// then verify them
-		if (!aTypes.contains(dataType))
+		if ((aTypes & cborTypeBit(dataType)) == 0)
 			return DeserializationCapabilityResult::Negative;
 
 		return DeserializationCapabilityResult::Positive;
@@ -113,34 +145,102 @@ QVariant TypeConverter::deserializeJson(int propertyType, const QCborValue &valu
 	return deserializeCbor(propertyType, value, parent);
 }
 
-void TypeConverter::mapTypesToJson(QList<QCborValue::Type> &typeList) const
-{
-	auto hasDouble = false;
-	auto hasInt = false;
-	for (auto &type : typeList) {
-		switch (type) {
-		case QCborValue::Double:
-			hasDouble = true;
-			break;
-		case QCborValue::Integer:
-			hasInt = true;
-			break;
-		case QCborValue::ByteArray:
-		case QCborValue::DateTime:
-		case QCborValue::Url:
-		case QCborValue::RegularExpression:
-		case QCborValue::Uuid:
-			type = QCborValue::String;
-			break;
-		default:
-			break;
-		}
+QJsonValue TypeConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	return serialize(propertyType, value).toJsonValue();
+}
+
+QCborValue TypeConverter::serializeRaw(int propertyType, const void *value) const
+{
+	return serialize(propertyType, RawValue::box(propertyType, value));
+}
+
+QJsonValue TypeConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeJsonValue(propertyType, RawValue::box(propertyType, value));
+}
+
+void TypeConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
+{
+	auto variant = helper()->jsonMode() ?
+					   deserializeJson(propertyType, value, parent) :
+					   deserializeCbor(propertyType, value, parent);
+	// a failed value is invalid in sink mode, and must not replace the target
+	if (ErrorSink::currentFailed())
+		return;
+	const QByteArray vType = variant.typeName();
+	if (!RawValue::assign(propertyType, target, std::move(variant))) {
+		ErrorSink::fail([vType, propertyType]() {
+			return QByteArray("Failed to convert deserialized variant of type ") +
+				   (vType.isEmpty() ? QByteArray{"<unknown>"} : vType) +
+				   QByteArray(" to property type ") +
+				   QMetaTypeName(propertyType);
+		});
 	}
+}
 
-	if (hasInt && !hasDouble)
-		typeList.append(QCborValue::Double);
-	if (hasDouble && !hasInt)
-		typeList.append(QCborValue::Integer);
+QVariant TypeConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	return deserializeJson(propertyType, QCborValue::fromJsonValue(value), parent);
+}
+
+void TypeConverter::deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	if (helper()->jsonMode())
+		target = deserializeJson(propertyType, value, parent);
+	else
+		target = deserializeCbor(propertyType, value, parent);
+}
+
+QList<QCborValue::Type> TypeConverter::cborTypes(CborTypeMask mask)
+{
+	static constexpr QCborValue::Type AllTypes[] = {
+		QCborValue::Integer,
+		QCborValue::ByteArray,
+		QCborValue::String,
+		QCborValue::Array,
+		QCborValue::Map,
+		QCborValue::Tag,
+		QCborValue::SimpleType,
+		QCborValue::False,
+		QCborValue::True,
+		QCborValue::Null,
+		QCborValue::Undefined,
+		QCborValue::Double,
+		QCborValue::DateTime,
+		QCborValue::Url,
+		QCborValue::RegularExpression,
+		QCborValue::Uuid,
+		QCborValue::Invalid
+	};
+
+	QList<QCborValue::Type> types;
+	for (const auto type : AllTypes) {
+		if ((mask & cborTypeBit(type)) != 0)
+			types.append(type);
+	}
+	return types;
+}
+
+TypeConverter::CborTypeMask TypeConverter::mapTypeMaskToJson(CborTypeMask mask)
+{
+	// all extended string types are plain strings in json
+	constexpr auto StringTypes = cborTypeMask({
+		QCborValue::ByteArray,
+		QCborValue::DateTime,
+		QCborValue::Url,
+		QCborValue::RegularExpression,
+		QCborValue::Uuid
+	});
+	if ((mask & StringTypes) != 0)
+		mask = (mask & ~StringTypes) | cborTypeBit(QCborValue::String);
+
+	// json does not differentiate between integers and doubles
+	constexpr auto NumberTypes = cborTypeMask({QCborValue::Integer, QCborValue::Double});
+	if ((mask & NumberTypes) != 0)
+		mask |= NumberTypes;
+
+	return mask;
 }
 
 
@@ -149,6 +249,111 @@ TypeConverter::SerializationHelper::SerializationHelper() = default;
 
 TypeConverter::SerializationHelper::~SerializationHelper() = default;
 
+qint64 TypeConverter::SerializationHelper::classId(const QMetaObject *metaObject) const
+{
+	Q_UNUSED(metaObject)
+	return -1;
+}
+
+const QMetaObject *TypeConverter::SerializationHelper::classForId(qint64 classId) const
+{
+	Q_UNUSED(classId)
+	return nullptr;
+}
+
+QSharedPointer<InstanceFactory> TypeConverter::SerializationHelper::instanceFactory(const QMetaObject *metaObject) const
+{
+	Q_UNUSED(metaObject)
+	return {};
+}
+
+QCborValue TypeConverter::SerializationHelper::serializeSubtypeRaw(const QMetaProperty &property, const void *value) const
+{
+	return serializeSubtype(property, RawValue::box(property.userType(), value));
+}
+
+QCborValue TypeConverter::SerializationHelper::serializeSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const
+{
+	return serializeSubtype(propertyType, RawValue::box(propertyType, value), traceHint);
+}
+
+TypeConverter::SerializationHelper::SubtypeSerializer TypeConverter::SerializationHelper::subtypeSerializer(int propertyType) const
+{
+	return [this, propertyType](const void *value) {
+		return serializeSubtypeRaw(propertyType, value);
+	};
+}
+
+bool TypeConverter::SerializationHelper::deserializeSubtypeRaw(const QMetaProperty &property, const QCborValue &value, void *target, QObject *parent) const
+{
+	Q_UNUSED(property)
+	Q_UNUSED(value)
+	Q_UNUSED(target)
+	Q_UNUSED(parent)
+	return false;
+}
+
+bool TypeConverter::SerializationHelper::canDeserializeSubtype(int propertyType, const QCborValue &value) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(value)
+	return true;
+}
+
+QJsonValue TypeConverter::SerializationHelper::serializeJsonSubtype(const QMetaProperty &property, const QVariant &value) const
+{
+	return serializeSubtype(property, value).toJsonValue();
+}
+
+QJsonValue TypeConverter::SerializationHelper::serializeJsonSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const
+{
+	return serializeSubtype(propertyType, value, traceHint).toJsonValue();
+}
+
+QJsonValue TypeConverter::SerializationHelper::serializeJsonSubtypeRaw(const QMetaProperty &property, const void *value) const
+{
+	return serializeJsonSubtype(property, RawValue::box(property.userType(), value));
+}
+
+QJsonValue TypeConverter::SerializationHelper::serializeJsonSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint) const
+{
+	return serializeJsonSubtype(propertyType, RawValue::box(propertyType, value), traceHint);
+}
+
+TypeConverter::SerializationHelper::JsonSubtypeSerializer TypeConverter::SerializationHelper::jsonSubtypeSerializer(int propertyType) const
+{
+	return [this, propertyType](const void *value) {
+		return serializeJsonSubtypeRaw(propertyType, value);
+	};
+}
+
+QVariant TypeConverter::SerializationHelper::deserializeJsonSubtype(const QMetaProperty &property, const QJsonValue &value, QObject *parent) const
+{
+	return deserializeSubtype(property, QCborValue::fromJsonValue(value), parent);
+}
+
+QVariant TypeConverter::SerializationHelper::deserializeJsonSubtype(int propertyType, const QJsonValue &value, QObject *parent, const QByteArray &traceHint) const
+{
+	return deserializeSubtype(propertyType, QCborValue::fromJsonValue(value), parent, traceHint);
+}
+
+void TypeConverter::SerializationHelper::deserializeSubtypeInto(const QMetaProperty &property, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	target = deserializeSubtype(property, value, parent);
+}
+
+void TypeConverter::SerializationHelper::deserializeSubtypeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent, const QByteArray &traceHint) const
+{
+	target = deserializeSubtype(propertyType, value, parent, traceHint);
+}
+
+bool TypeConverter::SerializationHelper::isPlainSubtype(int propertyType, QCborValue::Type valueType) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(valueType)
+	return false;
+}
+
 
 
 TypeConverterFactory::TypeConverterFactory() = default;
@@ -165,3 +370,20 @@ QList<int> TypeExtractor::subtypes() const
 {
 	return {};
 }
+
+void TypeExtractor::emplace(QVariant &target, QVariant &&value, int index) const
+{
+	emplaceMoved(target, std::move(value), index);
+}
+
+const void *TypeExtractor::elementAt(const void *value, int index) const
+{
+	Q_UNUSED(value)
+	Q_UNUSED(index)
+	return nullptr;
+}
+
+void TypeExtractor::emplaceMoved(QVariant &target, QVariant &&value, int index) const
+{
+	emplace(target, static_cast<const QVariant&>(value), index);
+}
@@ -5,6 +5,8 @@
 
 #include <type_traits>
 #include <limits>
+#include <initializer_list>
+#include <functional>
 
 #include <QtCore/qmetatype.h>
 #include <QtCore/qmetaobject.h>
@@ -15,6 +17,8 @@
 
 namespace QtJsonSerializer {
 
+class InstanceFactory;
+
 //! Interface to extract data from any generic container
 class Q_JSONSERIALIZER_EXPORT TypeExtractor
 {
@@ -32,6 +36,13 @@ public:
 	virtual QVariant extract(const QVariant &value, int index = -1) const = 0;
 	//! Emplaces the value into the target of the extractors type at the given index
 	virtual void emplace(QVariant &target, const QVariant &value, int index = -1) const = 0;
+	//! Moves the value into the target of the extractors type at the given index
+	void emplace(QVariant &target, QVariant &&value, int index = -1) const;
+
+	//! Returns a pointer to the data at the given index inside of a value of the extractors type
+	virtual const void *elementAt(const void *value, int index = -1) const;
+	//! Moves the value into the target of the extractors type at the given index, see emplace()
+	virtual void emplaceMoved(QVariant &target, QVariant &&value, int index) const;
 };
 
 class TypeConverterPrivate;
@@ -62,6 +73,18 @@ public:
 		WrongTag = -2 //!< The converter could deserialize the given data, but the tag does not match
 	};
 
+	//! A bitmask of CBOR value types, see cborTypeBit()
+	using CborTypeMask = quint32;
+	//! A CborTypeMask that contains all valid CBOR value types
+	static constexpr CborTypeMask AnyCborType = 0x0000FFFF;
+
+	//! The possible results of cborTagSupport()
+	enum class TagSupport : int {
+		Unrestricted = 0, //!< The converter has no list of allowed tags for the type
+		Allowed = 1, //!< The tag is one of the allowed tags for the type
+		Rejected = -1 //!< The tag is not one of the allowed tags for the type
+	};
+
 	//! Helper class passed to the type converter by the serializer. Do not implement yourself
 	class Q_JSONSERIALIZER_EXPORT SerializationHelper
 	{
@@ -87,6 +110,51 @@ public:
 		virtual QVariant deserializeSubtype(const QMetaProperty &property, const QCborValue &value, QObject *parent) const = 0;
 		//! Deserialize a subvalue, represented by a type id
 		virtual QVariant deserializeSubtype(int propertyType, const QCborValue &value, QObject *parent, const QByteArray &traceHint = {}) const = 0;
+
+		//! Returns the compact id registered for the given class, or -1 if none was registered
+		virtual qint64 classId(const QMetaObject *metaObject) const;
+		//! Returns the class registered for the given compact id, or nullptr if none was registered
+		virtual const QMetaObject *classForId(qint64 classId) const;
+		//! Returns the factory registered to create instances of the given class, or nullptr
+		virtual QSharedPointer<InstanceFactory> instanceFactory(const QMetaObject *metaObject) const;
+
+		//! Serialize a subvalue, represented by a meta property, from a pointer to a value of the property type
+		virtual QCborValue serializeSubtypeRaw(const QMetaProperty &property, const void *value) const;
+		//! Serialize a subvalue, represented by a type id, from a pointer to a value of that type
+		virtual QCborValue serializeSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint = {}) const;
+		//! A function that serializes values of one type, from pointers to values of that type
+		using SubtypeSerializer = std::function<QCborValue(const void*)>;
+		//! Returns a function to serialize many subvalues of the same type, which resolves the converter only once
+		virtual SubtypeSerializer subtypeSerializer(int propertyType) const;
+		//! Deserialize a subvalue, represented by a meta property, into a pointer to a value of the property type. Returns false if deserializeSubtype has to be used instead
+		virtual bool deserializeSubtypeRaw(const QMetaProperty &property, const QCborValue &value, void *target, QObject *parent) const;
+		//! Checks if a subvalue could be deserialized to the given type. False positives are allowed, false negatives are not
+		virtual bool canDeserializeSubtype(int propertyType, const QCborValue &value) const;
+
+		//! Serialize a subvalue, represented by a meta property, directly to JSON
+		virtual QJsonValue serializeJsonSubtype(const QMetaProperty &property, const QVariant &value) const;
+		//! Serialize a subvalue, represented by a type id, directly to JSON
+		virtual QJsonValue serializeJsonSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint = {}) const;
+		//! Serialize a subvalue, represented by a meta property, from a pointer to a value of the property type directly to JSON
+		virtual QJsonValue serializeJsonSubtypeRaw(const QMetaProperty &property, const void *value) const;
+		//! Serialize a subvalue, represented by a type id, from a pointer to a value of that type directly to JSON
+		virtual QJsonValue serializeJsonSubtypeRaw(int propertyType, const void *value, const QByteArray &traceHint = {}) const;
+		//! A function that serializes values of one type directly to JSON, from pointers to values of that type
+		using JsonSubtypeSerializer = std::function<QJsonValue(const void*)>;
+		//! Returns a function to serialize many subvalues of the same type directly to JSON, which resolves the converter only once
+		virtual JsonSubtypeSerializer jsonSubtypeSerializer(int propertyType) const;
+		//! Deserialize a subvalue, represented by a meta property, directly from JSON
+		virtual QVariant deserializeJsonSubtype(const QMetaProperty &property, const QJsonValue &value, QObject *parent) const;
+		//! Deserialize a subvalue, represented by a type id, directly from JSON
+		virtual QVariant deserializeJsonSubtype(int propertyType, const QJsonValue &value, QObject *parent, const QByteArray &traceHint = {}) const;
+
+		//! Deserialize a subvalue, represented by a meta property, into an existing value
+		virtual void deserializeSubtypeInto(const QMetaProperty &property, QVariant &target, const QCborValue &value, QObject *parent) const;
+		//! Deserialize a subvalue, represented by a type id, into an existing value
+		virtual void deserializeSubtypeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent, const QByteArray &traceHint = {}) const;
+
+		//! Checks if subvalues of the given type and CBOR type are deserialized without a converter or type tag, and can thus be decoded directly
+		virtual bool isPlainSubtype(int propertyType, QCborValue::Type valueType) const;
 	};
 
 	//! Constructor
@@ -127,10 +195,36 @@ public:
 	//! Called by the serializer to deserializer your given type from JSON
 	virtual QVariant deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const;
 
+	//! Checks if the given tag is one of the allowed tags for the given type
+	virtual TagSupport cborTagSupport(int metaTypeId, QCborTag tag) const;
+	//! Returns the allowed types for the given type and tag as bitmask
+	virtual CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const;
+	//! Called by the JsonSerializer to serialize your given type directly to JSON
+	virtual QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const;
+	//! Called by the serializer to serialize your given type to CBOR, from a pointer to a value of that type
+	virtual QCborValue serializeRaw(int propertyType, const void *value) const;
+	//! Called by the JsonSerializer to serialize your given type directly to JSON, from a pointer to a value of that type
+	virtual QJsonValue serializeJsonRaw(int propertyType, const void *value) const;
+	//! Called by the serializer to deserialize your given type from CBOR or JSON, into a pointer to a value of that type
+	virtual void deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const;
+	//! Called by the JsonSerializer to deserialize your given type directly from JSON
+	virtual QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const;
+	//! Called by the serializer to update an existing value of your given type from CBOR or JSON
+	virtual void deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const;
+
+	//! Returns the bit that represents the given CBOR value type in a CborTypeMask
+	static constexpr CborTypeMask cborTypeBit(QCborValue::Type type);
+	//! Creates a CborTypeMask from the given CBOR value types
+	static constexpr CborTypeMask cborTypeMask(std::initializer_list<QCborValue::Type> types);
+	//! Returns the CBOR value types contained in the given CborTypeMask
+	static QList<QCborValue::Type> cborTypes(CborTypeMask mask);
+	//! Checks if the tag is one of the allowed tags, without allocating memory
+	static constexpr TagSupport checkCborTag(std::initializer_list<QCborTag> allowedTags, QCborTag tag);
+
 private:
 	QScopedPointer<TypeConverterPrivate> d;
 
-	void mapTypesToJson(QList<QCborValue::Type> &typeList) const;
+	static CborTypeMask mapTypeMaskToJson(CborTypeMask mask);
 };
 
 //! Macro to implement the TypeConverter::name method in a subclass
@@ -162,6 +256,63 @@ public:
 
 // ------------- GENERIC IMPLEMENTATION -------------
 
+constexpr TypeConverter::CborTypeMask TypeConverter::cborTypeBit(QCborValue::Type type)
+{
+	switch (type) {
+	case QCborValue::Integer:
+		return 1u << 0;
+	case QCborValue::ByteArray:
+		return 1u << 1;
+	case QCborValue::String:
+		return 1u << 2;
+	case QCborValue::Array:
+		return 1u << 3;
+	case QCborValue::Map:
+		return 1u << 4;
+	case QCborValue::Tag:
+		return 1u << 5;
+	case QCborValue::SimpleType:
+		return 1u << 6;
+	case QCborValue::False:
+		return 1u << 7;
+	case QCborValue::True:
+		return 1u << 8;
+	case QCborValue::Null:
+		return 1u << 9;
+	case QCborValue::Undefined:
+		return 1u << 10;
+	case QCborValue::Double:
+		return 1u << 11;
+	case QCborValue::DateTime:
+		return 1u << 12;
+	case QCborValue::Url:
+		return 1u << 13;
+	case QCborValue::RegularExpression:
+		return 1u << 14;
+	case QCborValue::Uuid:
+		return 1u << 15;
+	default:  // QCborValue::Invalid
+		return 1u << 16;
+	}
+}
+
+constexpr TypeConverter::CborTypeMask TypeConverter::cborTypeMask(std::initializer_list<QCborValue::Type> types)
+{
+	CborTypeMask mask = 0;
+	for (const auto type : types)
+		mask |= cborTypeBit(type);
+	return mask;
+}
+
+constexpr TypeConverter::TagSupport TypeConverter::checkCborTag(std::initializer_list<QCborTag> allowedTags, QCborTag tag)
+{
+	for (const auto aTag : allowedTags) {
+		if (aTag == tag)
+			return TagSupport::Allowed;
+	}
+	return allowedTags.size() == 0 ? TagSupport::Unrestricted : TagSupport::Rejected;
+}
+
 template<typename TConverter, int OverwritePriority>
 QSharedPointer<TypeConverter> TypeConverterStandardFactory<TConverter, OverwritePriority>::createConverter() const
 {
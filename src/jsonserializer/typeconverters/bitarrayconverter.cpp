@@ -1,5 +1,6 @@
 #include "bitarrayconverter_p.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 #include <QtCore/QBitArray>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
@@ -16,10 +17,15 @@ QList<QCborTag> BitArrayConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> BitArrayConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask BitArrayConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::ByteArray};
+	return cborTypeMask({QCborValue::ByteArray});
 }
 
 int BitArrayConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -32,9 +38,14 @@ int BitArrayConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 }
 
 QCborValue BitArrayConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue BitArrayConverter::serializeRaw(int propertyType, const void *value) const
 {
 	Q_UNUSED(propertyType)
-	const auto bitArray = value.value<QBitArray>();
+	const auto &bitArray = *static_cast<const QBitArray*>(value);
 	if (bitArray.isEmpty())
 		return {static_cast<QCborTag>(CborSerializer::BitArray), QByteArray{}};
 	else {
@@ -48,11 +59,34 @@ QCborValue BitArrayConverter::serialize(int propertyType, const QVariant &value)
 	}
 }
 
+QJsonValue BitArrayConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant BitArrayConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	Q_UNUSED(propertyType)
 	Q_UNUSED(parent)
+	return fromCbor(value);
+}
 
+QVariant BitArrayConverter::deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(parent)
+	return fromJson(value);
+}
+
+void BitArrayConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(parent)
+	*static_cast<QBitArray*>(target) = helper()->jsonMode() ? fromJson(value) : fromCbor(value);
+}
+
+QBitArray BitArrayConverter::fromCbor(const QCborValue &value)
+{
 	const auto cData = (value.isTag() ? value.taggedValue() : value).toByteArray();
 	if (cData.isEmpty())
 		return QBitArray{};
@@ -66,9 +100,7 @@ QVariant BitArrayConverter::deserializeCbor(int propertyType, const QCborValue &
 	}
 }
 
-QVariant BitArrayConverter::deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const
+QBitArray BitArrayConverter::fromJson(const QCborValue &value)
 {
-	return deserializeCbor(propertyType,
-						   QByteArray::fromBase64(value.toString().toUtf8(), QByteArray::Base64UrlEncoding),
-						   parent);
+	return fromCbor(QByteArray::fromBase64(value.toString().toUtf8(), QByteArray::Base64UrlEncoding));
 }
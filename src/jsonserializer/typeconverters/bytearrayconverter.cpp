@@ -1,6 +1,7 @@
 #include "bytearrayconverter_p.h"
 #include "exception.h"
 #include "jsonserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QByteArray>
 #include <QtCore/QRegularExpression>
@@ -24,10 +25,15 @@ QList<QCborTag> BytearrayConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> BytearrayConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask BytearrayConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::ByteArray};
+	return cborTypeMask({QCborValue::ByteArray});
 }
 
 int BytearrayConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -44,9 +50,19 @@ int BytearrayConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 }
 
 QCborValue BytearrayConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue BytearrayConverter::serializeRaw(int propertyType, const void *value) const
 {
 	Q_UNUSED(propertyType)
-	return value.toByteArray();
+	return *static_cast<const QByteArray*>(value);
+}
+
+QJsonValue BytearrayConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
 }
 
 QVariant BytearrayConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
@@ -60,7 +76,21 @@ QVariant BytearrayConverter::deserializeJson(int propertyType, const QCborValue
 {
 	Q_UNUSED(propertyType)
 	Q_UNUSED(parent)
+	return parseJson(value);
+}
+
+void BytearrayConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(parent)
+	if (helper()->jsonMode())
+		*static_cast<QByteArray*>(target) = parseJson(value);
+	else
+		*static_cast<QByteArray*>(target) = (value.isTag() ? value.taggedValue() : value).toByteArray();
+}
 
+QByteArray BytearrayConverter::parseJson(const QCborValue &value) const
+{
 	const auto mode = helper()->getProperty("byteArrayFormat").value<JsonSerializer::ByteArrayFormat>();
 	const auto strValue = value.toString();
 	if (helper()->getProperty("validateBase64").toBool()) {
@@ -13,10 +13,17 @@ public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	int guessType(QCborTag tag, QCborValue::Type dataType) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
+	QCborValue serializeRaw(int propertyType, const void *value) const override;
+	QJsonValue serializeJsonRaw(int propertyType, const void *value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
 	QVariant deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const override;
+	void deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const override;
+
+private:
+	QByteArray parseJson(const QCborValue &value) const;
 };
 
 }
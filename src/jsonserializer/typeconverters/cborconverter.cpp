@@ -24,21 +24,18 @@ bool CborConverter::canConvert(int metaTypeId) const
 }
 
 QList<QCborValue::Type> CborConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask CborConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(tag)
 	switch (metaTypeId) {
-	case QMetaType::QCborValue:{
-		QList<QCborValue::Type> types;
-		const auto metaEnum = QMetaEnum::fromType<QCborValue::Type>();
-		types.reserve(metaEnum.keyCount());
-		for (auto i = 0; i < metaEnum.keyCount(); ++i) {
-			if (const auto value = metaEnum.value(i); value != QCborValue::Invalid)
-				types.append(static_cast<QCborValue::Type>(value));
-		}
-		return types;
-	}
+	case QMetaType::QCborValue:
+		return AnyCborType;
 	case QMetaType::QJsonValue:
-		return {
+		return cborTypeMask({
 			QCborValue::Null,
 			QCborValue::True,
 			QCborValue::False,
@@ -46,23 +43,23 @@ QList<QCborValue::Type> CborConverter::allowedCborTypes(int metaTypeId, QCborTag
 			QCborValue::String,
 			QCborValue::Array,
 			QCborValue::Map
-		};
+		});
 	case QMetaType::QCborSimpleType:
-		return {
+		return cborTypeMask({
 			QCborValue::SimpleType,
 			QCborValue::True,
 			QCborValue::False,
 			QCborValue::Null,
 			QCborValue::Undefined
-		};
+		});
 	case QMetaType::QCborMap:
 	case QMetaType::QJsonObject:
-		return {QCborValue::Map};
+		return cborTypeBit(QCborValue::Map);
 	case QMetaType::QCborArray:
 	case QMetaType::QJsonArray:
-		return {QCborValue::Array};
+		return cborTypeBit(QCborValue::Array);
 	case QMetaType::QJsonDocument:
-		return {QCborValue::Map, QCborValue::Array, QCborValue::Null};
+		return cborTypeMask({QCborValue::Map, QCborValue::Array, QCborValue::Null});
 	default:
 		Q_UNREACHABLE();
 	}
@@ -116,3 +113,40 @@ QVariant CborConverter::deserializeCbor(int propertyType, const QCborValue &valu
 		throw DeserializationException{"Unsupported type"};
 	}
 }
+
+QJsonValue CborConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	switch (propertyType) {
+	case QMetaType::QJsonValue:
+	case QMetaType::QJsonObject:
+	case QMetaType::QJsonArray:
+	case QMetaType::QJsonDocument:
+		// already JSON -> no need to go via CBOR
+		return value.toJsonValue();
+	default:
+		return TypeConverter::serializeJsonValue(propertyType, value);
+	}
+}
+
+QVariant CborConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	switch (propertyType) {
+	case QMetaType::QJsonValue:
+		return QVariant::fromValue(value);
+	case QMetaType::QJsonObject:
+		return QVariant::fromValue(value.toObject());
+	case QMetaType::QJsonArray:
+		return QVariant::fromValue(value.toArray());
+	case QMetaType::QJsonDocument:
+		switch (value.type()) {
+		case QJsonValue::Array:
+			return QVariant::fromValue(QJsonDocument{value.toArray()});
+		case QJsonValue::Object:
+			return QVariant::fromValue(QJsonDocument{value.toObject()});
+		default:
+			return QVariant::fromValue(QJsonDocument{});
+		}
+	default:
+		return TypeConverter::deserializeJsonValue(propertyType, value, parent);
+	}
+}
@@ -12,8 +12,11 @@ public:
 	QT_JSONSERIALIZER_TYPECONVERTER_NAME(CborConverter)
 	bool canConvert(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+	QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const override;
+	QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const override;
 };
 
 }
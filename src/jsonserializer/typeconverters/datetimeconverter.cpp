@@ -1,10 +1,57 @@
 #include "datetimeconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "isodatetime_p.h"
+#include "rawvalue_p.h"
 #include <QtCore/QSet>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
+namespace {
+
+QDateTime readDateTime(const QCborValue &value, const QCborValue &cValue)
+{
+	if (const auto dateTime = IsoDateTime::parseDateTime(cValue.toString()); dateTime)
+		return *dateTime;
+	else
+		return value.toDateTime();
+}
+
+QDateTime toDateTime(const QCborValue &value)
+{
+	const auto cValue = (value.isTag() ? value.taggedValue() : value);
+	if (value.tag() == static_cast<QCborTag>(CborSerializer::DateTimeMsecs))
+		return QDateTime::fromMSecsSinceEpoch(cValue.toInteger(), Qt::UTC);
+	else if (value.tag() == QCborKnownTags::DateTimeString)
+		return readDateTime(value, cValue);
+	else
+		return value.toDateTime();
+}
+
+QDate toDate(const QCborValue &value)
+{
+	const auto cValue = (value.isTag() ? value.taggedValue() : value);
+	if (value.tag() == QCborKnownTags::DateTimeString)
+		return readDateTime(value, cValue).date();
+	else if (const auto date = IsoDateTime::parseDate(cValue.toString()); date)
+		return *date;
+	else
+		return QDate::fromString(cValue.toString(), Qt::ISODate);
+}
+
+QTime toTime(const QCborValue &value)
+{
+	const auto cValue = (value.isTag() ? value.taggedValue() : value);
+	if (value.tag() == QCborKnownTags::DateTimeString)
+		return readDateTime(value, cValue).time();
+	else if (const auto time = IsoDateTime::parseTime(cValue.toString()); time)
+		return *time;
+	else
+		return QTime::fromString(cValue.toString(), Qt::ISODateWithMs);
+}
+
+}
+
 bool DateTimeConverter::canConvert(int metaTypeId) const
 {
 	static const QSet<int> types {
@@ -19,7 +66,7 @@ QList<QCborTag> DateTimeConverter::allowedCborTags(int metaTypeId) const
 {
 	switch (metaTypeId) {
 	case QMetaType::QDateTime:
-		return {static_cast<QCborTag>(QCborKnownTags::DateTimeString), static_cast<QCborTag>(QCborKnownTags::UnixTime_t)};
+		return {static_cast<QCborTag>(QCborKnownTags::DateTimeString), static_cast<QCborTag>(QCborKnownTags::UnixTime_t), static_cast<QCborTag>(CborSerializer::DateTimeMsecs)};
 	case QMetaType::QDate:
 		return {static_cast<QCborTag>(QCborKnownTags::DateTimeString), static_cast<QCborTag>(CborSerializer::Date)};
 	case QMetaType::QTime:
@@ -30,19 +77,25 @@ QList<QCborTag> DateTimeConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> DateTimeConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask DateTimeConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	switch (tag) {
 	case static_cast<QCborTag>(QCborKnownTags::UnixTime_t):
-		return {QCborValue::Integer};
+	case static_cast<QCborTag>(CborSerializer::DateTimeMsecs):
+		return cborTypeBit(QCborValue::Integer);
 	case static_cast<QCborTag>(QCborKnownTags::DateTimeString):
 	case static_cast<QCborTag>(CborSerializer::Date):
 	case static_cast<QCborTag>(CborSerializer::Time):
-		return {QCborValue::String};
+		return cborTypeBit(QCborValue::String);
 	default:
 		if (metaTypeId == QMetaType::QDateTime)
-			return {QCborValue::String, QCborValue::Integer};
+			return cborTypeMask({QCborValue::String, QCborValue::Integer});
 		else
-			return {QCborValue::String};
+			return cborTypeBit(QCborValue::String);
 	}
 }
 
@@ -55,6 +108,7 @@ int DateTimeConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 		else
 			break;
 	case static_cast<QCborTag>(QCborKnownTags::UnixTime_t):
+	case static_cast<QCborTag>(CborSerializer::DateTimeMsecs):
 		if (dataType == QCborValue::Integer)
 			return QMetaType::QDateTime;
 		else
@@ -77,39 +131,46 @@ int DateTimeConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 }
 
 QCborValue DateTimeConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue DateTimeConverter::serializeRaw(int propertyType, const void *value) const
 {
 	switch (propertyType) {
 	case QMetaType::QDateTime:
-		if (helper()->getProperty("dateAsTimeStamp").toBool())
-			return {QCborKnownTags::UnixTime_t, value.toDateTime().toUTC().toSecsSinceEpoch()};
+		if (helper()->getProperty("dateAsMsecsSinceEpoch").toBool())
+			return {static_cast<QCborTag>(CborSerializer::DateTimeMsecs), static_cast<const QDateTime*>(value)->toMSecsSinceEpoch()};
+		else if (helper()->getProperty("dateAsTimeStamp").toBool())
+			return {QCborKnownTags::UnixTime_t, static_cast<const QDateTime*>(value)->toUTC().toSecsSinceEpoch()};
+		else if (helper()->jsonMode())  // plain string, as QCborValue would parse and reformat a tagged one
+			return QCborValue{IsoDateTime::formatDateTime(*static_cast<const QDateTime*>(value))};
 		else
-			return QCborValue{value.toDateTime()};
+			return QCborValue{*static_cast<const QDateTime*>(value)};
 	case QMetaType::QDate:
-		return {static_cast<QCborTag>(CborSerializer::Date), value.toDate().toString(Qt::ISODate)};
+		return {static_cast<QCborTag>(CborSerializer::Date), IsoDateTime::formatDate(*static_cast<const QDate*>(value))};
 	case QMetaType::QTime:
-		return {static_cast<QCborTag>(CborSerializer::Time), value.toTime().toString(Qt::ISODateWithMs)};
+		return {static_cast<QCborTag>(CborSerializer::Time), IsoDateTime::formatTime(*static_cast<const QTime*>(value))};
 	default:
 		throw SerializationException{"Invalid property type"};
 	}
 }
 
+QJsonValue DateTimeConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant DateTimeConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	Q_UNUSED(parent)
-	const auto cValue = (value.isTag() ? value.taggedValue() : value);
 	switch (propertyType) {
 	case QMetaType::QDateTime:
-		return value.toDateTime();
+		return toDateTime(value);
 	case QMetaType::QDate:
-		if (value.tag() == QCborKnownTags::DateTimeString)
-			return value.toDateTime().date();
-		else
-			return QDate::fromString(cValue.toString(), Qt::ISODate);
+		return toDate(value);
 	case QMetaType::QTime:
-		if (value.tag() == QCborKnownTags::DateTimeString)
-			return value.toDateTime().time();
-		else
-			return QTime::fromString(cValue.toString(), Qt::ISODateWithMs);
+		return toTime(value);
 	default:
 		throw SerializationException{"Invalid property type"};
 	}
@@ -117,9 +178,45 @@ QVariant DateTimeConverter::deserializeCbor(int propertyType, const QCborValue &
 
 QVariant DateTimeConverter::deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const
 {
-	if (propertyType == QMetaType::QDateTime &&
-		value.type() == QCborValue::String)
-		return deserializeCbor(propertyType, {QCborKnownTags::DateTimeString, value}, parent);
+	if (propertyType == QMetaType::QDateTime)
+		return dateTimeFromJson(value);
 	else
 		return deserializeCbor(propertyType, value, parent);
 }
+
+void DateTimeConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
+{
+	Q_UNUSED(parent)
+	switch (propertyType) {
+	case QMetaType::QDateTime:
+		*static_cast<QDateTime*>(target) = helper()->jsonMode() ? dateTimeFromJson(value) : toDateTime(value);
+		break;
+	case QMetaType::QDate:
+		*static_cast<QDate*>(target) = toDate(value);
+		break;
+	case QMetaType::QTime:
+		*static_cast<QTime*>(target) = toTime(value);
+		break;
+	default:
+		throw SerializationException{"Invalid property type"};
+	}
+}
+
+QDateTime DateTimeConverter::dateTimeFromJson(const QCborValue &value) const
+{
+	// JSON has no tags -> restore the one the value was serialized with
+	switch (value.type()) {
+	case QCborValue::String:
+		if (const auto dateTime = IsoDateTime::parseDateTime(value.toString()); dateTime)
+			return *dateTime;
+		else
+			return toDateTime({QCborKnownTags::DateTimeString, value});
+	case QCborValue::Integer:
+		if (helper()->getProperty("dateAsMsecsSinceEpoch").toBool())
+			return toDateTime({static_cast<QCborTag>(CborSerializer::DateTimeMsecs), value});
+		else
+			return toDateTime({QCborKnownTags::UnixTime_t, value});
+	default:
+		return toDateTime(value);
+	}
+}
@@ -31,29 +31,35 @@ bool EnumConverter::canConvert(int metaTypeId) const
 
 QList<QCborTag> EnumConverter::allowedCborTags(int metaTypeId) const
 {
-	const auto metaEnum = getEnum(metaTypeId, false);
-	if (metaEnum.isFlag())
+	const auto descriptor = getDescriptor(metaTypeId, false);
+	if (descriptor->metaEnum.isFlag())
 		return {static_cast<QCborTag>(CborSerializer::Flags)};
 	else
 		return {static_cast<QCborTag>(CborSerializer::Enum)};
 }
 
 QList<QCborValue::Type> EnumConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask EnumConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Integer, QCborValue::String};
+	return cborTypeMask({QCborValue::Integer, QCborValue::String});
 }
 
 QCborValue EnumConverter::serialize(int propertyType, const QVariant &value) const
 {
-	const auto metaEnum = getEnum(propertyType, true);
-	const auto tag = static_cast<QCborTag>(metaEnum.isFlag() ? CborSerializer::Flags : CborSerializer::Enum);
+	const auto descriptor = getDescriptor(propertyType, true);
+	const auto isFlag = descriptor->metaEnum.isFlag();
+	const auto tag = static_cast<QCborTag>(isFlag ? CborSerializer::Flags : CborSerializer::Enum);
 	if (helper()->getProperty("enumAsString").toBool()) {
-		if (metaEnum.isFlag())
-			return {tag, QString::fromUtf8(metaEnum.valueToKeys(value.toInt()))};
+		if (isFlag)
+			return {tag, flagsToKeys(propertyType, *descriptor, value.toInt())};
 		else
-			return {tag, QString::fromUtf8(metaEnum.valueToKey(value.toInt()))};
+			return {tag, descriptor->valueKeys.value(value.toInt())};
 	} else
 		return {tag, value.toInt()};
 }
@@ -61,28 +67,38 @@ QCborValue EnumConverter::serialize(int propertyType, const QVariant &value) con
 QVariant EnumConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	Q_UNUSED(parent)
-	const auto metaEnum = getEnum(propertyType, false);
+	const auto descriptor = getDescriptor(propertyType, false);
+	const auto &metaEnum = descriptor->metaEnum;
 	auto cValue = value.isTag() ? value.taggedValue() : value;
 	if (cValue.isString()) {
+		const auto keys = cValue.toString();
+		// fast path: plain keys, found via the hashed lookup
+		if (const auto fastResult = metaEnum.isFlag() ?
+								   descriptor->keysToValue(keys) :
+								   descriptor->keyToValue(keys);
+			fastResult)
+			return *fastResult;
+
+		// slow path: let QMetaEnum handle scoped keys and produce the error
 		auto result = -1;
 		auto ok = false;
 		if (metaEnum.isFlag())
-			result = metaEnum.keysToValue(qUtf8Printable(cValue.toString()), &ok);
+			result = metaEnum.keysToValue(qUtf8Printable(keys), &ok);
 		else
-			result = metaEnum.keyToValue(qUtf8Printable(cValue.toString()), &ok);
+			result = metaEnum.keyToValue(qUtf8Printable(keys), &ok);
 		if (ok)
 			return result;
-		else if(metaEnum.isFlag() && cValue.toString().isEmpty())
+		else if(metaEnum.isFlag() && keys.isEmpty())
 			return 0;
 		else {
 			throw DeserializationException{QByteArray{"Invalid value for enum type \""} +
 												metaEnum.name() +
 												"\": " +
-												cValue.toString().toUtf8()};
+												keys.toUtf8()};
 		}
 	} else {
 		const auto intValue = cValue.toInteger();
-		if (!metaEnum.isFlag() && metaEnum.valueToKey(intValue) == nullptr) {
+		if (!metaEnum.isFlag() && !descriptor->valueKeys.contains(static_cast<int>(intValue))) {
 			throw DeserializationException{"Invalid integer value. Not a valid enum/flags element: " +
 												QByteArray::number(intValue)};
 		}
@@ -136,3 +152,73 @@ QMetaEnum EnumConverter::getEnum(int metaTypeId, bool ser) const
 
 	return mo->enumerator(mIndex);
 }
+
+QSharedPointer<const EnumConverter::EnumDescriptor> EnumConverter::getDescriptor(int metaTypeId, bool ser) const
+{
+	QReadLocker rLocker{&_cacheLock};
+	if (const auto it = _descriptors.constFind(metaTypeId); it != _descriptors.constEnd())
+		return *it;
+	rLocker.unlock();
+
+	auto descriptor = QSharedPointer<EnumDescriptor>::create();
+	descriptor->metaEnum = getEnum(metaTypeId, ser);
+	const auto &metaEnum = descriptor->metaEnum;
+	descriptor->keys.reserve(metaEnum.keyCount());
+	for (auto i = 0; i < metaEnum.keyCount(); ++i) {
+		const auto key = QString::fromUtf8(metaEnum.key(i));
+		const auto value = metaEnum.value(i);
+		// keep the first key of a value, just like QMetaEnum::valueToKey
+		if (!descriptor->valueKeys.contains(value))
+			descriptor->valueKeys.insert(value, key);
+		// hash collisions are marked with -1 and resolved by the slow path
+		const auto keyHash = qHash(QStringView{key});
+		descriptor->keyIndexes.insert(keyHash, descriptor->keyIndexes.contains(keyHash) ? -1 : descriptor->keys.size());
+		descriptor->keys.append({key, value});
+	}
+
+	QWriteLocker wLocker{&_cacheLock};
+	_descriptors.insert(metaTypeId, descriptor);
+	return descriptor;
+}
+
+QString EnumConverter::flagsToKeys(int metaTypeId, const EnumDescriptor &descriptor, int value) const
+{
+	const QPair<int, int> cacheKey {metaTypeId, value};
+	QReadLocker rLocker{&_cacheLock};
+	if (const auto it = _flagKeys.constFind(cacheKey); it != _flagKeys.constEnd())
+		return *it;
+	rLocker.unlock();
+
+	const auto keys = QString::fromUtf8(descriptor.metaEnum.valueToKeys(value));
+	QWriteLocker wLocker{&_cacheLock};
+	_flagKeys.insert(cacheKey, keys);
+	return keys;
+}
+
+
+
+std::optional<int> EnumConverter::EnumDescriptor::keyToValue(QStringView key) const
+{
+	const auto index = keyIndexes.value(qHash(key), -1);
+	if (index >= 0 && QStringView{keys[index].first} == key)
+		return keys[index].second;
+	else
+		return std::nullopt;
+}
+
+std::optional<int> EnumConverter::EnumDescriptor::keysToValue(QStringView keys) const
+{
+	auto result = 0;
+	qsizetype from = 0;
+	while (from <= keys.size()) {
+		auto to = keys.indexOf(QLatin1Char('|'), from);
+		if (to < 0)
+			to = keys.size();
+		const auto value = keyToValue(keys.mid(from, to - from).trimmed());
+		if (!value)
+			return std::nullopt;
+		result |= *value;
+		from = to + 1;
+	}
+	return result;
+}
@@ -5,6 +5,11 @@
 #include "typeconverter.h"
 
 #include <QtCore/QMetaEnum>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include <optional>
 
 namespace QtJsonSerializer::TypeConverters {
 
@@ -16,13 +21,32 @@ public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
 	QVariant deserializeJson(int propertyType, const QCborValue &value, QObject *parent) const override;
 
 private:
+	using KeyHash = decltype(qHash(QStringView{}));
+
+	struct EnumDescriptor {
+		QMetaEnum metaEnum;
+		QVector<QPair<QString, int>> keys;
+		QHash<KeyHash, int> keyIndexes;
+		QHash<int, QString> valueKeys;
+
+		std::optional<int> keyToValue(QStringView key) const;
+		std::optional<int> keysToValue(QStringView keys) const;
+	};
+
+	mutable QReadWriteLock _cacheLock;
+	mutable QHash<int, QSharedPointer<const EnumDescriptor>> _descriptors;
+	mutable QHash<QPair<int, int>, QString> _flagKeys;
+
 	bool testForEnum(int metaTypeId) const;
 	QMetaEnum getEnum(int metaTypeId, bool ser) const;
+	QSharedPointer<const EnumDescriptor> getDescriptor(int metaTypeId, bool ser) const;
+	QString flagsToKeys(int metaTypeId, const EnumDescriptor &descriptor, int value) const;
 };
 
 }
@@ -1,9 +1,18 @@
 #include "gadgetconverter_p.h"
 #include "exception.h"
 #include "serializerbase_p.h"
+#include "cborserializer.h"
+#include "propertyschema_p.h"
+#include "exceptioncontext_p.h"
+#include "patch_p.h"
+#include "projection_p.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QSet>
+#include <QtCore/QJsonObject>
+
+#include <type_traits>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -24,100 +33,193 @@ bool GadgetConverter::canConvert(int metaTypeId) const
 			flags.testFlag(QMetaType::PointerToGadget);
 }
 
+QList<QCborTag> GadgetConverter::allowedCborTags(int metaTypeId) const
+{
+	Q_UNUSED(metaTypeId)
+	return {
+		NoTag,
+		static_cast<QCborTag>(CborSerializer::PositionalObject)
+	};
+}
+
 QList<QCborValue::Type> GadgetConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask GadgetConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(tag)
 	if (QMetaType(metaTypeId).flags().testFlag(QMetaType::PointerToGadget))
-		return {QCborValue::Map, QCborValue::Null};
+		return cborTypeMask({QCborValue::Map, QCborValue::Array, QCborValue::Null});
 	else
-		return {QCborValue::Map};
+		return cborTypeMask({QCborValue::Map, QCborValue::Array});
 }
 
 QCborValue GadgetConverter::serialize(int propertyType, const QVariant &value) const
 {
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-	const auto metaObject = QMetaType::metaObjectForType(propertyType);
-#else
-	auto metaType = QMetaType(propertyType);
-	const auto metaObject = metaType.metaObject();
-#endif
-
+	const auto metaObject = gadgetMetaObject(propertyType);
 	if (!metaObject)
 		throw SerializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
-	const auto isPtr = QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget);
+	QVariant storage;
+	const auto gadget = readGadget(propertyType, value, storage);
+	if (!gadget)
+		return QCborValue::Null;
 
-	auto gValue = value;
+	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto schema = PropertySchema::get(metaObject, 0, ignoreStoredAttribute);
+	if (helper()->getProperty("positionalEncoding").toBool()) {
+		// write the values in metaobject order, prefixed by the fingerprint of that order
+		auto cborArray = schema.createPositional();
+		for (const auto index : schema.properties) {
+			const auto property = metaObject->property(index);
+			cborArray.append(RawProperty::serialize<QCborValue>(helper(), property, gadget));
+		}
+		return {static_cast<QCborTag>(CborSerializer::PositionalObject), cborArray};
+	}
+
+	return serializeProperties<QCborMap>(metaObject, gadget, schema);
+}
+
+QVariant GadgetConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	Q_UNUSED(parent)  // gadgets neither have nor serve as parent
+	const auto metaObject = gadgetMetaObject(propertyType);
+	if (!metaObject)
+		throw DeserializationException(QByteArray("Unable to get metaobject for gadget type") + QMetaTypeName(propertyType));
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	if (cValue.isNull()) {
+		if (QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget))
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-	if (!gValue.convert(propertyType))
+			return QVariant{propertyType, nullptr};  // initialize an empty (nullptr) variant
 #else
-	if (!gValue.convert(metaType))
+			return QVariant{QMetaType(propertyType), nullptr};  // initialize an empty (nullptr) variant
 #endif
-		throw SerializationException(QByteArray("Data is not of the required gadget type ") + QMetaTypeName(propertyType));
-	const void *gadget = nullptr;
-	if (isPtr) {
-		// with pointers, null gadgets are allowed
-		gadget = *reinterpret_cast<const void* const *>(gValue.constData());
-		if (!gadget)
-			return QCborValue::Null;
-	} else
-		gadget = gValue.constData();
+		else
+			return QVariant{};  // return to allow default null for gadgets. If not allowed, this will fail, as a null variant cannot be converted to a gadget
+	}
+
+	void *gadgetPtr = nullptr;
+	auto gadget = createGadget(propertyType, metaObject, gadgetPtr);
+	if (cValue.isArray())
+		deserializePositional(metaObject, gadgetPtr, cValue.toArray());
+	else
+		deserializeProperties(metaObject, gadgetPtr, cValue.toMap());
+	return gadget;
+}
+
+QJsonValue GadgetConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	// positional data is tagged, which only the CBOR path takes care of
+	if (helper()->getProperty("positionalEncoding").toBool())
+		return TypeConverter::serializeJsonValue(propertyType, value);
+
+	const auto metaObject = gadgetMetaObject(propertyType);
+	if (!metaObject)
+		throw SerializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
+	QVariant storage;
+	const auto gadget = readGadget(propertyType, value, storage);
 	if (!gadget)
-		throw SerializationException(QByteArray("Unable to get address of gadget ") + QMetaTypeName(propertyType));
+		return QJsonValue::Null;
 
-	QCborMap cborMap;
-	//go through all properties and try to serialize them
 	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
-	for (auto i = 0; i < metaObject->propertyCount(); i++) {
-		auto property = metaObject->property(i);
-		if (ignoreStoredAttribute || property.isStored())
-			cborMap[QString::fromUtf8(property.name())] = helper()->serializeSubtype(property, property.readOnGadget(gadget));
+	const auto schema = PropertySchema::get(metaObject, 0, ignoreStoredAttribute);
+	return serializeProperties<QJsonObject>(metaObject, gadget, schema);
+}
+
+QVariant GadgetConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	if (!value.isObject())
+		return TypeConverter::deserializeJsonValue(propertyType, value, parent);
+
+	const auto metaObject = gadgetMetaObject(propertyType);
+	if (!metaObject)
+		throw DeserializationException(QByteArray("Unable to get metaobject for gadget type") + QMetaTypeName(propertyType));
+	void *gadgetPtr = nullptr;
+	auto gadget = createGadget(propertyType, metaObject, gadgetPtr);
+	deserializeProperties(metaObject, gadgetPtr, value.toObject());
+	return gadget;
+}
+
+void GadgetConverter::deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	const auto metaObject = gadgetMetaObject(propertyType);
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	void *gadgetPtr = nullptr;
+	if (metaObject && !cValue.isNull()) {
+		// data() detaches the variant, so only the target is modified
+		if (QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget))
+			gadgetPtr = *reinterpret_cast<void**>(target.data());
+		else
+			gadgetPtr = target.data();
+	}
+	if (!gadgetPtr) {
+		TypeConverter::deserializeInto(propertyType, target, value, parent);
+		return;
 	}
 
-	return cborMap;
+	if (cValue.isArray())
+		deserializePositional(metaObject, gadgetPtr, cValue.toArray(), true);
+	else
+		deserializeProperties(metaObject, gadgetPtr, cValue.toMap(), true);
 }
 
-QVariant GadgetConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+const QMetaObject *GadgetConverter::gadgetMetaObject(int propertyType) const
 {
-	Q_UNUSED(parent)  // gadgets neither have nor serve as parent
-	const auto isPtr = QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return QMetaType::metaObjectForType(propertyType);
+#else
+	return QMetaType(propertyType).metaObject();
+#endif
+}
 
+const void *GadgetConverter::readGadget(int propertyType, const QVariant &value, QVariant &storage) const
+{
+	storage = value;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        const auto metaObject = QMetaType::metaObjectForType(propertyType);
+	if (!storage.convert(propertyType))
 #else
-        auto metaType = QMetaType(propertyType);
-        const auto metaObject = metaType.metaObject();
+	if (!storage.convert(QMetaType(propertyType)))
 #endif
-	
-	if (!metaObject)
-		throw DeserializationException(QByteArray("Unable to get metaobject for gadget type") + QMetaTypeName(propertyType));
+		throw SerializationException(QByteArray("Data is not of the required gadget type ") + QMetaTypeName(propertyType));
 
-	auto cValue = value.isTag() ? value.taggedValue() : value;
+	if (QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget)) {
+		// with pointers, null gadgets are allowed
+		return *reinterpret_cast<const void* const *>(storage.constData());
+	} else if (const auto gadget = storage.constData(); gadget)
+		return gadget;
+	else
+		throw SerializationException(QByteArray("Unable to get address of gadget ") + QMetaTypeName(propertyType));
+}
+
+QVariant GadgetConverter::createGadget(int propertyType, const QMetaObject *metaObject, void *&gadgetPtr) const
+{
 	QVariant gadget;
-	void *gadgetPtr = nullptr;
-	if (isPtr) {
-		if (cValue.isNull())
+	if (QMetaType(propertyType).flags().testFlag(QMetaType::PointerToGadget)) {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-			return QVariant{propertyType, nullptr};  // initialize an empty (nullptr) variant
 		const auto gadgetType = QMetaType::type(metaObject->className());
 		if (gadgetType == QMetaType::UnknownType)
 			throw DeserializationException(QByteArray("Unable to get type of gadget from gadget-pointer type") + QMetaTypeName(propertyType));
-		gadgetPtr = QMetaType::create(gadgetType);
+		if (const auto factory = helper()->instanceFactory(metaObject); factory)
+			gadgetPtr = factory->createGadget(metaObject, gadgetType);
+		else
+			gadgetPtr = QMetaType::create(gadgetType);
 		gadget = QVariant{propertyType, &gadgetPtr};
 #else
-			return QVariant{metaType, nullptr};  // initialize an empty (nullptr) variant
 		auto gadgetMetaType = QMetaType::fromName(metaObject->className());
 		if (!gadgetMetaType.isValid())
 			throw DeserializationException(QByteArray("Unable to get type of gadget from gadget-pointer type") + QMetaTypeName(propertyType));
-		gadgetPtr = gadgetMetaType.create();
-		gadget = QVariant{metaType, &gadgetPtr};
+		if (const auto factory = helper()->instanceFactory(metaObject); factory)
+			gadgetPtr = factory->createGadget(metaObject, gadgetMetaType.id());
+		else
+			gadgetPtr = gadgetMetaType.create();
+		gadget = QVariant{QMetaType(propertyType), &gadgetPtr};
 #endif
 	} else {
-		if (cValue.isNull())
-			return QVariant{};  // return to allow default null for gadgets. If not allowed, this will fail, as a null variant cannot be converted to a gadget
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 		gadget = QVariant{propertyType, nullptr};
 #else
-		gadget = QVariant{metaType, nullptr};
+		gadget = QVariant{QMetaType(propertyType), nullptr};
 #endif
 		gadgetPtr = gadget.data();
 	}
@@ -127,43 +229,157 @@ QVariant GadgetConverter::deserializeCbor(int propertyType, const QCborValue &va
 											QMetaTypeName(propertyType) +
 											QByteArray(". Does it have a default constructor?"));
 	}
+	return gadget;
+}
 
+template <typename TMap>
+TMap GadgetConverter::serializeProperties(const QMetaObject *metaObject, const void *gadget, const PropertySchema &schema) const
+{
+	TMap map;
+	//go through all properties and try to serialize them, reusing the names decoded by the schema
+	for (auto i = 0; i < schema.properties.size(); i++) {
+		const auto property = metaObject->property(schema.properties[i]);
+		if constexpr (std::is_same_v<TMap, QJsonObject>)
+			map[schema.names[i]] = RawProperty::serialize<QJsonValue>(helper(), property, gadget);
+		else
+			map[schema.names[i]] = RawProperty::serialize<QCborValue>(helper(), property, gadget);
+	}
+	return map;
+}
+
+template <typename TMap>
+void GadgetConverter::deserializeProperties(const QMetaObject *metaObject, void *gadgetPtr, const TMap &value, bool inPlace) const
+{
 	const auto validationFlags = helper()->getProperty("validationFlags").value<SerializerBase::ValidationFlags>();
 	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto projection = ProjectionContext::current();
 
-	// collect required properties, if set
+	// collect required properties, if set (only the projected ones are required, and none for merge patches)
 	QSet<QByteArray> reqProps;
-	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties)) {
+	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties) && !MergePatchContext::isActive()) {
 		for (auto i = 0; i < metaObject->propertyCount(); i++) {
 			auto property = metaObject->property(i);
-			if (ignoreStoredAttribute || property.isStored())
+			if ((ignoreStoredAttribute || property.isStored()) &&
+				projection->select(QString::fromUtf8(property.name())))
 				reqProps.insert(property.name());
 		}
 	}
 
 	// now deserialize all json properties
-	const auto cborMap = cValue.toMap();
-	for (auto it = cborMap.constBegin(); it != cborMap.constEnd(); it++) {
-		const auto key = it.key().toString().toUtf8();
+	for (auto it = value.constBegin(); it != value.constEnd(); it++) {
+		QString name;
+		if constexpr (std::is_same_v<TMap, QJsonObject>)
+			name = it.key();
+		else
+			name = it.key().toString();
+		// not projected -> skip without constructing anything
+		const auto selected = projection->select(name);
+		if (!selected)
+			continue;
+		ProjectionContext _{selected};
+
+		const auto key = name.toUtf8();
 		const auto propIndex = metaObject->indexOfProperty(key);
 		if (propIndex != -1) {
 			const auto property = metaObject->property(propIndex);
-			property.writeOnGadget(gadgetPtr, helper()->deserializeSubtype(property, it.value(), nullptr));
+			if constexpr (std::is_same_v<TMap, QJsonObject>)
+				writeProperty(gadgetPtr, property, helper()->deserializeJsonSubtype(property, it.value(), nullptr));
+			else if (inPlace)
+				updateProperty(gadgetPtr, property, it.value());
+			else
+				deserializeProperty(gadgetPtr, property, it.value());
 			reqProps.remove(property.name());
 		} else if (validationFlags.testFlag(SerializerBase::ValidationFlag::NoExtraProperties)) {
-			throw DeserializationException("Found extra property " +
-												key +
-												" but extra properties are not allowed");
+			ErrorSink::fail([key]() {
+				return "Found extra property " +
+					   key +
+					   " but extra properties are not allowed";
+			});
+			return;
 		}
 	}
 
 	// make sure all required properties have been read
 	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties) && !reqProps.isEmpty()) {
-		throw DeserializationException(QByteArray("Not all properties for ") +
-											metaObject->className() +
-											QByteArray(" are present in the json object. Missing properties: ") +
-											reqProps.values().join(", "));
+		ErrorSink::fail([metaObject, reqProps]() {
+			return QByteArray("Not all properties for ") +
+				   metaObject->className() +
+				   QByteArray(" are present in the json object. Missing properties: ") +
+				   reqProps.values().join(", ");
+		});
 	}
+}
 
-	return gadget;
+void GadgetConverter::deserializePositional(const QMetaObject *metaObject, void *gadgetPtr, const QCborArray &value, bool inPlace) const
+{
+	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto schema = PropertySchema::get(metaObject, 0, ignoreStoredAttribute);
+	const auto fingerprint = PropertySchema::fingerprintOf(value);
+	if (fingerprint == schema.fingerprint) {
+		// same schema -> assign by index, all properties are present by definition
+		if (value.size() != static_cast<qsizetype>(schema.properties.size()) + 1) {
+			throw DeserializationException(QByteArray("Positional data does not match the number of properties of ") +
+										   metaObject->className());
+		}
+		const auto projection = ProjectionContext::current();
+		for (auto i = 0; i < schema.properties.size(); ++i) {
+			const auto selected = projection->select(schema.names[i]);
+			if (!selected)
+				continue;
+			ProjectionContext _{selected};
+			const auto property = metaObject->property(schema.properties[i]);
+			if (inPlace)
+				updateProperty(gadgetPtr, property, value[i + 1]);
+			else
+				deserializeProperty(gadgetPtr, property, value[i + 1]);
+		}
+	} else if (const auto knownSchema = PropertySchema::find(metaObject, fingerprint, {0}, ignoreStoredAttribute); knownSchema) {
+		// different, but known schema -> restore the keys and use the keyed path
+		deserializeProperties(metaObject, gadgetPtr, knownSchema->toMap(value), inPlace);
+	} else {
+		throw DeserializationException(QByteArray("Unknown schema fingerprint ") +
+									   QByteArray::number(fingerprint) +
+									   QByteArray(" in positional data for ") +
+									   metaObject->className());
+	}
+}
+
+void GadgetConverter::writeProperty(void *gadgetPtr, const QMetaProperty &property, const QVariant &value)
+{
+	// a failed subtype returns an invalid value in sink mode, which must not replace the property
+	if (!ErrorSink::currentFailed())
+		property.writeOnGadget(gadgetPtr, value);
+}
+
+void GadgetConverter::deserializeProperty(void *gadgetPtr, const QMetaProperty &property, const QCborValue &value) const
+{
+	// deserialize into storage of the property type and write it via the metacall, without a QVariant in between
+	if (RawProperty raw{property}; raw.data()) {
+		if (helper()->deserializeSubtypeRaw(property, value, raw.data(), nullptr)) {
+			raw.writeOnGadget(property, gadgetPtr);
+			return;
+		}
+		if (ErrorSink::currentFailed())
+			return;
+	}
+	writeProperty(gadgetPtr, property, helper()->deserializeSubtype(property, value, nullptr));
+}
+
+void GadgetConverter::updateProperty(void *gadgetPtr, const QMetaProperty &property, const QCborValue &value) const
+{
+	// update a copy and only write it back if it changed
+	const auto current = property.readOnGadget(gadgetPtr);
+	if (MergePatchContext::isActive() && value.isNull()) {
+		// merge patches remove values that are null -> reset the property
+		if (property.isResettable())
+			property.resetOnGadget(gadgetPtr);
+		else if (const auto defaultValue = JsonPatch::defaultValue(property.userType()); defaultValue != current)
+			property.writeOnGadget(gadgetPtr, defaultValue);
+		return;
+	}
+
+	auto updated = current;
+	helper()->deserializeSubtypeInto(property, updated, value, nullptr);
+	if (!ErrorSink::currentFailed() && updated != current)
+		property.writeOnGadget(gadgetPtr, updated);
 }
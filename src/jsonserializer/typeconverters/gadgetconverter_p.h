@@ -4,6 +4,10 @@
 #include "qtjsonserializer_global.h"
 #include "typeconverter.h"
 
+namespace QtJsonSerializer {
+class PropertySchema;
+}
+
 namespace QtJsonSerializer::TypeConverters {
 
 class Q_JSONSERIALIZER_EXPORT GadgetConverter : public TypeConverter
@@ -11,9 +15,28 @@ class Q_JSONSERIALIZER_EXPORT GadgetConverter : public TypeConverter
 public:
 	QT_JSONSERIALIZER_TYPECONVERTER_NAME(GadgetConverter)
 	bool canConvert(int metaTypeId) const override;
+	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+	QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const override;
+	QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const override;
+	void deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const override;
+
+private:
+	const QMetaObject *gadgetMetaObject(int propertyType) const;
+	const void *readGadget(int propertyType, const QVariant &value, QVariant &storage) const;
+	QVariant createGadget(int propertyType, const QMetaObject *metaObject, void *&gadgetPtr) const;
+
+	template <typename TMap>
+	TMap serializeProperties(const QMetaObject *metaObject, const void *gadget, const PropertySchema &schema) const;
+	template <typename TMap>
+	void deserializeProperties(const QMetaObject *metaObject, void *gadgetPtr, const TMap &value, bool inPlace = false) const;
+	void deserializePositional(const QMetaObject *metaObject, void *gadgetPtr, const QCborArray &value, bool inPlace = false) const;
+	static void writeProperty(void *gadgetPtr, const QMetaProperty &property, const QVariant &value);
+	void deserializeProperty(void *gadgetPtr, const QMetaProperty &property, const QCborValue &value) const;
+	void updateProperty(void *gadgetPtr, const QMetaProperty &property, const QCborValue &value) const;
 };
 
 }
@@ -1,6 +1,7 @@
 #include "geomconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -40,10 +41,15 @@ QList<QCborTag> GeomConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> GeomConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask GeomConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Array};
+	return cborTypeMask({QCborValue::Array});
 }
 
 int GeomConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -65,50 +71,75 @@ int GeomConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 }
 
 QCborValue GeomConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue GeomConverter::serializeRaw(int propertyType, const void *value) const
 {
 	switch (propertyType) {
 	case QMetaType::QSize:
-		return serializeSize(value.toSize());
+		return serializeSize(*static_cast<const QSize*>(value));
 	case QMetaType::QSizeF:
-		return serializeSize(value.toSizeF());
+		return serializeSize(*static_cast<const QSizeF*>(value));
 	case QMetaType::QPoint:
-		return serializePoint(value.toPoint());
+		return serializePoint(*static_cast<const QPoint*>(value));
 	case QMetaType::QPointF:
-		return serializePoint(value.toPointF());
+		return serializePoint(*static_cast<const QPointF*>(value));
 	case QMetaType::QLine:
-		return serializeLine(value.toLine());
+		return serializeLine(*static_cast<const QLine*>(value));
 	case QMetaType::QLineF:
-		return serializeLine(value.toLineF());
+		return serializeLine(*static_cast<const QLineF*>(value));
 	case QMetaType::QRect:
-		return serializeRect(value.toRect());
+		return serializeRect(*static_cast<const QRect*>(value));
 	case QMetaType::QRectF:
-		return serializeRect(value.toRectF());
+		return serializeRect(*static_cast<const QRectF*>(value));
 	default:
 		throw SerializationException{"Invalid type id"};
 	}
 }
 
+QJsonValue GeomConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant GeomConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	auto result = RawValue::construct(propertyType);
+	deserializeRaw(propertyType, value, result.data(), parent);
+	return result;
+}
+
+void GeomConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
 {
 	Q_UNUSED(parent)
 	const auto array = (value.isTag() ? value.taggedValue() : value).toArray();
 	switch (propertyType) {
 	case QMetaType::QSize:
-		return deserializeSize<QSize>(array);
+		*static_cast<QSize*>(target) = deserializeSize<QSize>(array);
+		break;
 	case QMetaType::QSizeF:
-		return deserializeSize<QSizeF>(array);
+		*static_cast<QSizeF*>(target) = deserializeSize<QSizeF>(array);
+		break;
 	case QMetaType::QPoint:
-		return deserializePoint<QPoint>(array);
+		*static_cast<QPoint*>(target) = deserializePoint<QPoint>(array);
+		break;
 	case QMetaType::QPointF:
-		return deserializePoint<QPointF>(array);
+		*static_cast<QPointF*>(target) = deserializePoint<QPointF>(array);
+		break;
 	case QMetaType::QLine:
-		return deserializeLine<QLine>(array);
+		*static_cast<QLine*>(target) = deserializeLine<QLine>(array);
+		break;
 	case QMetaType::QLineF:
-		return deserializeLine<QLineF>(array);
+		*static_cast<QLineF*>(target) = deserializeLine<QLineF>(array);
+		break;
 	case QMetaType::QRect:
-		return deserializeRect<QRect>(array);
+		*static_cast<QRect*>(target) = deserializeRect<QRect>(array);
+		break;
 	case QMetaType::QRectF:
-		return deserializeRect<QRectF>(array);
+		*static_cast<QRectF*>(target) = deserializeRect<QRectF>(array);
+		break;
 	default:
 		throw DeserializationException{"Invalid type id"};
 	}
@@ -26,10 +26,15 @@ bool LegacyGeomConverter::canConvert(int metaTypeId) const
 }
 
 QList<QCborValue::Type> LegacyGeomConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask LegacyGeomConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Map};
+	return cborTypeMask({QCborValue::Map});
 }
 
 QCborValue LegacyGeomConverter::serialize(int propertyType, const QVariant &value) const
@@ -2,12 +2,91 @@
 #include "exception.h"
 #include "cborserializer.h"
 #include "metawriters.h"
+#include "patch_p.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QJsonArray>
+
+#include <type_traits>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 using namespace QtJsonSerializer::MetaWriters;
 
+namespace {
+
+template <typename TList>
+struct ListType {
+	using Type = TList;
+};
+
+// calls func with the ListType of the given list, if it is one of the lists with a direct path
+template <typename TFunc>
+bool visitContiguous(int listType, TFunc &&func)
+{
+	if (listType == QMetaType::QStringList)
+		func(ListType<QStringList>{});
+	else if (listType == QMetaType::QByteArrayList)
+		func(ListType<QByteArrayList>{});
+	else if (listType == qMetaTypeId<QList<int>>())
+		func(ListType<QList<int>>{});
+	else if (listType == qMetaTypeId<QList<double>>())
+		func(ListType<QList<double>>{});
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	else if (listType == qMetaTypeId<QVector<int>>())
+		func(ListType<QVector<int>>{});
+	else if (listType == qMetaTypeId<QVector<double>>())
+		func(ListType<QVector<double>>{});
+#endif
+	else
+		return false;
+	return true;
+}
+
+// the CBOR type that values of TValue are read from without any conversion, or Invalid if there is none
+template <typename TValue>
+constexpr QCborValue::Type plainCborType()
+{
+	if constexpr (std::is_same_v<TValue, QString>)
+		return QCborValue::String;
+	else if constexpr (std::is_same_v<TValue, int>)
+		return QCborValue::Integer;
+	else if constexpr (std::is_same_v<TValue, double>)
+		return QCborValue::Double;
+	else
+		return QCborValue::Invalid;
+}
+
+// reads the value, if it is of exactly the plain type, without any validation or conversion
+template <typename TValue>
+bool readPlain(const QCborValue &value, TValue &target)
+{
+	if (plainCborType<TValue>() == QCborValue::Invalid ||
+		value.type() != plainCborType<TValue>())
+		return false;
+	if constexpr (std::is_same_v<TValue, QString>)
+		target = value.toString();
+	else if constexpr (std::is_same_v<TValue, int>)
+		target = static_cast<int>(value.toInteger());
+	else if constexpr (std::is_same_v<TValue, double>)
+		target = value.toDouble();
+	return true;
+}
+
+template <typename TValue>
+bool readPlain(const QJsonValue &value, TValue &target)
+{
+	// numbers are classified like the regular path does, which converts them to CBOR first
+	if constexpr (std::is_same_v<TValue, QString>) {
+		if (!value.isString())
+			return false;
+		target = value.toString();
+		return true;
+	} else
+		return readPlain(QCborValue::fromJsonValue(value), target);
+}
+
+}
+
 bool ListConverter::canConvert(int metaTypeId) const
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -32,13 +111,106 @@ QList<QCborTag> ListConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> ListConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask ListConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Array};
+	return cborTypeMask({QCborValue::Array});
 }
 
 QCborValue ListConverter::serialize(int propertyType, const QVariant &value) const
+{
+	if (value.userType() == propertyType) {
+		if (auto array = serializeContiguous(propertyType, value.constData()); array)
+			return *std::move(array);
+	}
+	return serializeIterable(propertyType, value);
+}
+
+QCborValue ListConverter::serializeRaw(int propertyType, const void *value) const
+{
+	if (auto array = serializeContiguous(propertyType, value); array)
+		return *std::move(array);
+	else
+		return serializeIterable(propertyType, RawValue::box(propertyType, value));
+}
+
+QVariant ListConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	const auto array = (value.isTag() ? value.taggedValue() : value).toArray();
+	if (auto list = deserializeContiguous(propertyType, array, parent); list)
+		return *std::move(list);
+
+	//generate the list
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QVariant list{propertyType, nullptr};
+#else
+	QVariant list{QMetaType(propertyType), nullptr};
+#endif
+	ScopedSequentialWriter writer{list};
+	if (!writer) {
+		throw DeserializationException(QByteArray("Given type ") +
+											QMetaTypeName(propertyType) +
+											QByteArray(" cannot be accessed via QSequentialWriter - make shure to register it via QJsonSerializerBase::registerListConverters or QJsonSerializerBase::registerSetConverters"));
+	}
+
+	const auto info = writer->info();
+	auto index = 0;
+	writer->reserve(static_cast<int>(array.size()));
+	for (auto element : array)
+		writer->add(helper()->deserializeSubtype(info.type, element, parent, "[" + QByteArray::number(index++) + "]"));
+	return list;
+}
+
+QJsonValue ListConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	if (value.userType() == propertyType) {
+		if (auto array = serializeJsonContiguous(propertyType, value.constData()); array)
+			return *std::move(array);
+	}
+	return serializeJsonIterable(propertyType, value);
+}
+
+QJsonValue ListConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	if (auto array = serializeJsonContiguous(propertyType, value); array)
+		return *std::move(array);
+	else
+		return serializeJsonIterable(propertyType, RawValue::box(propertyType, value));
+}
+
+QVariant ListConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	const auto array = value.toArray();
+	if (auto list = deserializeContiguous(propertyType, array, parent); list)
+		return *std::move(list);
+
+	//generate the list
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QVariant list{propertyType, nullptr};
+#else
+	QVariant list{QMetaType(propertyType), nullptr};
+#endif
+	ScopedSequentialWriter writer{list};
+	if (!writer) {
+		throw DeserializationException(QByteArray("Given type ") +
+											QMetaTypeName(propertyType) +
+											QByteArray(" cannot be accessed via QSequentialWriter - make shure to register it via QJsonSerializerBase::registerListConverters or QJsonSerializerBase::registerSetConverters"));
+	}
+
+	const auto info = writer->info();
+	auto index = 0;
+	writer->reserve(static_cast<int>(array.size()));
+	for (const auto element : array)
+		writer->add(helper()->deserializeJsonSubtype(info.type, element, parent, "[" + QByteArray::number(index++) + "]"));
+	return list;
+}
+
+QCborValue ListConverter::serializeIterable(int propertyType, const QVariant &value) const
 {
 	const auto info = SequentialWriter::getInfo(propertyType);
 
@@ -62,26 +234,123 @@ QCborValue ListConverter::serialize(int propertyType, const QVariant &value) con
 		return array;
 }
 
-QVariant ListConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+QJsonValue ListConverter::serializeJsonIterable(int propertyType, const QVariant &value) const
 {
-	//generate the list
+	const auto info = SequentialWriter::getInfo(propertyType);
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-	QVariant list{propertyType, nullptr};
+	if (!value.canConvert(QMetaType::QVariantList)) {
 #else
-	QVariant list{QMetaType(propertyType), nullptr};
+	if (!value.canConvert(QMetaType(QMetaType::QVariantList))) {
+#endif
+		throw SerializationException(QByteArray("Given type ") +
+										  QMetaTypeName(propertyType) +
+										  QByteArray(" cannot be processed via QSequentialIterable - make shure to register the container type via Q_DECLARE_SEQUENTIAL_CONTAINER_METATYPE"));
+	}
+
+	// sets are written as plain arrays, as JSON has no tags
+	QJsonArray array;
+	auto index = 0;
+	for (const auto &element : value.value<QSequentialIterable>())
+		array.append(helper()->serializeJsonSubtype(info.type, element, "[" + QByteArray::number(index++) + "]"));
+	return array;
+}
+
+void ListConverter::deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	// keep the current elements, so they can be updated by index instead of being recreated
+	const auto info = SequentialWriter::getInfo(propertyType);
+	QVariantList elements;
+	if (!info.isSet) {
+		for (const auto &element : target.value<QSequentialIterable>())
+			elements.append(element);
+	}
+
+	// empty the container, or start over with a fresh one if its writer cannot clear it
+	auto cleared = true;
+	if (ScopedSequentialWriter cleaner{target}; cleaner)
+		cleared = cleaner->clear();
+	if (!cleared) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+		target = QVariant{propertyType, nullptr};
+#else
+		target = QVariant{QMetaType(propertyType), nullptr};
 #endif
-	auto writer = SequentialWriter::getWriter(list);
+	}
+	ScopedSequentialWriter writer{target};
 	if (!writer) {
 		throw DeserializationException(QByteArray("Given type ") +
 											QMetaTypeName(propertyType) +
 											QByteArray(" cannot be accessed via QSequentialWriter - make shure to register it via QJsonSerializerBase::registerListConverters or QJsonSerializerBase::registerSetConverters"));
 	}
 
-	const auto info = writer->info();
+	// refill the container. Merge patches replace arrays as a whole, so their elements are not merged
 	const auto array = (value.isTag() ? value.taggedValue() : value).toArray();
-	auto index = 0;
+	MergePatchContext _{false};
 	writer->reserve(static_cast<int>(array.size()));
-	for (auto element : array)
-		writer->add(helper()->deserializeSubtype(info.type, element, parent, "[" + QByteArray::number(index++) + "]"));
-	return list;
+	for (auto index = 0; index < array.size(); ++index) {
+		auto element = index < elements.size() ? std::move(elements[index]) : QVariant{};
+		helper()->deserializeSubtypeInto(info.type, element, array[index], parent, "[" + QByteArray::number(index) + "]");
+		writer->add(std::move(element));
+	}
+}
+
+std::optional<QCborArray> ListConverter::serializeContiguous(int propertyType, const void *value) const
+{
+	std::optional<QCborArray> array;
+	visitContiguous(propertyType, [&](auto listType) {
+		using TList = typename decltype(listType)::Type;
+		const auto serializer = helper()->subtypeSerializer(qMetaTypeId<typename TList::value_type>());
+		array.emplace();
+		for (const auto &element : *static_cast<const TList*>(value))
+			array->append(serializer(&element));
+	});
+	return array;
+}
+
+std::optional<QJsonArray> ListConverter::serializeJsonContiguous(int propertyType, const void *value) const
+{
+	std::optional<QJsonArray> array;
+	visitContiguous(propertyType, [&](auto listType) {
+		using TList = typename decltype(listType)::Type;
+		const auto serializer = helper()->jsonSubtypeSerializer(qMetaTypeId<typename TList::value_type>());
+		array.emplace();
+		for (const auto &element : *static_cast<const TList*>(value))
+			array->append(serializer(&element));
+	});
+	return array;
+}
+
+template<typename TArray>
+std::optional<QVariant> ListConverter::deserializeContiguous(int propertyType, const TArray &array, QObject *parent) const
+{
+	// elements are appended to the typed list, instead of one by one via a SequentialWriter
+	std::optional<QVariant> result;
+	visitContiguous(propertyType, [&](auto listType) {
+		using TList = typename decltype(listType)::Type;
+		using TValue = typename TList::value_type;
+		const auto elementType = qMetaTypeId<TValue>();
+		// elements of the exact basic type need neither a converter nor a QVariant
+		const auto plainType = plainCborType<TValue>();
+		const auto isPlain = plainType != QCborValue::Invalid &&
+							 helper()->isPlainSubtype(elementType, plainType);
+		TList list;
+		list.reserve(static_cast<int>(array.size()));
+		auto index = 0;
+		for (const auto element : array) {
+			if (TValue value; isPlain && readPlain(element, value)) {
+				list.append(std::move(value));
+				++index;
+				continue;
+			}
+
+			const auto traceHint = "[" + QByteArray::number(index++) + "]";
+			if constexpr (std::is_same_v<TArray, QJsonArray>)
+				list.append(helper()->deserializeJsonSubtype(elementType, element, parent, traceHint).template value<TValue>());
+			else
+				list.append(helper()->deserializeSubtype(elementType, element, parent, traceHint).template value<TValue>());
+		}
+		result = QVariant::fromValue(list);
+	});
+	return result;
 }
@@ -4,6 +4,11 @@
 #include "qtjsonserializer_global.h"
 #include "typeconverter.h"
 
+#include <QtCore/QCborArray>
+#include <QtCore/QJsonArray>
+
+#include <optional>
+
 namespace QtJsonSerializer::TypeConverters {
 
 class Q_JSONSERIALIZER_EXPORT ListConverter : public TypeConverter
@@ -13,8 +18,24 @@ public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
+	QCborValue serializeRaw(int propertyType, const void *value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+	QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const override;
+	QJsonValue serializeJsonRaw(int propertyType, const void *value) const override;
+	QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const override;
+	void deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const override;
+
+private:
+	QCborValue serializeIterable(int propertyType, const QVariant &value) const;
+	QJsonValue serializeJsonIterable(int propertyType, const QVariant &value) const;
+
+	// direct paths for lists of primitives and strings, without a QVariant per element
+	std::optional<QCborArray> serializeContiguous(int propertyType, const void *value) const;
+	std::optional<QJsonArray> serializeJsonContiguous(int propertyType, const void *value) const;
+	template <typename TArray>
+	std::optional<QVariant> deserializeContiguous(int propertyType, const TArray &array, QObject *parent) const;
 };
 
 }
@@ -1,6 +1,7 @@
 #include "localeconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QLocale>
 using namespace QtJsonSerializer;
@@ -21,10 +22,15 @@ QList<QCborTag> LocaleConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> LocaleConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask LocaleConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::String};
+	return cborTypeMask({QCborValue::String});
 }
 
 int LocaleConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -34,27 +40,41 @@ int LocaleConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
 }
 
 QCborValue LocaleConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue LocaleConverter::serializeRaw(int propertyType, const void *value) const
 {
 	Q_UNUSED(propertyType)
 	if (helper()->getProperty("useBcp47Locale").toBool())
-		return {static_cast<QCborTag>(CborSerializer::LocaleBCP47), value.toLocale().bcp47Name()};
+		return {static_cast<QCborTag>(CborSerializer::LocaleBCP47), static_cast<const QLocale*>(value)->bcp47Name()};
 	else
-		return {static_cast<QCborTag>(CborSerializer::LocaleISO), value.toLocale().name()};
+		return {static_cast<QCborTag>(CborSerializer::LocaleISO), static_cast<const QLocale*>(value)->name()};
+}
+
+QJsonValue LocaleConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
 }
 
 QVariant LocaleConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	auto result = RawValue::construct(propertyType);
+	deserializeRaw(propertyType, value, result.data(), parent);
+	return result;
+}
+
+void LocaleConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
 {
 	Q_UNUSED(propertyType)
 	Q_UNUSED(parent)
 
 	const auto strValue = (value.isTag() ? value.taggedValue() : value).toString();
 	QLocale locale{strValue};
-	if (locale == QLocale::c()) {
-		if (strValue.toUpper() == QLatin1Char('C') ||
-			strValue.isEmpty())
-			return QLocale::c();
-		else
-			throw DeserializationException("String cannot be interpreted as locale");
-	} else
-		return locale;
+	if (locale == QLocale::c() &&
+		strValue.toUpper() != QLatin1Char('C') &&
+		!strValue.isEmpty())
+		throw DeserializationException("String cannot be interpreted as locale");
+	*static_cast<QLocale*>(target) = std::move(locale);
 }
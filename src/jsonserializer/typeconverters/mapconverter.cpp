@@ -2,8 +2,11 @@
 #include "exception.h"
 #include "cborserializer.h"
 #include "metawriters.h"
+#include "patch_p.h"
+#include "projection_p.h"
 
 #include <QtCore/QJsonObject>
+#include <QtCore/QCborMap>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 using namespace QtJsonSerializer::MetaWriters;
@@ -32,10 +35,15 @@ QList<QCborTag> MapConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> MapConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask MapConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Map};
+	return cborTypeMask({QCborValue::Map});
 }
 
 QCborValue MapConverter::serialize(int propertyType, const QVariant &value) const
@@ -74,7 +82,7 @@ QVariant MapConverter::deserializeCbor(int propertyType, const QCborValue &value
 #else
 	QVariant map{QMetaType(propertyType), nullptr};
 #endif
-	auto writer = AssociativeWriter::getWriter(map);
+	ScopedAssociativeWriter writer{map};
 	if (!writer) {
 		throw DeserializationException(QByteArray("Given type ") +
 											QMetaTypeName(propertyType) +
@@ -84,10 +92,139 @@ QVariant MapConverter::deserializeCbor(int propertyType, const QCborValue &value
 	// write from cbor into the map
 	const auto info = writer->info();
 	const auto cborMap = (value.isTag() ? value.taggedValue() : value).toMap();
+	const auto projection = ProjectionContext::current();
+	writer->reserve(static_cast<int>(cborMap.size()));
 	for (const auto entry : cborMap) {
-		const QByteArray keyStr = "[" + entry.first.toVariant().toString().toUtf8() + "]";
+		const auto name = entry.first.toVariant().toString();
+		const auto selected = projection->select(name);
+		if (!selected)
+			continue;
+		ProjectionContext _{selected};
+		const QByteArray keyStr = "[" + name.toUtf8() + "]";
 		writer->add(helper()->deserializeSubtype(info.keyType, entry.first, parent, keyStr + ".key"),
 					helper()->deserializeSubtype(info.valueType, entry.second, parent, keyStr + ".value"));
 	}
 	return map;
 }
+
+QJsonValue MapConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	const auto info = AssociativeWriter::getInfo(propertyType);
+
+	// verify is readable
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	if (!value.canConvert(QMetaType::QVariantMap) &&
+		!value.canConvert(QMetaType::QVariantHash)) {
+#else
+	if (!value.canConvert(QMetaType(QMetaType::QVariantMap)) &&
+		!value.canConvert(QMetaType(QMetaType::QVariantHash))) {
+#endif
+		throw SerializationException(QByteArray("Given type ") +
+										  QMetaTypeName(propertyType) +
+										  QByteArray(" cannot be processed via QAssociativeIterable - make shure to register the container type via Q_DECLARE_ASSOCIATIVE_CONTAINER_METATYPE"));
+	}
+
+	// write from map to json, keys are stringified the same way QCborMap::toJsonObject does it
+	const auto iterable = value.value<QAssociativeIterable>();
+	QJsonObject jsonObject;
+	for (auto it = iterable.begin(), end = iterable.end(); it != end; ++it) {
+		const QByteArray keyStr = "[" + it.key().toString().toUtf8() + "]";
+		const auto key = helper()->serializeSubtype(info.keyType, it.key(), keyStr + ".key");
+		QString jsonKey;
+		if (key.isString())
+			jsonKey = key.toString();
+		else if (key.isInteger())
+			jsonKey = QString::number(key.toInteger());
+		else
+			jsonKey = QCborMap{{key, QCborValue{}}}.toJsonObject().constBegin().key();
+		jsonObject.insert(jsonKey, helper()->serializeJsonSubtype(info.valueType, it.value(), keyStr + ".value"));
+	}
+	return jsonObject;
+}
+
+QVariant MapConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	//generate the map
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QVariant map{propertyType, nullptr};
+#else
+	QVariant map{QMetaType(propertyType), nullptr};
+#endif
+	ScopedAssociativeWriter writer{map};
+	if (!writer) {
+		throw DeserializationException(QByteArray("Given type ") +
+											QMetaTypeName(propertyType) +
+											QByteArray(" cannot be accessed via QAssociativeWriter - make shure to register it via QJsonSerializerBase::registerMapConverters"));
+	}
+
+	// write from json into the map
+	const auto info = writer->info();
+	const auto jsonObject = value.toObject();
+	const auto projection = ProjectionContext::current();
+	writer->reserve(static_cast<int>(jsonObject.size()));
+	for (auto it = jsonObject.constBegin(), end = jsonObject.constEnd(); it != end; ++it) {
+		const auto selected = projection->select(it.key());
+		if (!selected)
+			continue;
+		ProjectionContext _{selected};
+		const QByteArray keyStr = "[" + it.key().toUtf8() + "]";
+		writer->add(helper()->deserializeSubtype(info.keyType, it.key(), parent, keyStr + ".key"),
+					helper()->deserializeJsonSubtype(info.valueType, it.value(), parent, keyStr + ".value"));
+	}
+	return map;
+}
+
+void MapConverter::deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	// keep the current entries, so they can be updated by key instead of being recreated
+	QHash<QString, std::pair<QVariant, QVariant>> entries;
+	const auto iterable = target.value<QAssociativeIterable>();
+	for (auto it = iterable.begin(), end = iterable.end(); it != end; ++it)
+		entries.insert(it.key().toString(), {it.key(), it.value()});
+
+	// empty the container, or start over with a fresh one if its writer cannot clear it
+	auto cleared = true;
+	if (ScopedAssociativeWriter cleaner{target}; cleaner)
+		cleared = cleaner->clear();
+	if (!cleared) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+		target = QVariant{propertyType, nullptr};
+#else
+		target = QVariant{QMetaType(propertyType), nullptr};
+#endif
+	}
+	ScopedAssociativeWriter writer{target};
+	if (!writer) {
+		throw DeserializationException(QByteArray("Given type ") +
+											QMetaTypeName(propertyType) +
+											QByteArray(" cannot be accessed via QAssociativeWriter - make shure to register it via QJsonSerializerBase::registerMapConverters"));
+	}
+
+	// refill the map from cbor, so entries missing in the data are removed
+	const auto info = writer->info();
+	const auto cborMap = (value.isTag() ? value.taggedValue() : value).toMap();
+	const auto projection = ProjectionContext::current();
+	const auto isMerge = MergePatchContext::isActive();
+	writer->reserve(static_cast<int>(cborMap.size()));
+	for (const auto entry : cborMap) {
+		const auto name = entry.first.toVariant().toString();
+		const auto selected = projection->select(name);
+		if (!selected)
+			continue;
+		ProjectionContext _{selected};
+		auto element = entries.take(name).second;
+		// merge patches remove entries that are null
+		if (isMerge && entry.second.isNull())
+			continue;
+		const QByteArray keyStr = "[" + name.toUtf8() + "]";
+		helper()->deserializeSubtypeInto(info.valueType, element, entry.second, parent, keyStr + ".value");
+		writer->add(helper()->deserializeSubtype(info.keyType, entry.first, parent, keyStr + ".key"),
+					std::move(element));
+	}
+
+	// merge patches keep all entries they do not mention
+	if (isMerge) {
+		for (auto it = entries.begin(), end = entries.end(); it != end; ++it)
+			writer->add(std::move(it->first), std::move(it->second));
+	}
+}
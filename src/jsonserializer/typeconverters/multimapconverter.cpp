@@ -1,6 +1,7 @@
 #include "multimapconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "projection_p.h"
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
@@ -34,10 +35,15 @@ QList<QCborTag> MultiMapConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> MultiMapConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask MultiMapConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Map, QCborValue::Array};
+	return cborTypeMask({QCborValue::Map, QCborValue::Array});
 }
 
 QCborValue MultiMapConverter::serialize(int propertyType, const QVariant &value) const
@@ -117,7 +123,7 @@ QVariant MultiMapConverter::deserializeCbor(int propertyType, const QCborValue &
 #else
 	QVariant map{QMetaType(propertyType), nullptr};
 #endif
-	auto writer = AssociativeWriter::getWriter(map);
+	ScopedAssociativeWriter writer{map};
 	if (!writer) {
 		throw DeserializationException(QByteArray("Given type ") +
 											QMetaTypeName(propertyType) +
@@ -129,8 +135,14 @@ QVariant MultiMapConverter::deserializeCbor(int propertyType, const QCborValue &
 	const auto cValue = (value.isTag() ? value.taggedValue() : value);
 	switch (cValue.type()) {
 	case QCborValue::Map: {
+		const auto projection = ProjectionContext::current();
 		for (const auto entry : cValue.toMap()) {
-			const QByteArray keyStr = "[" + entry.first.toVariant().toString().toUtf8() + "]";
+			const auto name = entry.first.toVariant().toString();
+			const auto selected = projection->select(name);
+			if (!selected)
+				continue;
+			ProjectionContext _{selected};
+			const QByteArray keyStr = "[" + name.toUtf8() + "]";
 			const auto key = helper()->deserializeSubtype(info.keyType, entry.first, parent, keyStr + ".key");
 			if (entry.second.isArray()) {
 				auto cnt = 0;
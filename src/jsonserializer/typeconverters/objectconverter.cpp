@@ -1,8 +1,21 @@
 #include "objectconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
-
+#include "propertyschema_p.h"
+#include "exceptioncontext_p.h"
+#include "changetracker_p.h"
+#include "patch_p.h"
+#include "projection_p.h"
+#include "rawvalue_p.h"
+#include "serializerbase_p.h"
+
+#include <algorithm>
 #include <array>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include <QtCore/QJsonObject>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -20,20 +33,27 @@ QList<QCborTag> ObjectConverter::allowedCborTags(int metaTypeId) const
 	return {
 		NoTag,
 		static_cast<QCborTag>(CborSerializer::GenericObject),
-		static_cast<QCborTag>(CborSerializer::ConstructedObject)
+		static_cast<QCborTag>(CborSerializer::ConstructedObject),
+		static_cast<QCborTag>(CborSerializer::PositionalObject)
 	};
 }
 
 QList<QCborValue::Type> ObjectConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask ObjectConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	switch (static_cast<quint64>(tag)) {
 	case CborSerializer::GenericObject:
-		return {QCborValue::Array};
+		return cborTypeBit(QCborValue::Array);
 	case CborSerializer::ConstructedObject:
-		return {QCborValue::Array, QCborValue::Null};
+	case CborSerializer::PositionalObject:
+		return cborTypeMask({QCborValue::Array, QCborValue::Null});
 	default:
-		return {QCborValue::Map, QCborValue::Null};
+		return cborTypeMask({QCborValue::Map, QCborValue::Array, QCborValue::Null});
 	}
 }
 
@@ -54,10 +74,165 @@ QCborValue ObjectConverter::serialize(int propertyType, const QVariant &value) c
 	auto object = value.value<QObject*>();
 	if (!object)
 		return QCborValue::Null;
-	QCborMap cborMap;
 
+	const auto [metaObject, isPoly] = serializedClass(propertyType, object);
+	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto schema = PropertySchema::get(metaObject, firstPropertyIndex(), ignoreStoredAttribute);
+	if (const auto tracker = trackSerialized(object); tracker)
+		return serializeChanges<QCborMap>(metaObject, object, schema, isPoly, tracker);
+
+	// everything below a completely serialized object is serialized completely as well
+	const auto trackingMode = ChangeTrackingContext::currentMode();
+	ChangeTrackingContext _{trackingMode == ChangeTrackingContext::Mode::Changes ? ChangeTrackingContext::Mode::Snapshot : trackingMode};
+
+	// positional data has no place for the class name, so polymorphic objects always use a map
+	if (!isPoly && helper()->getProperty("positionalEncoding").toBool()) {
+		auto cborArray = schema.createPositional();
+		for (const auto index : schema.properties) {
+			const auto property = metaObject->property(index);
+			cborArray.append(RawProperty::serialize<QCborValue>(helper(), property, object));
+		}
+		return {static_cast<QCborTag>(CborSerializer::PositionalObject), cborArray};
+	}
+
+	return serializeProperties<QCborMap>(metaObject, object, schema, isPoly);
+}
+
+QVariant ObjectConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	if (cValue.isNull())
+		return QVariant::fromValue<QObject*>(nullptr);
+
+	if (value.isTag()) {
+		if (value.tag() == static_cast<QCborTag>(CborSerializer::GenericObject))
+			return QVariant::fromValue(trackDeserialized(deserializeGenericObject(cValue.toArray(), parent)));
+		else if (value.tag() == static_cast<QCborTag>(CborSerializer::ConstructedObject))
+			return QVariant::fromValue(trackDeserialized(deserializeConstructedObject(cValue, parent)));
+	}
+
+	auto metaObject = QMetaType(propertyType).metaObject();
+	if (!metaObject)
+		throw DeserializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
+
+	// positional data is never polymorphic -> construct the property type directly
+	if (cValue.isArray()) {
+		auto poly = static_cast<SerializerBase::Polymorphing>(helper()->getProperty("polymorphing").toInt());
+		if (poly == SerializerBase::Polymorphing::Forced)
+			throw DeserializationException("Positional data does not contain the class name, but forced polymorphism requires it");
+		auto object = createObject(metaObject, parent, [&](QObject *object) {
+			deserializePositional(metaObject, object, cValue.toArray());
+		});
+		return QVariant::fromValue(trackDeserialized(object));
+	}
+
+	return QVariant::fromValue(trackDeserialized(deserializeMap(propertyType, metaObject, cValue.toMap(), parent)));
+}
+
+QJsonValue ObjectConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	auto object = value.value<QObject*>();
+	if (!object)
+		return QJsonValue::Null;
+
+	const auto [metaObject, isPoly] = serializedClass(propertyType, object);
+	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto schema = PropertySchema::get(metaObject, firstPropertyIndex(), ignoreStoredAttribute);
+	if (const auto tracker = trackSerialized(object); tracker)
+		return serializeChanges<QJsonObject>(metaObject, object, schema, isPoly, tracker);
+
+	const auto trackingMode = ChangeTrackingContext::currentMode();
+	ChangeTrackingContext _{trackingMode == ChangeTrackingContext::Mode::Changes ? ChangeTrackingContext::Mode::Snapshot : trackingMode};
+
+	// positional data is tagged, which only the CBOR path takes care of
+	if (!isPoly && helper()->getProperty("positionalEncoding").toBool())
+		return TypeConverter::serializeJsonValue(propertyType, value);
+	return serializeProperties<QJsonObject>(metaObject, object, schema, isPoly);
+}
+
+QVariant ObjectConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	if (!value.isObject())
+		return TypeConverter::deserializeJsonValue(propertyType, value, parent);
+
+	auto metaObject = QMetaType(propertyType).metaObject();
+	if (!metaObject)
+		throw DeserializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
+	return QVariant::fromValue(trackDeserialized(deserializeMap(propertyType, metaObject, value.toObject(), parent)));
+}
+
+void ObjectConverter::deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const
+{
+	// generic and constructed objects depend on their constructor arguments -> always create them anew
+	auto object = target.value<QObject*>();
+	const auto tag = value.isTag() ? value.tag() : NoTag;
+	const auto cValue = value.isTag() ? value.taggedValue() : value;
+	auto poly = static_cast<SerializerBase::Polymorphing>(helper()->getProperty("polymorphing").toInt());
+	if (!object ||
+		cValue.isNull() ||
+		tag == static_cast<QCborTag>(CborSerializer::GenericObject) ||
+		tag == static_cast<QCborTag>(CborSerializer::ConstructedObject) ||
+		(cValue.isArray() && poly == SerializerBase::Polymorphing::Forced)) {
+		TypeConverter::deserializeInto(propertyType, target, value, parent);
+		return;
+	}
+
+	auto metaObject = QMetaType(propertyType).metaObject();
+	if (!metaObject)
+		throw DeserializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
+
+	if (cValue.isArray()) {
+		deserializePositional(metaObject, object, cValue.toArray(), true);
+		trackDeserialized(object);
+		return;
+	}
+
+	// a different class was requested -> the existing object cannot be reused
+	const auto cborMap = cValue.toMap();
+	auto isPoly = false;
+	metaObject = deserializedClass(propertyType, metaObject, cborMap, isPoly);
+	if (isPoly && metaObject != object->metaObject()) {
+		TypeConverter::deserializeInto(propertyType, target, value, parent);
+		return;
+	}
+	deserializeProperties(metaObject, object, cborMap, isPoly, true);
+	trackDeserialized(object);
+}
+
+bool ObjectConverter::polyMetaObject(QObject *object) const
+{
+	//check the internal property
+	if (const auto polyProperty = object->property("__qt_json_serializer_polymorphic"); polyProperty.isValid())
+		return polyProperty.toBool();
+
+	//check the cached class info decision
+	const auto meta = object->metaObject();
+	QReadLocker rLocker{&_cacheLock};
+	if (const auto it = _polyCache.constFind(meta); it != _polyCache.constEnd())
+		return *it;
+	rLocker.unlock();
+
+	//check the class info
+	auto isPoly = false;// default: use the class
+	auto polyIndex = meta->indexOfClassInfo("polymorphic");
+	if (polyIndex != -1) {
+		auto info = meta->classInfo(polyIndex);
+		if (info.value() == QByteArray("true"))
+			isPoly = true;// use the object
+		else if (info.value() == QByteArray("false"))
+			isPoly = false;// use the class
+		else
+			qCWarning(logObjConverter) << "Invalid value for polymorphic classinfo on object type" << meta->className() << "ignored";
+	}
+
+	QWriteLocker wLocker{&_cacheLock};
+	_polyCache.insert(meta, isPoly);
+	return isPoly;
+}
+
+std::pair<const QMetaObject*, bool> ObjectConverter::serializedClass(int propertyType, QObject *object) const
+{
 	// get the metaobject, based on polymorphism
-	const QMetaObject *metaObject = nullptr;
 	auto poly = static_cast<SerializerBase::Polymorphing>(helper()->getProperty("polymorphing").toInt());
 	auto isPoly = false;
 	switch (poly) {
@@ -75,114 +250,109 @@ QCborValue ObjectConverter::serialize(int propertyType, const QVariant &value) c
 		break;
 	}
 
-	if (isPoly) {
-		metaObject = object->metaObject();
-		//first: pass the class name
-		cborMap[QStringLiteral("@class")] = QString::fromUtf8(metaObject->className());
-	} else
-		metaObject = QMetaType(propertyType).metaObject();
+	const auto metaObject = isPoly ? object->metaObject() : QMetaType(propertyType).metaObject();
 	if (!metaObject)
 		throw SerializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
-
-	//go through all properties and try to serialize them
-	const auto keepObjectName = helper()->getProperty("keepObjectName").toBool();
-	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
-	auto i = QObject::staticMetaObject.indexOfProperty("objectName");
-	if (!keepObjectName)
-		i++;
-	for(; i < metaObject->propertyCount(); i++) {
-		auto property = metaObject->property(i);
-		if (ignoreStoredAttribute || property.isStored())
-			cborMap[QString::fromUtf8(property.name())] = helper()->serializeSubtype(property, property.read(object));
-	}
-
-	return cborMap;
+	return {metaObject, isPoly};
 }
 
-QVariant ObjectConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+const QMetaObject *ObjectConverter::findClass(const QString &className) const
 {
-	if ((value.isTag() ? value.taggedValue() : value).isNull())
-		return QVariant::fromValue<QObject*>(nullptr);
+	QReadLocker rLocker{&_cacheLock};
+	if (const auto it = _classCache.constFind(className); it != _classCache.constEnd())
+		return *it;
+	rLocker.unlock();
 
-	QCborMap cborMap;
-	if (value.isTag()) {
-		if (value.tag() == static_cast<QCborTag>(CborSerializer::GenericObject))
-			return QVariant::fromValue(deserializeGenericObject(value.taggedValue().toArray(), parent));
-		else if (value.tag() == static_cast<QCborTag>(CborSerializer::ConstructedObject))
-			return QVariant::fromValue(deserializeConstructedObject(value.taggedValue(), parent));
-		else
-			cborMap = value.taggedValue().toMap();
-	} else
-		cborMap = value.toMap();
-
-	auto poly = static_cast<SerializerBase::Polymorphing>(helper()->getProperty("polymorphing").toInt());
-
-	auto metaObject = QMetaType(propertyType).metaObject();
-	if (!metaObject)
-		throw DeserializationException(QByteArray("Unable to get metaobject for type ") + QMetaTypeName(propertyType));
-
-	// try to get the polymorphic metatype (if allowed)
-	auto isPoly = false;
-	if (poly != SerializerBase::Polymorphing::Disabled) {
-		if (cborMap.contains(QStringLiteral("@class"))) {
-			isPoly = true;
-			QByteArray classField = cborMap[QStringLiteral("@class")].toString().toUtf8() + "*";  // add the star
+	QByteArray classField = className.toUtf8() + "*";  // add the star
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-			auto typeId = QMetaType::type(classField.constData());
-			auto nMeta = QMetaType(typeId).metaObject();
+	auto typeId = QMetaType::type(classField.constData());
+	auto metaObject = QMetaType(typeId).metaObject();
 #else
-			auto metaType = QMetaType::fromName(classField.constData());
-			auto nMeta = metaType.metaObject();
+	auto metaType = QMetaType::fromName(classField.constData());
+	auto metaObject = metaType.metaObject();
 #endif
-			if (!nMeta)
-				throw DeserializationException("Unable to find class requested from json \"@class\" property: " + classField);
-			if (!nMeta->inherits(metaObject)) {
-				throw DeserializationException("Requested class from \"@class\" field, " +
-													classField +
-													QByteArray(", does not inhert the property type ") +
-													QMetaTypeName(propertyType));
-			}
-			metaObject = nMeta;
-		} else if (poly == SerializerBase::Polymorphing::Forced)
-			throw DeserializationException("Json does not contain the \"@class\" field, but forced polymorphism requires it");
+	// only cache hits, as types may still be registered later on
+	if (metaObject) {
+		QWriteLocker wLocker{&_cacheLock};
+		_classCache.insert(className, metaObject);
 	}
+	return metaObject;
+}
 
-	// try to construct the object
-	auto object = metaObject->newInstance(Q_ARG(QObject*, parent));
+int ObjectConverter::firstPropertyIndex() const
+{
+	auto index = QObject::staticMetaObject.indexOfProperty("objectName");
+	if (!helper()->getProperty("keepObjectName").toBool())
+		++index;
+	return index;
+}
+
+QObject *ObjectConverter::createObject(const QMetaObject *metaObject, QObject *parent) const
+{
+	const auto factory = helper()->instanceFactory(metaObject);
+	auto object = factory ?
+					  factory->createObject(metaObject, parent) :
+					  metaObject->newInstance(Q_ARG(QObject*, parent));
 	if (!object) {
 		throw DeserializationException(QByteArray("Failed to construct object of type ") +
 											metaObject->className() +
 											QByteArray(" (Does the constructor \"Q_INVOKABLE class(QObject*);\" exist?)"));
 	}
+	return object;
+}
 
-	deserializeProperties(metaObject, object, cborMap, isPoly);
-	return QVariant::fromValue(object);
+template <typename TFunc>
+QObject *ObjectConverter::createObject(const QMetaObject *metaObject, QObject *parent, const TFunc &deserialize) const
+{
+	// with deferred notifications, objects are only attached to their parent once they are complete
+	if (!parent || !helper()->getProperty("deferNotifications").toBool()) {
+		auto object = createObject(metaObject, parent);
+		deserialize(object);
+		return object;
+	}
+
+	std::unique_ptr<QObject> object{createObject(metaObject, nullptr)};
+	deserialize(object.get());
+	object->setParent(parent);
+	return object.release();
 }
 
-bool ObjectConverter::polyMetaObject(QObject *object) const
+ChangeTracker *ObjectConverter::changeTracker() const
 {
-	auto meta = object->metaObject();
+	return helper()->getProperty("changeTracker").value<ChangeTracker*>();
+}
 
-	//check the internal property
-	if (object->dynamicPropertyNames().contains("__qt_json_serializer_polymorphic")) {
-		auto polyProp = object->property("__qt_json_serializer_polymorphic").toBool();
-		return polyProp;
-	}
+ChangeTracker *ObjectConverter::trackSerialized(QObject *object) const
+{
+	// returns the tracker only if just the changes of the object should be serialized
+	const auto tracker = changeTracker();
+	if (!tracker)
+		return nullptr;
 
-	//check the class info
-	auto polyIndex = meta->indexOfClassInfo("polymorphic");
-	if (polyIndex != -1) {
-		auto info = meta->classInfo(polyIndex);
-		if (info.value() == QByteArray("true"))
-			return true;// use the object
-		else if (info.value() == QByteArray("false"))
-			return false;// use the class
-		else
-			qCWarning(logObjConverter) << "Invalid value for polymorphic classinfo on object type" << meta->className() << "ignored";
+	switch (ChangeTrackingContext::currentMode()) {
+	case ChangeTrackingContext::Mode::Changes:
+		if (tracker->isTracked(object))
+			return tracker;
+		Q_FALLTHROUGH();
+	case ChangeTrackingContext::Mode::Snapshot:
+		tracker->track(object);
+		break;
+	case ChangeTrackingContext::Mode::Track:
+		if (!tracker->isTracked(object))
+			tracker->track(object);
+		break;
+	default:
+		Q_UNREACHABLE();
+		break;
 	}
+	return nullptr;
+}
 
-	//default: the class
-	return false;// use the class
+QObject *ObjectConverter::trackDeserialized(QObject *object) const
+{
+	if (const auto tracker = changeTracker(); tracker && object && !tracker->isTracked(object))
+		tracker->track(object);
+	return object;
 }
 
 QObject *ObjectConverter::deserializeGenericObject(const QCborArray &value, QObject *parent) const
@@ -192,16 +362,27 @@ QObject *ObjectConverter::deserializeGenericObject(const QCborArray &value, QObj
 
 	// find a meta object
 	QByteArray className = value.first().toString().toUtf8() + "*";  // add the star
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-	auto typeId = QMetaType::type(className.constData());
-	auto metaObject = QMetaType(typeId).metaObject();
-#else
-	auto metaType = QMetaType::fromName(className.constData());
-	auto metaObject = metaType.metaObject();
-#endif
+	auto metaObject = findClass(value.first().toString());
 	if (!metaObject)
 		throw DeserializationException("Unable to find class requested from GenericObject tagged array: " + className);
 
+	// check if a constructor was already found for the same class and argument types
+	// registered converters change how arguments deserialize -> plans of older revisions are outdated
+	const ConstructorKey key {metaObject, argumentSignature(value)};
+	const auto revision = SerializerBasePrivate::registryRevision.loadAcquire();
+	std::optional<ConstructorPlan> plan;
+	QReadLocker rLocker{&_cacheLock};
+	if (const auto it = _constructorCache.constFind(key); it != _constructorCache.constEnd() && it->revision == revision)
+		plan = *it;
+	rLocker.unlock();
+	if (plan) {
+		if (auto arguments = tryDeserializeArguments(value, *plan, className); arguments)
+			return constructObject(metaObject, std::move(*arguments), *plan, parent);
+		// data of the same shape might still need different conversions -> search again
+		qCDebug(logObjConverter) << "Cached constructor of" << metaObject->className()
+								 << "does not match the given arguments, searching again";
+	}
+
 	// deserialize all arguments
 	QVariantList arguments;
 	arguments.reserve(static_cast<int>(value.size() - 1));
@@ -212,11 +393,12 @@ QObject *ObjectConverter::deserializeGenericObject(const QCborArray &value, QObj
 	for (auto cIdx = 0; cIdx < metaObject->constructorCount(); ++cIdx) {
 		const auto constructor = metaObject->constructor(cIdx);
 		// verify same argument count (but allow extra QObject argument for parenting)
-		auto extraObj = false;
+		ConstructorPlan nPlan;
+		nPlan.revision = revision;
 		if (constructor.parameterCount() != arguments.size()) {
 			if (constructor.parameterCount() == arguments.size() + 1 &&
 				constructor.parameterType(constructor.parameterCount() - 1) == QMetaType::QObjectStar)
-				extraObj = true;
+				nPlan.appendParent = true;
 			else
 				continue;
 		}
@@ -224,36 +406,33 @@ QObject *ObjectConverter::deserializeGenericObject(const QCborArray &value, QObj
 		// verify each argument can be converted (by converting it)
 		auto argCopy = arguments;
 		auto allOk = true;
+		nPlan.parameterTypes.reserve(argCopy.size());
 		for (auto pIdx = 0; pIdx < argCopy.size(); ++pIdx) {
 			const auto pType = constructor.parameterType(pIdx);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-			if (!argCopy[pIdx].canConvert(pType) || !argCopy[pIdx].convert(pType)) {
-#else
-			if (!argCopy[pIdx].canConvert(QMetaType(pType)) || !argCopy[pIdx].convert(QMetaType(pType))) {
-#endif
+			if (!convertArgument(argCopy[pIdx], pType)) {
 				allOk = false;
 				break;
 			}
+			nPlan.parameterTypes.append(pType);
+			// objects would be created twice when probing -> keep the converted ones
+			if (QMetaType(pType).flags().testFlag(QMetaType::PointerToQObject))
+				nPlan.direct = false;
 		}
 
-		// if all arguments could be converted -> construct the object
+		// if all arguments could be converted -> remember and construct the object
 		if (allOk) {
-			if (extraObj)
-				argCopy.append(QVariant::fromValue(parent));
-			Q_ASSERT(argCopy.size() <= 10);
-
-			std::array<QGenericArgument, 10> gArgs;
-			gArgs.fill(QGenericArgument{});
-			for (auto pIdx = 0; pIdx < argCopy.size(); ++pIdx)
-				gArgs[static_cast<size_t>(pIdx)] = {argCopy[pIdx].typeName(), argCopy[pIdx].constData()};
-			auto object = metaObject->newInstance(gArgs[0], gArgs[1], gArgs[2], gArgs[3], gArgs[4],
-												  gArgs[5], gArgs[6], gArgs[7], gArgs[8], gArgs[9]);
-			if (!object) {
-				throw DeserializationException(QByteArray("Failed to construct object of type ") +
-													metaObject->className() +
-													QByteArray(" - deserialized constructor arguments are potentially invalid!"));
+			// prefer deserializing directly to the parameter types, if that works for this data
+			if (nPlan.direct) {
+				if (auto directArgs = tryDeserializeArguments(value, nPlan, className); directArgs)
+					argCopy = std::move(*directArgs);
+				else
+					nPlan.direct = false;
 			}
-			return object;
+
+			QWriteLocker wLocker{&_cacheLock};
+			_constructorCache.insert(key, nPlan);
+			wLocker.unlock();
+			return constructObject(metaObject, std::move(argCopy), nPlan, parent);
 		}
 	}
 
@@ -264,6 +443,93 @@ QObject *ObjectConverter::deserializeGenericObject(const QCborArray &value, QObj
 										" arguments and matching types!"};
 }
 
+QByteArray ObjectConverter::argumentSignature(const QCborArray &value)
+{
+	QByteArray signature;
+	signature.reserve(static_cast<int>(value.size() * sizeof(quint32)));
+	for (auto aIdx = 1ll; aIdx < value.size(); ++aIdx) {
+		const auto arg = value[aIdx];
+		const auto type = static_cast<quint32>(arg.type());
+		signature.append(reinterpret_cast<const char*>(&type), sizeof(type));
+		if (arg.type() == QCborValue::Tag) {
+			const auto tag = static_cast<quint64>(arg.tag());
+			signature.append(reinterpret_cast<const char*>(&tag), sizeof(tag));
+		}
+	}
+	return signature;
+}
+
+bool ObjectConverter::convertArgument(QVariant &argument, int metaTypeId)
+{
+	if (argument.userType() == metaTypeId)
+		return true;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	return argument.canConvert(metaTypeId) && argument.convert(metaTypeId);
+#else
+	return argument.canConvert(QMetaType(metaTypeId)) && argument.convert(QMetaType(metaTypeId));
+#endif
+}
+
+QVariantList ObjectConverter::deserializeArguments(const QCborArray &value, const ConstructorPlan &plan, const QByteArray &className) const
+{
+	QVariantList arguments;
+	arguments.reserve(plan.parameterTypes.size() + 1);
+	for (auto aIdx = 1ll; aIdx < value.size(); ++aIdx) {
+		const auto pType = plan.parameterTypes[static_cast<int>(aIdx - 1)];
+		auto argument = helper()->deserializeSubtype(plan.direct ? pType : static_cast<int>(QMetaType::UnknownType),
+													 value[aIdx],
+													 nullptr,
+													 className + "[" + QByteArray::number(aIdx - 1) + "]");
+		if (ErrorSink::currentFailed())
+			return {};
+		if (!convertArgument(argument, pType)) {
+			ErrorSink::fail([aIdx, className, pType]() {
+				return "Unable to convert argument " +
+					   QByteArray::number(aIdx - 1) +
+					   " of " +
+					   className +
+					   " to " +
+					   QMetaTypeName(pType);
+			});
+			return {};
+		}
+		arguments.append(std::move(argument));
+	}
+	return arguments;
+}
+
+std::optional<QVariantList> ObjectConverter::tryDeserializeArguments(const QCborArray &value, const ConstructorPlan &plan, const QByteArray &className) const
+{
+	// errors are collected in a separate sink, so they do not fail the whole deserialization
+	ErrorSink argumentSink;
+	try {
+		auto arguments = deserializeArguments(value, plan, className);
+		if (!argumentSink.hasFailed())
+			return arguments;
+	} catch (DeserializationException &) {}
+	return std::nullopt;
+}
+
+QObject *ObjectConverter::constructObject(const QMetaObject *metaObject, QVariantList arguments, const ConstructorPlan &plan, QObject *parent) const
+{
+	if (plan.appendParent)
+		arguments.append(QVariant::fromValue(parent));
+	Q_ASSERT(arguments.size() <= 10);
+
+	std::array<QGenericArgument, 10> gArgs;
+	gArgs.fill(QGenericArgument{});
+	for (auto pIdx = 0; pIdx < arguments.size(); ++pIdx)
+		gArgs[static_cast<size_t>(pIdx)] = {arguments[pIdx].typeName(), arguments[pIdx].constData()};
+	auto object = metaObject->newInstance(gArgs[0], gArgs[1], gArgs[2], gArgs[3], gArgs[4],
+										  gArgs[5], gArgs[6], gArgs[7], gArgs[8], gArgs[9]);
+	if (!object) {
+		throw DeserializationException(QByteArray("Failed to construct object of type ") +
+											metaObject->className() +
+											QByteArray(" - deserialized constructor arguments are potentially invalid!"));
+	}
+	return object;
+}
+
 QObject *ObjectConverter::deserializeConstructedObject(const QCborValue &value, QObject *parent) const
 {
 	if (value.isNull())
@@ -281,21 +547,148 @@ QObject *ObjectConverter::deserializeConstructedObject(const QCborValue &value,
 	return object;
 }
 
-void ObjectConverter::deserializeProperties(const QMetaObject *metaObject, QObject *object, const QCborMap &value, bool isPoly) const
+template <typename TMap>
+void ObjectConverter::serializeClass(TMap &map, const QMetaObject *metaObject) const
+{
+	if (const auto classId = helper()->classId(metaObject); classId >= 0)
+		map[QStringLiteral("@class")] = classId;
+	else
+		map[QStringLiteral("@class")] = QLatin1String{metaObject->className()};
+}
+
+template <typename TMap>
+TMap ObjectConverter::serializeProperties(const QMetaObject *metaObject, QObject *object, const PropertySchema &schema, bool isPoly) const
+{
+	TMap map;
+	//first: pass the class name, or the compact class id, if one was registered
+	if (isPoly)
+		serializeClass(map, metaObject);
+
+	//go through all properties and try to serialize them, reusing the names decoded by the schema
+	for (auto i = 0; i < schema.properties.size(); i++) {
+		const auto property = metaObject->property(schema.properties[i]);
+		if constexpr (std::is_same_v<TMap, QJsonObject>)
+			map[schema.names[i]] = RawProperty::serialize<QJsonValue>(helper(), property, object);
+		else
+			map[schema.names[i]] = RawProperty::serialize<QCborValue>(helper(), property, object);
+	}
+	return map;
+}
+
+template <typename TMap>
+TMap ObjectConverter::serializeChanges(const QMetaObject *metaObject, QObject *object, const PropertySchema &schema, bool isPoly, ChangeTracker *tracker) const
+{
+	// take the changes first, so changes made while serializing are reported again next time
+	const auto changed = tracker->takeChanges(object);
+
+	TMap map;
+	for (auto i = 0; i < schema.properties.size(); i++) {
+		const auto property = metaObject->property(schema.properties[i]);
+		if (changed.contains(property.name())) {
+			// changed properties are written completely, including their child objects
+			ChangeTrackingContext _{ChangeTrackingContext::Mode::Snapshot};
+			if constexpr (std::is_same_v<TMap, QJsonObject>)
+				map[schema.names[i]] = RawProperty::serialize<QJsonValue>(helper(), property, object);
+			else
+				map[schema.names[i]] = RawProperty::serialize<QCborValue>(helper(), property, object);
+		} else if (QMetaType(property.userType()).flags().testFlag(QMetaType::PointerToQObject)) {
+			// unchanged child objects are still asked for their own changes, and left out if they have none
+			const auto child = property.read(object);
+			if (!child.value<QObject*>())
+				continue;
+			if constexpr (std::is_same_v<TMap, QJsonObject>) {
+				const auto childChanges = helper()->serializeJsonSubtype(property, child);
+				if (!childChanges.isObject() || !childChanges.toObject().isEmpty())
+					map[schema.names[i]] = childChanges;
+			} else {
+				const auto childChanges = helper()->serializeSubtype(property, child);
+				const auto childValue = childChanges.isTag() ? childChanges.taggedValue() : childChanges;
+				if (!childValue.isMap() || !childValue.toMap().isEmpty())
+					map[schema.names[i]] = childChanges;
+			}
+		}
+	}
+
+	// the class name is only needed to apply changes, so an empty map always means "unchanged"
+	if (isPoly && !map.isEmpty())
+		serializeClass(map, metaObject);
+	return map;
+}
+
+template <typename TMap>
+const QMetaObject *ObjectConverter::deserializedClass(int propertyType, const QMetaObject *metaObject, const TMap &value, bool &isPoly) const
+{
+	auto poly = static_cast<SerializerBase::Polymorphing>(helper()->getProperty("polymorphing").toInt());
+
+	// try to get the polymorphic metatype (if allowed)
+	isPoly = false;
+	if (poly != SerializerBase::Polymorphing::Disabled) {
+		if (const auto classIt = value.constFind(QStringLiteral("@class")); classIt != value.constEnd()) {
+			isPoly = true;
+			// JSON has no integers -> class ids are read as double
+			auto isClassId = false;
+			qint64 classId = -1;
+			QString className;
+			if constexpr (std::is_same_v<TMap, QJsonObject>) {
+				const QJsonValue classValue = classIt.value();
+				isClassId = classValue.isDouble();
+				classId = static_cast<qint64>(classValue.toDouble());
+				className = classValue.toString();
+			} else {
+				const QCborValue classValue = classIt.value();
+				isClassId = classValue.isInteger();
+				classId = classValue.toInteger();
+				className = classValue.toString();
+			}
+			const auto nMeta = isClassId ?
+								   helper()->classForId(classId) :
+								   findClass(className);
+			if (!nMeta) {
+				throw DeserializationException("Unable to find class requested from json \"@class\" property: " +
+													(isClassId ?
+														 QByteArray::number(classId) :
+														 className.toUtf8()));
+			}
+			if (!nMeta->inherits(metaObject)) {
+				throw DeserializationException("Requested class from \"@class\" field, " +
+													QByteArray{nMeta->className()} +
+													QByteArray(", does not inhert the property type ") +
+													QMetaTypeName(propertyType));
+			}
+			metaObject = nMeta;
+		} else if (poly == SerializerBase::Polymorphing::Forced)
+			throw DeserializationException("Json does not contain the \"@class\" field, but forced polymorphism requires it");
+	}
+	return metaObject;
+}
+
+template <typename TMap>
+QObject *ObjectConverter::deserializeMap(int propertyType, const QMetaObject *metaObject, const TMap &value, QObject *parent) const
+{
+	auto isPoly = false;
+	metaObject = deserializedClass(propertyType, metaObject, value, isPoly);
+
+	// try to construct the object
+	return createObject(metaObject, parent, [&](QObject *object) {
+		deserializeProperties(metaObject, object, value, isPoly);
+	});
+}
+
+template <typename TMap>
+void ObjectConverter::deserializeProperties(const QMetaObject *metaObject, QObject *object, const TMap &value, bool isPoly, bool inPlace) const
 {
 	auto validationFlags = helper()->getProperty("validationFlags").value<SerializerBase::ValidationFlags>();
-	auto keepObjectName = helper()->getProperty("keepObjectName").toBool();
+	const auto projection = ProjectionContext::current();
+	DeferredNotifications notifications{object, helper()->getProperty("deferNotifications").toBool()};
 
-	// collect required properties, if set
+	// collect required properties, if set (only the projected ones are required, and none for merge patches)
 	QSet<QByteArray> reqProps;
-	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties)) {
+	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties) && !MergePatchContext::isActive()) {
 		const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
-		auto i = QObject::staticMetaObject.indexOfProperty("objectName");
-		if (!keepObjectName)
-			i++;
-		for (; i < metaObject->propertyCount(); i++) {
+		for (auto i = firstPropertyIndex(); i < metaObject->propertyCount(); i++) {
 			auto property = metaObject->property(i);
-			if(ignoreStoredAttribute || property.isStored())
+			if((ignoreStoredAttribute || property.isStored()) &&
+			   projection->select(QString::fromUtf8(property.name())))
 				reqProps.insert(property.name());
 		}
 	}
@@ -305,25 +698,207 @@ void ObjectConverter::deserializeProperties(const QMetaObject *metaObject, QObje
 		if (isPoly && it.key() == QStringLiteral("@class"))
 			continue;
 
-		const auto key = it.key().toString().toUtf8();
+		QString name;
+		if constexpr (std::is_same_v<TMap, QJsonObject>)
+			name = it.key();
+		else
+			name = it.key().toString();
+		// not projected -> skip without constructing anything
+		const auto selected = projection->select(name);
+		if (!selected)
+			continue;
+		ProjectionContext _{selected};
+
+		const auto key = name.toUtf8();
 		const auto propIndex = metaObject->indexOfProperty(key);
 		if (propIndex != -1) {
 			const auto property = metaObject->property(propIndex);
-			property.write(object, helper()->deserializeSubtype(property, it.value(), object));
+			auto written = false;
+			if constexpr (std::is_same_v<TMap, QJsonObject>)
+				written = writeProperty(object, property, helper()->deserializeJsonSubtype(property, it.value(), object));
+			else if (inPlace)
+				written = updateProperty(object, property, it.value());
+			else
+				written = deserializeProperty(object, property, it.value());
+			if (written)
+				notifications.add(property);
 			reqProps.remove(property.name());
 		} else if (validationFlags.testFlag(SerializerBase::ValidationFlag::NoExtraProperties)) {
-			throw DeserializationException("Found extra property " +
-												key +
-												" but extra properties are not allowed");
-		} else
-			object->setProperty(key, helper()->deserializeSubtype(QMetaType::UnknownType, it.value(), object, key));
+			ErrorSink::fail([key]() {
+				return "Found extra property " +
+					   key +
+					   " but extra properties are not allowed";
+			});
+			return;
+		} else if constexpr (std::is_same_v<TMap, QJsonObject>) {
+			auto dynValue = helper()->deserializeJsonSubtype(QMetaType::UnknownType, it.value(), object, key);
+			if (!ErrorSink::currentFailed())
+				object->setProperty(key, dynValue);
+		} else if (inPlace) {
+			const auto current = object->property(key);
+			auto updated = current;
+			// merge patches remove dynamic properties that are null
+			if (MergePatchContext::isActive() && it.value().isNull())
+				updated = QVariant{};
+			else
+				helper()->deserializeSubtypeInto(QMetaType::UnknownType, updated, it.value(), object, key);
+			if (!ErrorSink::currentFailed() && updated != current)
+				object->setProperty(key, updated);
+		} else {
+			auto dynValue = helper()->deserializeSubtype(QMetaType::UnknownType, it.value(), object, key);
+			if (!ErrorSink::currentFailed())
+				object->setProperty(key, dynValue);
+		}
 	}
 
 	//make shure all required properties have been read
 	if (validationFlags.testFlag(SerializerBase::ValidationFlag::AllProperties) && !reqProps.isEmpty()) {
-		throw DeserializationException(QByteArray("Not all properties for ") +
-											metaObject->className() +
-											QByteArray(" are present in the json object Missing properties: ") +
-											reqProps.values().join(", "));
+		ErrorSink::fail([metaObject, reqProps]() {
+			return QByteArray("Not all properties for ") +
+				   metaObject->className() +
+				   QByteArray(" are present in the json object Missing properties: ") +
+				   reqProps.values().join(", ");
+		});
+	}
+}
+
+void ObjectConverter::deserializePositional(const QMetaObject *metaObject, QObject *object, const QCborArray &value, bool inPlace) const
+{
+	const auto ignoreStoredAttribute = helper()->getProperty("ignoreStoredAttribute").toBool();
+	const auto schema = PropertySchema::get(metaObject, firstPropertyIndex(), ignoreStoredAttribute);
+	const auto fingerprint = PropertySchema::fingerprintOf(value);
+	if (fingerprint == schema.fingerprint) {
+		// same schema -> assign by index, all properties are present by definition
+		if (value.size() != static_cast<qsizetype>(schema.properties.size()) + 1) {
+			throw DeserializationException(QByteArray("Positional data does not match the number of properties of ") +
+										   metaObject->className());
+		}
+		const auto projection = ProjectionContext::current();
+		DeferredNotifications notifications{object, helper()->getProperty("deferNotifications").toBool()};
+		for (auto i = 0; i < schema.properties.size(); ++i) {
+			const auto selected = projection->select(schema.names[i]);
+			if (!selected)
+				continue;
+			ProjectionContext _{selected};
+			const auto property = metaObject->property(schema.properties[i]);
+			const auto written = inPlace ?
+									 updateProperty(object, property, value[i + 1]) :
+									 deserializeProperty(object, property, value[i + 1]);
+			if (written)
+				notifications.add(property);
+		}
+	} else if (const auto knownSchema = PropertySchema::find(metaObject, fingerprint, {firstPropertyIndex(), firstPropertyIndex() == 0 ? 1 : 0}, ignoreStoredAttribute); knownSchema) {
+		// different, but known schema -> restore the keys and use the keyed path
+		deserializeProperties(metaObject, object, knownSchema->toMap(value), false, inPlace);
+	} else {
+		throw DeserializationException(QByteArray("Unknown schema fingerprint ") +
+									   QByteArray::number(fingerprint) +
+									   QByteArray(" in positional data for ") +
+									   metaObject->className());
+	}
+}
+
+bool ObjectConverter::writeProperty(QObject *object, const QMetaProperty &property, const QVariant &value)
+{
+	// a failed subtype returns an invalid value in sink mode, which must not replace the property
+	if (ErrorSink::currentFailed())
+		return false;
+	return property.write(object, value);
+}
+
+bool ObjectConverter::deserializeProperty(QObject *object, const QMetaProperty &property, const QCborValue &value) const
+{
+	// deserialize into storage of the property type and write it via the metacall, without a QVariant in between
+	if (RawProperty raw{property}; raw.data()) {
+		if (helper()->deserializeSubtypeRaw(property, value, raw.data(), object))
+			return raw.write(property, object);
+		if (ErrorSink::currentFailed())
+			return false;
+	}
+	return writeProperty(object, property, helper()->deserializeSubtype(property, value, object));
+}
+
+bool ObjectConverter::updateProperty(QObject *object, const QMetaProperty &property, const QCborValue &value) const
+{
+	// update a copy and only write it back if it changed, so no needless change signals are emitted
+	const auto current = property.read(object);
+	if (MergePatchContext::isActive() && value.isNull()) {
+		// merge patches remove values that are null -> reset the property
+		if (property.isResettable())
+			return property.reset(object);
+		else if (const auto defaultValue = JsonPatch::defaultValue(property.userType()); defaultValue != current)
+			return property.write(object, defaultValue);
+		return false;
+	}
+
+	auto updated = current;
+	helper()->deserializeSubtypeInto(property, updated, value, object);
+	if (!ErrorSink::currentFailed() && updated != current)
+		return property.write(object, updated);
+	return false;
+}
+
+ObjectConverter::DeferredNotifications::DeferredNotifications(QObject *object, bool active) :
+	_object{object},
+	_active{active},
+	_blocker{active ? object : nullptr}
+{}
+
+ObjectConverter::DeferredNotifications::~DeferredNotifications()
+{
+	// the written properties changed, no matter if the rest failed
+	emitAll();
+}
+
+void ObjectConverter::DeferredNotifications::add(const QMetaProperty &property)
+{
+	if (_active && property.hasNotifySignal())
+		_properties.append(property);
+}
+
+void ObjectConverter::DeferredNotifications::emitAll()
+{
+	if (!_active)
+		return;
+
+	// properties can share a notify signal, which is still only emitted once
+	_blocker.unblock();
+	QSet<int> emitted;
+	for (const auto &property : qAsConst(_properties)) {
+		if (!emitted.contains(property.notifySignalIndex())) {
+			emitted.insert(property.notifySignalIndex());
+			emitNotify(property);
+		}
+	}
+	_properties.clear();
+}
+
+void ObjectConverter::DeferredNotifications::emitNotify(const QMetaProperty &property) const
+{
+	// pass the current value, if the signal has a parameter for it, and default values for everything else
+	const auto signal = property.notifySignal();
+	const auto typeNames = signal.parameterTypes();
+	std::array<QVariant, 10> values;
+	std::array<QGenericArgument, 10> arguments;
+	for (auto i = 0; i < std::min(signal.parameterCount(), 10); ++i) {
+		const auto type = signal.parameterType(i);
+		if (i == 0 && type == property.userType())
+			values[i] = property.read(_object);
+		else if (type != QMetaType::QVariant)
+			values[i] = JsonPatch::defaultValue(type);
+		// invoking the signal with a null argument would crash, so it is not emitted at all
+		if (type != QMetaType::QVariant && (!values[i].isValid() || !values[i].constData())) {
+			qCWarning(logObjConverter) << "Cannot emit notify signal" << signal.methodSignature()
+									   << "of property" << property.name()
+									   << "- parameter" << i << "of type" << typeNames[i]
+									   << "cannot be constructed";
+			return;
+		}
+		// a QVariant parameter is passed as it is, not its content
+		arguments[i] = QGenericArgument{typeNames[i].constData(),
+										type == QMetaType::QVariant ? static_cast<const void*>(&values[i]) : values[i].constData()};
 	}
+	signal.invoke(_object, Qt::DirectConnection,
+				  arguments[0], arguments[1], arguments[2], arguments[3], arguments[4],
+				  arguments[5], arguments[6], arguments[7], arguments[8], arguments[9]);
 }
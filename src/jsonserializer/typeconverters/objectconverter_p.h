@@ -4,7 +4,20 @@
 #include "qtjsonserializer_global.h"
 #include "typeconverter.h"
 
+#include <optional>
+
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
+
+namespace QtJsonSerializer {
+class PropertySchema;
+class ChangeTracker;
+}
 
 namespace QtJsonSerializer::TypeConverters {
 
@@ -15,16 +28,82 @@ public:
 	bool canConvert(int metaTypeId) const override;
 	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	int guessType(QCborTag tag, QCborValue::Type dataType) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+	QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const override;
+	QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const override;
+	void deserializeInto(int propertyType, QVariant &target, const QCborValue &value, QObject *parent) const override;
 
 private:
+	struct ConstructorPlan {
+		QVector<int> parameterTypes;
+		bool appendParent = false;
+		bool direct = true;
+		int revision = 0;
+	};
+	using ConstructorKey = QPair<const QMetaObject*, QByteArray>;
+
+	// blocks the signals of an object while its properties are written, and then emits the notify
+	// signal of every written property once, when it goes out of scope - even if writing fails
+	class DeferredNotifications {
+		Q_DISABLE_COPY(DeferredNotifications)
+	public:
+		DeferredNotifications(QObject *object, bool active);
+		~DeferredNotifications();
+
+		void add(const QMetaProperty &property);
+
+	private:
+		QObject *_object;
+		bool _active;
+		QSignalBlocker _blocker;
+		QVector<QMetaProperty> _properties;
+
+		void emitAll();
+		void emitNotify(const QMetaProperty &property) const;
+	};
+
+	mutable QReadWriteLock _cacheLock;
+	mutable QHash<const QMetaObject*, bool> _polyCache;
+	mutable QHash<QString, const QMetaObject*> _classCache;
+	mutable QHash<ConstructorKey, ConstructorPlan> _constructorCache;
+
 	bool polyMetaObject(QObject *object) const;
+	std::pair<const QMetaObject*, bool> serializedClass(int propertyType, QObject *object) const;
+	const QMetaObject *findClass(const QString &className) const;
+	int firstPropertyIndex() const;
+	QObject *createObject(const QMetaObject *metaObject, QObject *parent) const;
+	template <typename TFunc>
+	QObject *createObject(const QMetaObject *metaObject, QObject *parent, const TFunc &deserialize) const;
+	ChangeTracker *changeTracker() const;
+	ChangeTracker *trackSerialized(QObject *object) const;
+	QObject *trackDeserialized(QObject *object) const;
 
 	QObject *deserializeGenericObject(const QCborArray &value, QObject *parent) const;
+	static QByteArray argumentSignature(const QCborArray &value);
+	static bool convertArgument(QVariant &argument, int metaTypeId);
+	QVariantList deserializeArguments(const QCborArray &value, const ConstructorPlan &plan, const QByteArray &className) const;
+	std::optional<QVariantList> tryDeserializeArguments(const QCborArray &value, const ConstructorPlan &plan, const QByteArray &className) const;
+	QObject *constructObject(const QMetaObject *metaObject, QVariantList arguments, const ConstructorPlan &plan, QObject *parent) const;
 	QObject *deserializeConstructedObject(const QCborValue &value, QObject *parent) const;
-	void deserializeProperties(const QMetaObject *metaObject, QObject *object, const QCborMap &value, bool isPoly = false) const;
+	template <typename TMap>
+	void serializeClass(TMap &map, const QMetaObject *metaObject) const;
+	template <typename TMap>
+	TMap serializeProperties(const QMetaObject *metaObject, QObject *object, const PropertySchema &schema, bool isPoly) const;
+	template <typename TMap>
+	TMap serializeChanges(const QMetaObject *metaObject, QObject *object, const PropertySchema &schema, bool isPoly, ChangeTracker *tracker) const;
+	template <typename TMap>
+	const QMetaObject *deserializedClass(int propertyType, const QMetaObject *metaObject, const TMap &value, bool &isPoly) const;
+	template <typename TMap>
+	QObject *deserializeMap(int propertyType, const QMetaObject *metaObject, const TMap &value, QObject *parent) const;
+	template <typename TMap>
+	void deserializeProperties(const QMetaObject *metaObject, QObject *object, const TMap &value, bool isPoly = false, bool inPlace = false) const;
+	void deserializePositional(const QMetaObject *metaObject, QObject *object, const QCborArray &value, bool inPlace = false) const;
+	static bool writeProperty(QObject *object, const QMetaProperty &property, const QVariant &value);
+	bool deserializeProperty(QObject *object, const QMetaProperty &property, const QCborValue &value) const;
+	bool updateProperty(QObject *object, const QMetaProperty &property, const QCborValue &value) const;
 };
 
 Q_DECLARE_LOGGING_CATEGORY(logObjConverter)
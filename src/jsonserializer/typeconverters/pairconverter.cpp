@@ -1,6 +1,7 @@
 #include "pairconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QCborArray>
 using namespace QtJsonSerializer;
@@ -19,13 +20,23 @@ QList<QCborTag> PairConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> PairConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask PairConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Array};
+	return cborTypeMask({QCborValue::Array});
 }
 
 QCborValue PairConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue PairConverter::serializeRaw(int propertyType, const void *value) const
 {
 	const auto extractor = helper()->extractor(propertyType);
 	if (!extractor) {
@@ -38,12 +49,17 @@ QCborValue PairConverter::serialize(int propertyType, const QVariant &value) con
 	return {
 		static_cast<QCborTag>(CborSerializer::Pair),
 		QCborArray {
-			helper()->serializeSubtype(subTypes[0], extractor->extract(value, 0), "first"),
-			helper()->serializeSubtype(subTypes[1], extractor->extract(value, 1), "second")
+			RawValue::serializeElement(helper(), *extractor, propertyType, value, 0, subTypes[0], "first"),
+			RawValue::serializeElement(helper(), *extractor, propertyType, value, 1, subTypes[1], "second")
 		}
 	};
 }
 
+QJsonValue PairConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant PairConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	const auto extractor = helper()->extractor(propertyType);
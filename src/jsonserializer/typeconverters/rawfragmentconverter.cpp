@@ -0,0 +1,71 @@
+#include "rawfragmentconverter_p.h"
+#include "exception.h"
+#include "rawfragment.h"
+#include "jsonreader_p.h"
+#include "jsonwriter_p.h"
+using namespace QtJsonSerializer;
+using namespace QtJsonSerializer::TypeConverters;
+
+bool RawFragmentConverter::canConvert(int metaTypeId) const
+{
+	return metaTypeId == qMetaTypeId<RawFragment>();
+}
+
+QList<QCborValue::Type> RawFragmentConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask RawFragmentConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
+{
+	Q_UNUSED(metaTypeId)
+	Q_UNUSED(tag)
+	return AnyCborType;
+}
+
+QCborValue RawFragmentConverter::serialize(int propertyType, const QVariant &value) const
+{
+	Q_UNUSED(propertyType)
+	const auto fragment = value.value<RawFragment>();
+	// JSON text is spliced into the output unchanged, if it is written by the JsonWriter. Text
+	// captured while reading was valid back then, only text from fromJson() has to be parsed
+	if (fragment._encoding == RawFragment::Encoding::JsonData && JsonTextContext::isActive()) {
+		if (fragment._cborValue.isUndefined() && fragment.toCborValue().isInvalid())
+			throw SerializationException{"Raw fragment does not contain valid data"};
+		return JsonWriter::text(fragment._data);
+	}
+
+	// fragments captured from CBOR are passed on as they are
+	const auto cValue = fragment.toCborValue();
+	if (cValue.isInvalid())
+		throw SerializationException{"Raw fragment does not contain valid data"};
+	return cValue;
+}
+
+QVariant RawFragmentConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(parent)
+	// objects and arrays read from JSON text keep that text, including its formatting
+	if (const auto json = JsonSourceContext::capture(value); !json.isNull())
+		return QVariant::fromValue(RawFragment{json, value});
+	// the value shares its data with the parsed document, so nothing is copied or converted
+	return QVariant::fromValue(RawFragment{value});
+}
+
+QJsonValue RawFragmentConverter::serializeJsonValue(int propertyType, const QVariant &value) const
+{
+	Q_UNUSED(propertyType)
+	// fragments captured from JSON are passed on as they are
+	const auto jValue = value.value<RawFragment>().toJsonValue();
+	if (jValue.isUndefined())
+		throw SerializationException{"Raw fragment does not contain valid data"};
+	return jValue;
+}
+
+QVariant RawFragmentConverter::deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const
+{
+	Q_UNUSED(propertyType)
+	Q_UNUSED(parent)
+	return QVariant::fromValue(RawFragment{value});
+}
@@ -0,0 +1,24 @@
+#ifndef QTJSONSERIALIZER_RAWFRAGMENTCONVERTER_P_H
+#define QTJSONSERIALIZER_RAWFRAGMENTCONVERTER_P_H
+
+#include "qtjsonserializer_global.h"
+#include "typeconverter.h"
+
+namespace QtJsonSerializer::TypeConverters {
+
+class Q_JSONSERIALIZER_EXPORT RawFragmentConverter : public TypeConverter
+{
+public:
+	QT_JSONSERIALIZER_TYPECONVERTER_NAME(RawFragmentConverter)
+	bool canConvert(int metaTypeId) const override;
+	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
+	QCborValue serialize(int propertyType, const QVariant &value) const override;
+	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+	QJsonValue serializeJsonValue(int propertyType, const QVariant &value) const override;
+	QVariant deserializeJsonValue(int propertyType, const QJsonValue &value, QObject *parent) const override;
+};
+
+}
+
+#endif // QTJSONSERIALIZER_RAWFRAGMENTCONVERTER_P_H
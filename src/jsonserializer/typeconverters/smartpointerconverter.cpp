@@ -11,17 +11,15 @@ bool SmartPointerConverter::canConvert(int metaTypeId) const
 }
 
 QList<QCborValue::Type> SmartPointerConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask SmartPointerConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	QList<QCborValue::Type> types;
-	const auto metaEnum = QMetaEnum::fromType<QCborValue::Type>();
-	types.reserve(metaEnum.keyCount());
-	for (auto i = 0; i < metaEnum.keyCount(); ++i) {
-		if (const auto value = metaEnum.value(i); value != QCborValue::Invalid)
-			types.append(static_cast<QCborValue::Type>(value));
-	}
-	return types;
+	return AnyCborType;
 }
 
 QCborValue SmartPointerConverter::serialize(int propertyType, const QVariant &value) const
@@ -47,10 +45,10 @@ QVariant SmartPointerConverter::deserializeCbor(int propertyType, const QCborVal
 											QByteArray(". Make shure to register std::optional types via QJsonSerializer::registerPointerConverters"));
 	}
 
-	auto result = helper()->deserializeSubtype(extractor->subtypes()[0],
-											   value,
-											   extractor->baseType() == "qpointer" ? parent : nullptr,
-											   "data");
-	extractor->emplace(result, result);
+	QVariant result;
+	extractor->emplace(result, helper()->deserializeSubtype(extractor->subtypes()[0],
+															value,
+															extractor->baseType() == "qpointer" ? parent : nullptr,
+															"data"));
 	return result;
 }
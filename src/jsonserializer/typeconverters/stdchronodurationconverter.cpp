@@ -1,5 +1,6 @@
 #include "stdchronodurationconverter_p.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QSet>
 using namespace QtJsonSerializer;
@@ -55,10 +56,15 @@ QList<QCborTag> StdChronoDurationConverter::allowedCborTags(int metaTypeId) cons
 }
 
 QList<QCborValue::Type> StdChronoDurationConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask StdChronoDurationConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Integer};
+	return cborTypeMask({QCborValue::Integer});
 }
 
 int StdChronoDurationConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -85,42 +91,59 @@ int StdChronoDurationConverter::guessType(QCborTag tag, QCborValue::Type dataTyp
 }
 
 QCborValue StdChronoDurationConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue StdChronoDurationConverter::serializeRaw(int propertyType, const void *value) const
 {
 	const auto tag = tagForType(propertyType);
 	switch (static_cast<quint64>(tag)) {
 	case CborSerializer::ChronoNanoSeconds:
-		return {tag, static_cast<qint64>(value.value<nanoseconds>().count())};
+		return {tag, static_cast<qint64>(static_cast<const nanoseconds*>(value)->count())};
 	case CborSerializer::ChronoMicroSeconds:
-		return {tag, static_cast<qint64>(value.value<microseconds>().count())};
+		return {tag, static_cast<qint64>(static_cast<const microseconds*>(value)->count())};
 	case CborSerializer::ChronoMilliSeconds:
-		return {tag, static_cast<qint64>(value.value<milliseconds>().count())};
+		return {tag, static_cast<qint64>(static_cast<const milliseconds*>(value)->count())};
 	case CborSerializer::ChronoSeconds:
-		return {tag, static_cast<qint64>(value.value<seconds>().count())};
+		return {tag, static_cast<qint64>(static_cast<const seconds*>(value)->count())};
 	case CborSerializer::ChronoMinutes:
-		return {tag, static_cast<qint64>(value.value<minutes>().count())};
+		return {tag, static_cast<qint64>(static_cast<const minutes*>(value)->count())};
 	case CborSerializer::ChronoHours:
-		return {tag, static_cast<qint64>(value.value<hours>().count())};
+		return {tag, static_cast<qint64>(static_cast<const hours*>(value)->count())};
 	default:
 		Q_UNREACHABLE();
 	}
 }
 
+QJsonValue StdChronoDurationConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant StdChronoDurationConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	auto result = RawValue::construct(propertyType);
+	deserializeRaw(propertyType, value, result.data(), parent);
+	return result;
+}
+
+void StdChronoDurationConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
 {
 	Q_UNUSED(parent)
 	const auto metaDuration = parseValue(propertyType, value, helper());
 	if (propertyType == qMetaTypeId<nanoseconds>())
-		return QVariant::fromValue(cast<nanoseconds>(metaDuration));
+		*static_cast<nanoseconds*>(target) = cast<nanoseconds>(metaDuration);
 	else if (propertyType == qMetaTypeId<microseconds>())
-		return QVariant::fromValue(cast<microseconds>(metaDuration));
+		*static_cast<microseconds*>(target) = cast<microseconds>(metaDuration);
 	else if (propertyType == qMetaTypeId<milliseconds>())
-		return QVariant::fromValue(cast<milliseconds>(metaDuration));
+		*static_cast<milliseconds*>(target) = cast<milliseconds>(metaDuration);
 	else if (propertyType == qMetaTypeId<seconds>())
-		return QVariant::fromValue(cast<seconds>(metaDuration));
+		*static_cast<seconds*>(target) = cast<seconds>(metaDuration);
 	else if (propertyType == qMetaTypeId<minutes>())
-		return QVariant::fromValue(cast<minutes>(metaDuration));
+		*static_cast<minutes*>(target) = cast<minutes>(metaDuration);
 	else if (propertyType == qMetaTypeId<hours>())
-		return QVariant::fromValue(cast<hours>(metaDuration));
+		*static_cast<hours*>(target) = cast<hours>(metaDuration);
 	else
 		throw SerializationException{"Invalid type id"};
 }
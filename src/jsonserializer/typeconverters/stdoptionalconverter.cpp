@@ -1,5 +1,6 @@
 #include "stdoptionalconverter_p.h"
 #include "exception.h"
+#include "rawvalue_p.h"
 
 #include <optional>
 using namespace QtJsonSerializer;
@@ -14,20 +15,23 @@ bool StdOptionalConverter::canConvert(int metaTypeId) const
 }
 
 QList<QCborValue::Type> StdOptionalConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask StdOptionalConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	QList<QCborValue::Type> types;
-	const auto metaEnum = QMetaEnum::fromType<QCborValue::Type>();
-	types.reserve(metaEnum.keyCount());
-	for (auto i = 0; i < metaEnum.keyCount(); ++i) {
-		if (const auto value = metaEnum.value(i); value != QCborValue::Invalid)
-			types.append(static_cast<QCborValue::Type>(value));
-	}
-	return types;
+	return AnyCborType;
 }
 
 QCborValue StdOptionalConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue StdOptionalConverter::serializeRaw(int propertyType, const void *value) const
 {
 	const auto extractor = helper()->extractor(propertyType);
 	if (!extractor) {
@@ -36,13 +40,22 @@ QCborValue StdOptionalConverter::serialize(int propertyType, const QVariant &val
 										  QByteArray(". Make shure to register std::optional types via QJsonSerializer::registerOptionalConverters"));
 	}
 
-	const auto cValue = extractor->extract(value);
+	if (const auto element = extractor->elementAt(value); element)
+		return helper()->serializeSubtypeRaw(extractor->subtypes()[0], element, "value");
+
+	// empty, or an extractor without in place access
+	const auto cValue = extractor->extract(RawValue::box(propertyType, value));
 	if (cValue.userType() == QMetaType::Nullptr)
 		return QCborValue::Null;
 	else
 		return helper()->serializeSubtype(extractor->subtypes()[0], cValue, "value");
 }
 
+QJsonValue StdOptionalConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant StdOptionalConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	const auto extractor = helper()->extractor(propertyType);
@@ -54,9 +67,8 @@ QVariant StdOptionalConverter::deserializeCbor(int propertyType, const QCborValu
 
 	QVariant result;
 	if (value.isNull())
-		result = QVariant::fromValue(nullptr);
+		extractor->emplace(result, QVariant::fromValue(nullptr));
 	else
-		result = helper()->deserializeSubtype(extractor->subtypes()[0], value, parent, "value");
-	extractor->emplace(result, result);
+		extractor->emplace(result, helper()->deserializeSubtype(extractor->subtypes()[0], value, parent, "value"));
 	return result;
 }
@@ -1,6 +1,7 @@
 #include "stdtupleconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QCborArray>
 using namespace QtJsonSerializer;
@@ -19,13 +20,23 @@ QList<QCborTag> StdTupleConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> StdTupleConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask StdTupleConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Array};
+	return cborTypeMask({QCborValue::Array});
 }
 
 QCborValue StdTupleConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue StdTupleConverter::serializeRaw(int propertyType, const void *value) const
 {
 	const auto extractor = helper()->extractor(propertyType);
 	if (!extractor) {
@@ -38,10 +49,15 @@ QCborValue StdTupleConverter::serialize(int propertyType, const QVariant &value)
 	QCborArray array;
 	auto max = metaTypes.size();
 	for(auto i = 0; i < max; ++i)
-		array.append(helper()->serializeSubtype(metaTypes[i], extractor->extract(value, i), "<" + QByteArray::number(i) + ">"));
+		array.append(RawValue::serializeElement(helper(), *extractor, propertyType, value, i, metaTypes[i], "<" + QByteArray::number(i) + ">"));
 	return {static_cast<QCborTag>(CborSerializer::Tuple), array};
 }
 
+QJsonValue StdTupleConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant StdTupleConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
 {
 	const auto extractor = helper()->extractor(propertyType);
@@ -1,5 +1,7 @@
 #include "stdvariantconverter_p.h"
 #include "exception.h"
+#include "cborserializer.h"
+#include "exceptioncontext_p.h"
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -9,18 +11,34 @@ bool StdVariantConverter::canConvert(int metaTypeId) const
 	return extractor && extractor->baseType() == "variant";
 }
 
+QList<QCborTag> StdVariantConverter::allowedCborTags(int metaTypeId) const
+{
+	Q_UNUSED(metaTypeId)
+	return {
+		NoTag,
+		static_cast<QCborTag>(CborSerializer::VariantAlternative)
+	};
+}
+
+TypeConverter::TagSupport StdVariantConverter::cborTagSupport(int metaTypeId, QCborTag tag) const
+{
+	Q_UNUSED(metaTypeId)
+	Q_UNUSED(tag)
+	// besides the own tags, an undiscriminated value carries the tag of the alternative,
+	// which is verified by the converter of the alternative during deserialization
+	return TagSupport::Allowed;
+}
+
 QList<QCborValue::Type> StdVariantConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask StdVariantConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	QList<QCborValue::Type> types;
-	const auto metaEnum = QMetaEnum::fromType<QCborValue::Type>();
-	types.reserve(metaEnum.keyCount());
-	for (auto i = 0; i < metaEnum.keyCount(); ++i) {
-		if (const auto value = metaEnum.value(i); value != QCborValue::Invalid)
-			types.append(static_cast<QCborValue::Type>(value));
-	}
-	return types;
+	return AnyCborType;
 }
 
 QCborValue StdVariantConverter::serialize(int propertyType, const QVariant &value) const
@@ -42,7 +60,20 @@ QCborValue StdVariantConverter::serialize(int propertyType, const QVariant &valu
 										  value.typeName() +
 										  QByteArray(", which is not a type of the given variant"));
 	}
-	return helper()->serializeSubtype(metaTypes[mIndex], cValue, QByteArray{"<"} + QMetaTypeName(metaTypes[mIndex]) + QByteArray{">"});
+	auto cborValue = helper()->serializeSubtype(metaTypes[mIndex], cValue, QByteArray{"<"} + QMetaTypeName(metaTypes[mIndex]) + QByteArray{">"});
+	if (!helper()->getProperty("variantDiscriminator").toBool())
+		return cborValue;
+	else if (helper()->jsonMode()) {
+		return QCborMap {
+			{QStringLiteral("@type"), mIndex},
+			{QStringLiteral("@value"), cborValue}
+		};
+	} else {
+		return {
+			static_cast<QCborTag>(CborSerializer::VariantAlternative),
+			QCborArray{mIndex, cborValue}
+		};
+	}
 }
 
 QVariant StdVariantConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
@@ -54,17 +85,67 @@ QVariant StdVariantConverter::deserializeCbor(int propertyType, const QCborValue
 											QByteArray(". Make shure to register std::variant types via QJsonSerializer::registerVariantConverters"));
 	}
 
-	// try all types until one succeeds
-	for (auto metaType : extractor->subtypes()) {
-		// ignore exceptions and try with the next type
+	// if the alternative is given explicitly, use it directly
+	const auto metaTypes = extractor->subtypes();
+	if (const auto discriminated = readDiscriminated(value); discriminated) {
+		const auto &[index, cValue] = *discriminated;
+		if (index < 0 || index >= metaTypes.size()) {
+			throw DeserializationException(QByteArray("Invalid alternative index ") +
+												QByteArray::number(index) +
+												QByteArray(" for ") +
+												QMetaTypeName(propertyType));
+		}
+		const auto metaType = metaTypes[static_cast<int>(index)];
+		QVariant result;
+		extractor->emplace(result, helper()->deserializeSubtype(metaType, cValue, parent, QByteArray{"<"} + QMetaTypeName(metaType) + QByteArray{">"}));
+		return result;
+	}
+
+	// try all types that might accept the data until one succeeds
+	for (auto metaType : metaTypes) {
+		if (!helper()->canDeserializeSubtype(metaType, value))
+			continue;
+		// ignore errors and try with the next type
+		ErrorSink trialSink;
 		try {
-			auto result = helper()->deserializeSubtype(metaType, value, parent, QByteArray{"<"} + QMetaTypeName(metaType) + QByteArray{">"});
-			extractor->emplace(result, result);
+			auto alternative = helper()->deserializeSubtype(metaType, value, parent, QByteArray{"<"} + QMetaTypeName(metaType) + QByteArray{">"});
+			if (trialSink.hasFailed())
+				continue;
+			QVariant result;
+			extractor->emplace(result, std::move(alternative));
 			return result;
 		} catch (DeserializationException &) {}
 	}
 
-	throw DeserializationException(QByteArray("Failed to deserialze value to ") +
-										QMetaTypeName(propertyType) +
-										QByteArray(" because all possible sub-type converters rejected the passed value."));
+	ErrorSink::fail([propertyType]() {
+		return QByteArray("Failed to deserialze value to ") +
+			   QMetaTypeName(propertyType) +
+			   QByteArray(" because all possible sub-type converters rejected the passed value.");
+	});
+	return {};
+}
+
+std::optional<std::pair<qint64, QCborValue>> StdVariantConverter::readDiscriminated(const QCborValue &value) const
+{
+	if (helper()->jsonMode()) {
+		// json has no tags, so the map form is only accepted if enabled
+		if (!value.isMap() || !helper()->getProperty("variantDiscriminator").toBool())
+			return std::nullopt;
+		const auto cborMap = value.toMap();
+		const auto typeIt = cborMap.constFind(QStringLiteral("@type"));
+		const auto valueIt = cborMap.constFind(QStringLiteral("@value"));
+		if (cborMap.size() != 2 ||
+			typeIt == cborMap.constEnd() ||
+			valueIt == cborMap.constEnd() ||
+			!typeIt.value().isInteger())
+			return std::nullopt;
+		return std::make_pair(typeIt.value().toInteger(), QCborValue{valueIt.value()});
+	} else {
+		if (!value.isTag() || value.tag() != static_cast<QCborTag>(CborSerializer::VariantAlternative))
+			return std::nullopt;
+		const auto cborArray = value.taggedValue().toArray();
+		if (cborArray.size() != 2 || !cborArray.first().isInteger())
+			throw DeserializationException{"A VariantAlternative tagged value must be an array of the index and the value"};
+		return std::make_pair(cborArray.first().toInteger(), cborArray.last());
+	}
 }
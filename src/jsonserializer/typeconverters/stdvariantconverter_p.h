@@ -4,6 +4,9 @@
 #include "qtjsonserializer_global.h"
 #include "typeconverter.h"
 
+#include <optional>
+#include <utility>
+
 namespace QtJsonSerializer::TypeConverters {
 
 class Q_JSONSERIALIZER_EXPORT StdVariantConverter : public TypeConverter
@@ -11,9 +14,15 @@ class Q_JSONSERIALIZER_EXPORT StdVariantConverter : public TypeConverter
 public:
 	QT_JSONSERIALIZER_TYPECONVERTER_NAME(StdVariantConverter)
 	bool canConvert(int metaTypeId) const override;
+	QList<QCborTag> allowedCborTags(int metaTypeId) const override;
+	TagSupport cborTagSupport(int metaTypeId, QCborTag tag) const override;
 	QList<QCborValue::Type> allowedCborTypes(int metaTypeId, QCborTag tag) const override;
+	CborTypeMask allowedCborTypeMask(int metaTypeId, QCborTag tag) const override;
 	QCborValue serialize(int propertyType, const QVariant &value) const override;
 	QVariant deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const override;
+
+private:
+	std::optional<std::pair<qint64, QCborValue>> readDiscriminated(const QCborValue &value) const;
 };
 
 }
@@ -13,6 +13,7 @@ HEADERS += \
 	$$PWD/multimapconverter_p.h \
 	$$PWD/objectconverter_p.h \
 	$$PWD/pairconverter_p.h \
+	$$PWD/rawfragmentconverter_p.h \
 	$$PWD/smartpointerconverter_p.h \
 	$$PWD/stdchronodurationconverter_p.h \
 	$$PWD/stdoptionalconverter_p.h \
@@ -35,6 +36,7 @@ SOURCES += \
 	$$PWD/multimapconverter.cpp \
 	$$PWD/objectconverter.cpp \
 	$$PWD/pairconverter.cpp \
+	$$PWD/rawfragmentconverter.cpp \
 	$$PWD/smartpointerconverter.cpp \
 	$$PWD/stdchronodurationconverter.cpp \
 	$$PWD/stdoptionalconverter.cpp \
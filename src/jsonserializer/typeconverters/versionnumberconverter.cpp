@@ -1,6 +1,7 @@
 #include "versionnumberconverter_p.h"
 #include "exception.h"
 #include "cborserializer.h"
+#include "rawvalue_p.h"
 
 #include <QtCore/QVersionNumber>
 using namespace QtJsonSerializer;
@@ -20,10 +21,15 @@ QList<QCborTag> VersionNumberConverter::allowedCborTags(int metaTypeId) const
 }
 
 QList<QCborValue::Type> VersionNumberConverter::allowedCborTypes(int metaTypeId, QCborTag tag) const
+{
+	return cborTypes(allowedCborTypeMask(metaTypeId, tag));
+}
+
+TypeConverter::CborTypeMask VersionNumberConverter::allowedCborTypeMask(int metaTypeId, QCborTag tag) const
 {
 	Q_UNUSED(metaTypeId)
 	Q_UNUSED(tag)
-	return {QCborValue::Array, QCborValue::String};
+	return cborTypeMask({QCborValue::Array, QCborValue::String});
 }
 
 int VersionNumberConverter::guessType(QCborTag tag, QCborValue::Type dataType) const
@@ -36,9 +42,14 @@ int VersionNumberConverter::guessType(QCborTag tag, QCborValue::Type dataType) c
 }
 
 QCborValue VersionNumberConverter::serialize(int propertyType, const QVariant &value) const
+{
+	return serializeRaw(propertyType, RawValue::ofType(propertyType, value).constData());
+}
+
+QCborValue VersionNumberConverter::serializeRaw(int propertyType, const void *value) const
 {
 	Q_UNUSED(propertyType)
-	const auto version = value.value<QVersionNumber>();
+	const auto &version = *static_cast<const QVersionNumber*>(value);
 	if (helper()->getProperty("versionAsString").toBool())
 		return {static_cast<QCborTag>(CborSerializer::VersionNumber), version.toString()};
 	else {
@@ -49,10 +60,23 @@ QCborValue VersionNumberConverter::serialize(int propertyType, const QVariant &v
 	}
 }
 
+QJsonValue VersionNumberConverter::serializeJsonRaw(int propertyType, const void *value) const
+{
+	return serializeRaw(propertyType, value).toJsonValue();
+}
+
 QVariant VersionNumberConverter::deserializeCbor(int propertyType, const QCborValue &value, QObject *parent) const
+{
+	auto result = RawValue::construct(propertyType);
+	deserializeRaw(propertyType, value, result.data(), parent);
+	return result;
+}
+
+void VersionNumberConverter::deserializeRaw(int propertyType, const QCborValue &value, void *target, QObject *parent) const
 {
 	Q_UNUSED(propertyType)
 	Q_UNUSED(parent)
+	auto &version = *static_cast<QVersionNumber*>(target);
 	const auto cValue = (value.isTag() ? value.taggedValue() : value);
 	if (cValue.type() == QCborValue::Array) {
 		const auto cArray = cValue.toArray();
@@ -67,19 +91,19 @@ QVariant VersionNumberConverter::deserializeCbor(int propertyType, const QCborVa
 			segments.append(static_cast<int>(cElem.toInteger()));
 			++i;
 		}
-		return QVariant::fromValue(QVersionNumber{std::move(segments)});
+		version = QVersionNumber{std::move(segments)};
 	} else if (cValue.type() == QCborValue::String) {
 		const auto strValue = cValue.toString();
 		if (!strValue.isEmpty()) {
 			int suffixIndex = -1;
-			const auto version = QVersionNumber::fromString(strValue, &suffixIndex);
-			if (version.isNull())
+			auto parsed = QVersionNumber::fromString(strValue, &suffixIndex);
+			if (parsed.isNull())
 				throw DeserializationException("Invalid version number, no segments found");
 			if (suffixIndex < strValue.size())
 				qCWarning(logVersionConverter) << "Parsed QVersionNumber with suffix - suffixes are discarded!";
-			return QVariant::fromValue(version);
+			version = std::move(parsed);
 		} else
-			return QVariant::fromValue(QVersionNumber{});
+			version = QVersionNumber{};
 	} else
 		throw DeserializationException{"Invalid type id"};
 }
@@ -2,6 +2,7 @@
 #define QTJSONSERIALIZER_TYPEEXTRACTORS_H
 
 #include "QtJsonSerializer/typeconverter.h"
+#include "QtJsonSerializer/metawriters.h"
 
 #include <optional>
 #include <tuple>
@@ -34,6 +35,10 @@ public:
 	void emplace(QVariant &target, const QVariant &value, int) const final {
 		target = QVariant::fromValue(Type{value.value<Pointer>()});
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int) const final {
+		target = QVariant::fromValue(Type{MetaWriters::Implementations::takeValue<Pointer>(std::move(value))});
+	}
 };
 
 template <typename TType>
@@ -59,6 +64,10 @@ public:
 	void emplace(QVariant &target, const QVariant &value, int) const final {
 		target = QVariant::fromValue(Type{value.value<Pointer>()});
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int) const final {
+		target = QVariant::fromValue(Type{MetaWriters::Implementations::takeValue<Pointer>(std::move(value))});
+	}
 };
 
 template <template <typename, typename> class TPair, typename TFirst, typename TSecond>
@@ -101,6 +110,33 @@ public:
 			break;
 		}
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int index) const final {
+		Q_ASSERT(target.userType() == qMetaTypeId<Type>());
+		const auto vPair = reinterpret_cast<Type*>(target.data());
+		switch (index) {
+		case 0:
+			vPair->first = MetaWriters::Implementations::takeValue<TFirst>(std::move(value));
+			break;
+		case 1:
+			vPair->second = MetaWriters::Implementations::takeValue<TSecond>(std::move(value));
+			break;
+		default:
+			break;
+		}
+	}
+
+	const void *elementAt(const void *value, int index) const final {
+		const auto vPair = static_cast<const Type*>(value);
+		switch (index) {
+		case 0:
+			return &vPair->first;
+		case 1:
+			return &vPair->second;
+		default:
+			return nullptr;
+		}
+	}
 };
 
 template <typename TValue>
@@ -130,6 +166,18 @@ public:
 		else
 			target = QVariant::fromValue<std::optional<TValue>>(value.value<TValue>());
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int) const final {
+		if (value.isNull())
+			target = QVariant::fromValue<std::optional<TValue>>(std::nullopt);
+		else
+			target = QVariant::fromValue<std::optional<TValue>>(MetaWriters::Implementations::takeValue<TValue>(std::move(value)));
+	}
+
+	const void *elementAt(const void *value, int) const final {
+		const auto &opt = *static_cast<const Type*>(value);
+		return opt ? &*opt : nullptr;
+	}
 };
 
 template <typename... TValues>
@@ -151,6 +199,18 @@ private:
 			return getIf<Index + 1, TRest...>(tpl, index);
 	}
 
+	template <size_t Index>
+	inline const void *addressIf(const Type &, size_t) const {
+		return nullptr;
+	}
+	template <size_t Index, typename TValue, typename... TRest>
+	inline const void *addressIf(const Type &tpl, size_t index) const {
+		if (Index == index)
+			return &std::get<Index>(tpl);
+		else
+			return addressIf<Index + 1, TRest...>(tpl, index);
+	}
+
 	template <size_t Index>
 	inline void setIf(Type *, size_t, const QVariant &) const {}
 	template <size_t Index, typename TValue, typename... TRest>
@@ -161,6 +221,16 @@ private:
 			setIf<Index + 1, TRest...>(tpl, index, value);
 	}
 
+	template <size_t Index>
+	inline void takeIf(Type *, size_t, QVariant &&) const {}
+	template <size_t Index, typename TValue, typename... TRest>
+	inline void takeIf(Type *tpl, size_t index, QVariant &&value) const {
+		if (Index == index)
+			std::get<Index>(*tpl) = MetaWriters::Implementations::takeValue<TValue>(std::move(value));
+		else
+			takeIf<Index + 1, TRest...>(tpl, index, std::move(value));
+	}
+
 public:
 	QByteArray baseType() const final {
 		return QByteArrayLiteral("tuple");
@@ -178,6 +248,15 @@ public:
 		Q_ASSERT(target.userType() == qMetaTypeId<Type>());
 		setIf<0, TValues...>(reinterpret_cast<Type*>(target.data()), static_cast<size_t>(index), value);
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int index) const final {
+		Q_ASSERT(target.userType() == qMetaTypeId<Type>());
+		takeIf<0, TValues...>(reinterpret_cast<Type*>(target.data()), static_cast<size_t>(index), std::move(value));
+	}
+
+	const void *elementAt(const void *value, int index) const final {
+		return addressIf<0, TValues...>(*static_cast<const Type*>(value), static_cast<size_t>(index));
+	}
 };
 
 template <typename... TValues>
@@ -197,6 +276,16 @@ private:
 			return constructIfType<_, TArgs...>(var);
 	}
 
+	template <typename _>
+	inline Type takeIfType(QVariant &&) const { return {}; }
+	template <typename _, typename TValue, typename... TArgs>
+	inline Type takeIfType(QVariant &&var) const {
+		if (var.userType() == qMetaTypeId<TValue>())
+			return MetaWriters::Implementations::takeValue<TValue>(std::move(var));
+		else
+			return takeIfType<_, TArgs...>(std::move(var));
+	}
+
 public:
 	QByteArray baseType() const final {
 		return QByteArrayLiteral("variant");
@@ -215,6 +304,10 @@ public:
 	void emplace(QVariant &target, const QVariant &value, int) const final {
 		target = QVariant::fromValue(constructIfType<void, TValues...>(value));
 	}
+
+	void emplaceMoved(QVariant &target, QVariant &&value, int) const final {
+		target = QVariant::fromValue(takeIfType<void, TValues...>(std::move(value)));
+	}
 };
 
 }
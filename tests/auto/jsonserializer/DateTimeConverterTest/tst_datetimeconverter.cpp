@@ -4,6 +4,7 @@
 #include "typeconvertertestbase.h"
 
 #include <QtJsonSerializer/private/datetimeconverter_p.h>
+#include <QtJsonSerializer/private/isodatetime_p.h>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -19,6 +20,12 @@ protected:
 	void addSerData() override;
 	void addDeserData() override;
 
+private Q_SLOTS:
+	void benchmarkFormat_data();
+	void benchmarkFormat();
+	void benchmarkParse_data();
+	void benchmarkParse();
+
 private:
 	DateTimeConverter _converter;
 };
@@ -61,6 +68,21 @@ void DateTimeConverterTest::addMetaData()
 									   << QCborValue::Integer
 									   << false
 									   << TypeConverter::DeserializationCapabilityResult::Guessed;
+	QTest::newRow("dt.msecs") << static_cast<int>(QMetaType::QDateTime)
+							  << static_cast<QCborTag>(CborSerializer::DateTimeMsecs)
+							  << QCborValue::Integer
+							  << true
+							  << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("dt.msecs.guessed") << static_cast<int>(QMetaType::UnknownType)
+									  << static_cast<QCborTag>(CborSerializer::DateTimeMsecs)
+									  << QCborValue::Integer
+									  << false
+									  << TypeConverter::DeserializationCapabilityResult::Guessed;
+	QTest::newRow("dt.msecs.invalid") << static_cast<int>(QMetaType::QDateTime)
+									  << static_cast<QCborTag>(CborSerializer::DateTimeMsecs)
+									  << QCborValue::String
+									  << true
+									  << TypeConverter::DeserializationCapabilityResult::Negative;
 	QTest::newRow("dt.tstamp.invalid") << static_cast<int>(QMetaType::QDateTime)
 									   << static_cast<QCborTag>(QCborKnownTags::UnixTime_t)
 									   << QCborValue::String
@@ -173,6 +195,28 @@ void DateTimeConverterTest::addCommonSerData()
 									 << QCborValue{QCborKnownTags::UnixTime_t, 1546522935ll}
 									 << QJsonValue{QJsonValue::Undefined};
 
+	QTest::newRow("datetime.string.utc") << QVariantHash{}
+										 << TestQ{}
+										 << static_cast<QObject*>(nullptr)
+										 << static_cast<int>(QMetaType::QDateTime)
+										 << QVariant{QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::UTC}}
+										 << QCborValue{QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::UTC}}
+										 << QJsonValue{QStringLiteral("2019-01-03T13:42:15.563Z")};
+	QTest::newRow("datetime.string.offset") << QVariantHash{}
+											<< TestQ{}
+											<< static_cast<QObject*>(nullptr)
+											<< static_cast<int>(QMetaType::QDateTime)
+											<< QVariant{QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::OffsetFromUTC, -9000}}
+											<< QCborValue{QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::OffsetFromUTC, -9000}}
+											<< QJsonValue{QStringLiteral("2019-01-03T13:42:15.563-02:30")};
+	QTest::newRow("datetime.msecs") << QVariantHash{{QStringLiteral("dateAsMsecsSinceEpoch"), true}}
+									<< TestQ{}
+									<< static_cast<QObject*>(nullptr)
+									<< static_cast<int>(QMetaType::QDateTime)
+									<< QVariant{QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::UTC}}
+									<< QCborValue{static_cast<QCborTag>(CborSerializer::DateTimeMsecs), 1546522935563ll}
+									<< QJsonValue{1546522935563.0};
+
 	QTest::newRow("date.datestr") << QVariantHash{}
 								  << TestQ{}
 								  << static_cast<QObject*>(nullptr)
@@ -225,6 +269,21 @@ void DateTimeConverterTest::addDeserData()
 										   << QCborValue{QCborKnownTags::UnixTime_t, 0ll}
 										   << QJsonValue{QJsonValue::Undefined};
 
+	QTest::newRow("datetime.string.fraction") << QVariantHash{}
+											  << TestQ{}
+											  << static_cast<QObject*>(nullptr)
+											  << static_cast<int>(QMetaType::QDateTime)
+											  << QVariant{QDateTime{{2019, 1, 3}, {13, 42, 15, 500}, Qt::UTC}}
+											  << QCborValue{QCborKnownTags::DateTimeString, QStringLiteral("2019-01-03T13:42:15.5Z")}
+											  << QJsonValue{QStringLiteral("2019-01-03T13:42:15,5Z")};
+	QTest::newRow("datetime.tstamp.json") << QVariantHash{}
+										  << TestQ{}
+										  << static_cast<QObject*>(nullptr)
+										  << static_cast<int>(QMetaType::QDateTime)
+										  << QVariant{QDateTime{{2019, 1, 3}, {13, 42, 15}, Qt::UTC}}
+										  << QCborValue{QCborKnownTags::UnixTime_t, 1546522935ll}
+										  << QJsonValue{1546522935.0};
+
 	QTest::newRow("date.dtstr") << QVariantHash{}
 								<< TestQ{}
 								<< static_cast<QObject*>(nullptr)
@@ -242,6 +301,55 @@ void DateTimeConverterTest::addDeserData()
 								<< QJsonValue{QJsonValue::Undefined};
 }
 
+void DateTimeConverterTest::benchmarkFormat_data()
+{
+	QTest::addColumn<bool>("fast");
+
+	QTest::newRow("qt") << false;
+	QTest::newRow("iso") << true;
+}
+
+void DateTimeConverterTest::benchmarkFormat()
+{
+	QFETCH(bool, fast);
+
+	const QDateTime dateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::OffsetFromUTC, 7200};
+	QString result;
+	if (fast) {
+		QBENCHMARK {
+			result = IsoDateTime::formatDateTime(dateTime);
+		}
+	} else {
+		QBENCHMARK {
+			result = dateTime.toString(Qt::ISODateWithMs);
+		}
+	}
+	QCOMPARE(result, QStringLiteral("2019-01-03T13:42:15.563+02:00"));
+}
+
+void DateTimeConverterTest::benchmarkParse_data()
+{
+	benchmarkFormat_data();
+}
+
+void DateTimeConverterTest::benchmarkParse()
+{
+	QFETCH(bool, fast);
+
+	const auto text = QStringLiteral("2019-01-03T13:42:15.563+02:00");
+	QDateTime result;
+	if (fast) {
+		QBENCHMARK {
+			result = *IsoDateTime::parseDateTime(text);
+		}
+	} else {
+		QBENCHMARK {
+			result = QDateTime::fromString(text, Qt::ISODateWithMs);
+		}
+	}
+	QCOMPARE(result, (QDateTime{{2019, 1, 3}, {13, 42, 15, 563}, Qt::OffsetFromUTC, 7200}));
+}
+
 QTEST_MAIN(DateTimeConverterTest)
 
 #include "tst_datetimeconverter.moc"
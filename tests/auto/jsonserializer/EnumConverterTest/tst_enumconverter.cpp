@@ -156,6 +156,13 @@ void EnumConverterTest::addCommonSerData()
 
 void EnumConverterTest::addDeserData()
 {
+	QTest::newRow("flags.string.spaces") << QVariantHash{{QStringLiteral("enumAsString"), true}}
+										 << TestQ{}
+										 << static_cast<QObject*>(nullptr)
+										 << qMetaTypeId<TestClass::TestFlags>()
+										 << QVariant::fromValue(TestClass::TestFlag::Flag2 | TestClass::TestFlag::Flag4)
+										 << QCborValue{static_cast<QCborTag>(CborSerializer::Flags), QStringLiteral("Flag2 | Flag4")}
+										 << QJsonValue{QStringLiteral("Flag2 | Flag4")};
 
 	QTest::newRow("enum.int.invalid") << QVariantHash{}
 									  << TestQ{}
@@ -185,6 +192,13 @@ void EnumConverterTest::addDeserData()
 										  << QVariant{}
 										  << QCborValue{QStringLiteral("invalid")}
 										  << QJsonValue{QStringLiteral("invalid")};
+	QTest::newRow("flags.string.partial") << QVariantHash{{QStringLiteral("enumAsString"), true}}
+										  << TestQ{}
+										  << static_cast<QObject*>(nullptr)
+										  << qMetaTypeId<TestClass::TestFlags>()
+										  << QVariant{}
+										  << QCborValue{QStringLiteral("Flag2|invalid")}
+										  << QJsonValue{QStringLiteral("Flag2|invalid")};
 }
 
 QTEST_MAIN(EnumConverterTest)
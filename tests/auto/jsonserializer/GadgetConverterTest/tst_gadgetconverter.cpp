@@ -5,6 +5,7 @@
 #include "testgadget.h"
 
 #include <QtJsonSerializer/private/gadgetconverter_p.h>
+#include <QtJsonSerializer/private/propertyschema_p.h>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -25,6 +26,8 @@ protected:
 
 private:
 	GadgetConverter _converter;
+
+	static qint64 fingerprint(bool ignoreStoredAttribute);
 };
 
 void GadgetConverterTest::initTest()
@@ -67,6 +70,21 @@ void GadgetConverterTest::addMetaData()
 							  << QCborValue::Null
 							  << true
 							  << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("positional") << qMetaTypeId<TestGadget>()
+								<< static_cast<QCborTag>(CborSerializer::PositionalObject)
+								<< QCborValue::Array
+								<< true
+								<< TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("positional.untagged") << qMetaTypeId<TestGadget>()
+										 << static_cast<QCborTag>(CborSerializer::NoTag)
+										 << QCborValue::Array
+										 << true
+										 << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("invalid.tag") << qMetaTypeId<TestGadget>()
+								 << static_cast<QCborTag>(CborSerializer::Enum)
+								 << QCborValue::Map
+								 << true
+								 << TypeConverter::DeserializationCapabilityResult::WrongTag;
 	QTest::newRow("excluded.keysequence") << static_cast<int>(QMetaType::QKeySequence)
 										  << static_cast<QCborTag>(CborSerializer::NoTag)
 										  << QCborValue::Map
@@ -149,10 +167,47 @@ void GadgetConverterTest::addCommonSerData()
 											{QStringLiteral("value"), 2},
 											{QStringLiteral("zhidden"), 3}
 										}};
+
+	QTest::newRow("positional") << QVariantHash{{QStringLiteral("positionalEncoding"), true}}
+								<< TestQ{{QMetaType::Int, 10, 1}, {QMetaType::Double, 0.1, 2}}
+								<< static_cast<QObject*>(nullptr)
+								<< qMetaTypeId<TestGadget>()
+								<< QVariant::fromValue(TestGadget{10, 0.1, 11})
+								<< QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(false), 1, 2}}
+								<< QJsonValue{QJsonArray{fingerprint(false), 1, 2}};
+	QTest::newRow("positional.ptr") << QVariantHash{{QStringLiteral("positionalEncoding"), true}}
+									<< TestQ{{QMetaType::Int, 5, 11}, {QMetaType::Double, 0.5, 22}}
+									<< static_cast<QObject*>(nullptr)
+									<< qMetaTypeId<TestGadget*>()
+									<< QVariant::fromValue(new TestGadget{5, 0.5, 11})
+									<< QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(false), 11, 22}}
+									<< QJsonValue{QJsonArray{fingerprint(false), 11, 22}};
 }
 
 void GadgetConverterTest::addDeserData()
 {
+	QTest::newRow("positional.fallback") << QVariantHash{}
+										 << TestQ{{QMetaType::Int, 10, 1}, {QMetaType::Double, 0.1, 2}, {QMetaType::Int, 42, 3}}
+										 << static_cast<QObject*>(nullptr)
+										 << qMetaTypeId<TestGadget>()
+										 << QVariant::fromValue(TestGadget{10, 0.1, 42})
+										 << QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(true), 1, 2, 3}}
+										 << QJsonValue{QJsonArray{fingerprint(true), 1, 2, 3}};
+	QTest::newRow("positional.unknown") << QVariantHash{}
+										<< TestQ{}
+										<< static_cast<QObject*>(nullptr)
+										<< qMetaTypeId<TestGadget>()
+										<< QVariant{}
+										<< QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{42, 1, 2}}
+										<< QJsonValue{QJsonArray{42, 1, 2}};
+	QTest::newRow("positional.size") << QVariantHash{}
+									 << TestQ{}
+									 << static_cast<QObject*>(nullptr)
+									 << qMetaTypeId<TestGadget>()
+									 << QVariant{}
+									 << QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(false), 1}}
+									 << QJsonValue{QJsonArray{fingerprint(false), 1}};
+
 //	QTest::newRow("basic.null") << QVariantHash{}
 //								<< TestQ{}
 //								<< static_cast<QObject*>(nullptr)
@@ -286,6 +341,11 @@ bool GadgetConverterTest::compare(int type, QVariant &actual, QVariant &expected
 		return TypeConverterTestBase::compare(type, actual, expected, aName, eName, file, line);
 }
 
+qint64 GadgetConverterTest::fingerprint(bool ignoreStoredAttribute)
+{
+	return PropertySchema::get(&TestGadget::staticMetaObject, 0, ignoreStoredAttribute).fingerprint;
+}
+
 QTEST_MAIN(GadgetConverterTest)
 
 #include "tst_gadgetconverter.moc"
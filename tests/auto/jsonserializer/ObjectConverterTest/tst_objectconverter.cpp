@@ -5,6 +5,7 @@
 #include "testobject.h"
 
 #include <QtJsonSerializer/private/objectconverter_p.h>
+#include <QtJsonSerializer/private/propertyschema_p.h>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -24,8 +25,13 @@ protected:
 
 	bool compare(int type, QVariant &actual, QVariant &expected, const char *aName, const char *eName, const char *file, int line) override;
 
+private Q_SLOTS:
+	void testConstructorCache();
+
 private:
 	ObjectConverter _converter;
+
+	static qint64 fingerprint();
 };
 
 void ObjectConverterTest::initTest()
@@ -82,6 +88,17 @@ void ObjectConverterTest::addMetaData()
 									  << true
 									  << TypeConverter::DeserializationCapabilityResult::Positive;
 
+	QTest::newRow("positional") << qMetaTypeId<TestObject*>()
+								<< static_cast<QCborTag>(CborSerializer::PositionalObject)
+								<< QCborValue::Array
+								<< true
+								<< TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("positional.untagged") << qMetaTypeId<TestObject*>()
+										 << static_cast<QCborTag>(CborSerializer::NoTag)
+										 << QCborValue::Array
+										 << true
+										 << TypeConverter::DeserializationCapabilityResult::Positive;
+
 	QTest::newRow("invalid.type1") << qMetaTypeId<OpaqueDummyGadget*>()
 								   << static_cast<QCborTag>(CborSerializer::NoTag)
 								   << QCborValue::Map
@@ -303,6 +320,35 @@ void ObjectConverterTest::addCommonSerData()
 												   {QStringLiteral("value"), 2},
 												   {QStringLiteral("extra4"), 3}
 											   }};
+
+	QTest::newRow("poly.classId") << QVariantHash{
+										 {QStringLiteral("polymorphing"), QVariant::fromValue(JsonSerializer::Polymorphing::Enabled)},
+										 {QStringLiteral("classIds"), QVariantHash{{QStringLiteral("StaticPolyObject"), 3}}}
+									 }
+								  << TestQ{{QMetaType::Int, 10, 1}, {QMetaType::Double, 0.1, 2}, {QMetaType::Bool, true, 3}}
+								  << static_cast<QObject*>(nullptr)
+								  << qMetaTypeId<TestObject*>()
+								  << QVariant::fromValue<TestObject*>(new StaticPolyObject{10, 0.1, 11, true, this})
+								  << QCborValue{QCborMap{
+										   {QStringLiteral("@class"), 3},
+										   {QStringLiteral("key"), 1},
+										   {QStringLiteral("value"), 2},
+										   {QStringLiteral("extra1"), 3}
+									   }}
+								  << QJsonValue{QJsonObject{
+										   {QStringLiteral("@class"), QStringLiteral("StaticPolyObject")},
+										   {QStringLiteral("key"), 1},
+										   {QStringLiteral("value"), 2},
+										   {QStringLiteral("extra1"), 3}
+									   }};
+
+	QTest::newRow("positional") << QVariantHash{{QStringLiteral("positionalEncoding"), true}}
+								<< TestQ{{QMetaType::Int, 10, 1}, {QMetaType::Double, 0.1, 2}}
+								<< static_cast<QObject*>(nullptr)
+								<< qMetaTypeId<TestObject*>()
+								<< QVariant::fromValue(new TestObject{10, 0.1, 11, this})
+								<< QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(), 1, 2}}
+								<< QJsonValue{QJsonArray{fingerprint(), 1, 2}};
 }
 
 void ObjectConverterTest::addSerData()
@@ -397,6 +443,31 @@ void ObjectConverterTest::addSerData()
 
 void ObjectConverterTest::addDeserData()
 {
+	QTest::newRow("positional.forced") << QVariantHash{
+											  {QStringLiteral("positionalEncoding"), true},
+											  {QStringLiteral("polymorphing"), QVariant::fromValue(JsonSerializer::Polymorphing::Forced)}
+										  }
+									   << TestQ{}
+									   << static_cast<QObject*>(nullptr)
+									   << qMetaTypeId<TestObject*>()
+									   << QVariant{}
+									   << QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(), 1, 2}}
+									   << QJsonValue{QJsonArray{fingerprint(), 1, 2}};
+	QTest::newRow("positional.base") << QVariantHash{}
+									 << TestQ{{QMetaType::Int, 10, 1}, {QMetaType::Double, 0.1, 2}}
+									 << static_cast<QObject*>(nullptr)
+									 << qMetaTypeId<DerivedTestObject*>()
+									 << QVariant::fromValue<TestObject*>(new DerivedTestObject{10, 0.1, 11, false, this})
+									 << QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{fingerprint(), 1, 2}}
+									 << QJsonValue{QJsonArray{fingerprint(), 1, 2}};
+	QTest::newRow("positional.unknown") << QVariantHash{}
+										<< TestQ{}
+										<< static_cast<QObject*>(nullptr)
+										<< qMetaTypeId<TestObject*>()
+										<< QVariant{}
+										<< QCborValue{static_cast<QCborTag>(CborSerializer::PositionalObject), QCborArray{42, 1, 2}}
+										<< QJsonValue{QJsonArray{42, 1, 2}};
+
 	QTest::newRow("broken") << QVariantHash{}
 							<< TestQ{}
 							<< static_cast<QObject*>(nullptr)
@@ -450,6 +521,21 @@ void ObjectConverterTest::addDeserData()
 													{QStringLiteral("extra3"), 3}
 												}};
 
+	QTest::newRow("poly.classId.unknown") << QVariantHash{{QStringLiteral("polymorphing"), QVariant::fromValue(JsonSerializer::Polymorphing::Enabled)}}
+										  << TestQ{}
+										  << static_cast<QObject*>(nullptr)
+										  << qMetaTypeId<TestObject*>()
+										  << QVariant{}
+										  << QCborValue{QCborMap{
+												   {QStringLiteral("@class"), 42},
+												   {QStringLiteral("key"), 1},
+												   {QStringLiteral("value"), 2}
+											   }}
+										  << QJsonValue{QJsonObject{
+												   {QStringLiteral("@class"), 42},
+												   {QStringLiteral("key"), 1},
+												   {QStringLiteral("value"), 2}
+											   }};
 	QTest::newRow("poly.forced.invalid") << QVariantHash{{QStringLiteral("polymorphing"), QVariant::fromValue(JsonSerializer::Polymorphing::Forced)}}
 										 << TestQ{}
 										 << static_cast<QObject*>(nullptr)
@@ -782,6 +868,84 @@ bool ObjectConverterTest::compare(int type, QVariant &actual, QVariant &expected
 		return TypeConverterTestBase::compare(type, actual, expected, aName, eName, file, line);
 }
 
+void ObjectConverterTest::testConstructorCache()
+{
+	const QCborValue cData{static_cast<QCborTag>(CborSerializer::GenericObject),
+						   QCborArray{
+							   QStringLiteral("TestObject"),
+							   1, 2, 3
+						   }};
+	const TestQ searchData {
+		{QMetaType::UnknownType, 10, 1},
+		{QMetaType::UnknownType, 0.1, 2},
+		{QMetaType::UnknownType, 42, 3}
+	};
+	const TestQ directData {
+		{QMetaType::Int, 10, 1},
+		{QMetaType::Double, 0.1, 2},
+		{QMetaType::Int, 42, 3}
+	};
+
+	ObjectConverter converter;
+	helper->properties.clear();
+	helper->expectedParent = nullptr;
+	helper->json = false;
+	converter.setHelper(helper);
+
+	try {
+		// first lookup: searches all constructors and probes typed deserialization
+		helper->deserData = searchData + directData;
+		auto object = converter.deserializeCbor(qMetaTypeId<TestObject*>(), cData, this).value<TestObject*>();
+		QVERIFY(object);
+		QVERIFY(helper->deserData.isEmpty());
+		QCOMPARE(object->key, 10);
+		QCOMPARE(object->value, 0.1);
+		QCOMPARE(object->zhidden, 42);
+		// TestObject(int, double, int, QObject*) was selected, with the parent appended
+		QCOMPARE(object->parent(), static_cast<QObject*>(this));
+		delete object;
+
+		// second lookup: deserializes the arguments to the parameter types right away
+		helper->deserData = directData;
+		object = converter.deserializeCbor(qMetaTypeId<TestObject*>(), cData, this).value<TestObject*>();
+		QVERIFY(object);
+		QVERIFY(helper->deserData.isEmpty());
+		QCOMPARE(object->key, 10);
+		QCOMPARE(object->value, 0.1);
+		QCOMPARE(object->zhidden, 42);
+		QCOMPARE(object->parent(), static_cast<QObject*>(this));
+		delete object;
+
+		// registering a converter invalidates the plan -> full search again
+		JsonSerializer serializer;
+		serializer.addJsonTypeConverter<ObjectConverter>();
+		helper->deserData = searchData + directData;
+		object = converter.deserializeCbor(qMetaTypeId<TestObject*>(), cData, this).value<TestObject*>();
+		QVERIFY(object);
+		QVERIFY(helper->deserData.isEmpty());
+		QCOMPARE(object->key, 10);
+		delete object;
+
+		// registering a converter factory invalidates the plan as well
+		SerializerBase::addJsonTypeConverterFactory<ObjectConverter, TypeConverter::VeryLow>();
+		helper->deserData = searchData + directData;
+		object = converter.deserializeCbor(qMetaTypeId<TestObject*>(), cData, this).value<TestObject*>();
+		QVERIFY(object);
+		QVERIFY(helper->deserData.isEmpty());
+		QCOMPARE(object->key, 10);
+		delete object;
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+qint64 ObjectConverterTest::fingerprint()
+{
+	return PropertySchema::get(&TestObject::staticMetaObject,
+							   QObject::staticMetaObject.indexOfProperty("objectName") + 1,
+							   false).fingerprint;
+}
+
 QTEST_MAIN(ObjectConverterTest)
 
 #include "tst_objectconverter.moc"
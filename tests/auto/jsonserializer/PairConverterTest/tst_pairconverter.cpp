@@ -4,6 +4,7 @@
 #include "typeconvertertestbase.h"
 
 #include <QtJsonSerializer/private/pairconverter_p.h>
+#include <QtJsonSerializer/private/serializerbase_p.h>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::TypeConverters;
 
@@ -20,6 +21,9 @@ protected:
 	void addSerData() override;
 	void addDeserData() override;
 
+private Q_SLOTS:
+	void testElementAt();
+
 private:
 	PairConverter _converter;
 };
@@ -159,6 +163,21 @@ void PairConverterTest::addDeserData()
 							 << QJsonValue{QJsonArray{true, 2, 3}};
 }
 
+void PairConverterTest::testElementAt()
+{
+	const QPair<QString, int> qPair{QStringLiteral("baum"), 42};
+	const auto qExtractor = SerializerBasePrivate::extractors.get(qMetaTypeId<QPair<QString, int>>());
+	QVERIFY(qExtractor);
+	QCOMPARE(qExtractor->elementAt(&qPair, 0), static_cast<const void*>(&qPair.first));
+	QCOMPARE(qExtractor->elementAt(&qPair, 1), static_cast<const void*>(&qPair.second));
+
+	const std::pair<bool, int> stdPair{true, 42};
+	const auto stdExtractor = SerializerBasePrivate::extractors.get(qMetaTypeId<std::pair<bool, int>>());
+	QVERIFY(stdExtractor);
+	QCOMPARE(stdExtractor->elementAt(&stdPair, 0), static_cast<const void*>(&stdPair.first));
+	QCOMPARE(stdExtractor->elementAt(&stdPair, 1), static_cast<const void*>(&stdPair.second));
+}
+
 QTEST_MAIN(PairConverterTest)
 
 #include "tst_pairconverter.moc"
@@ -0,0 +1,14 @@
+TEMPLATE = app
+
+QT = core testlib jsonserializer
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = tst_rawfragmentconverter
+
+include(../convlib.pri)
+
+SOURCES += \
+	tst_rawfragmentconverter.cpp
+
+include(../../testrun.pri)
@@ -0,0 +1,228 @@
+#include <QtTest>
+#include <QtJsonSerializer>
+
+#include "typeconvertertestbase.h"
+
+#include <QtJsonSerializer/private/rawfragmentconverter_p.h>
+using namespace QtJsonSerializer;
+using namespace QtJsonSerializer::TypeConverters;
+
+class Envelope
+{
+	Q_GADGET
+
+	Q_PROPERTY(QString target MEMBER target)
+	Q_PROPERTY(QtJsonSerializer::RawFragment payload MEMBER payload)
+
+public:
+	QString target;
+	RawFragment payload;
+};
+
+Q_DECLARE_METATYPE(Envelope)
+
+class RawFragmentConverterTest : public TypeConverterTestBase
+{
+	Q_OBJECT
+
+protected:
+	void initTest() override;
+	TypeConverter *converter() override;
+	void addConverterData() override;
+	void addMetaData() override;
+	void addCommonSerData() override;
+	void addSerData() override;
+
+private Q_SLOTS:
+	void testLazyAccess();
+	void testSourceText();
+
+private:
+	RawFragmentConverter _converter;
+};
+
+void RawFragmentConverterTest::initTest()
+{
+	qRegisterMetaType<Envelope>();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	QMetaType::registerEqualsComparator<RawFragment>();
+#endif
+}
+
+TypeConverter *RawFragmentConverterTest::converter()
+{
+	return &_converter;
+}
+
+void RawFragmentConverterTest::addConverterData()
+{
+	QTest::newRow("fragment") << static_cast<int>(TypeConverter::Standard);
+}
+
+void RawFragmentConverterTest::addMetaData()
+{
+	QTest::newRow("map") << qMetaTypeId<RawFragment>()
+						 << static_cast<QCborTag>(CborSerializer::NoTag)
+						 << QCborValue::Map
+						 << true
+						 << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("array") << qMetaTypeId<RawFragment>()
+						   << static_cast<QCborTag>(CborSerializer::NoTag)
+						   << QCborValue::Array
+						   << true
+						   << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("string") << qMetaTypeId<RawFragment>()
+							<< static_cast<QCborTag>(CborSerializer::NoTag)
+							<< QCborValue::String
+							<< true
+							<< TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("null") << qMetaTypeId<RawFragment>()
+						  << static_cast<QCborTag>(CborSerializer::NoTag)
+						  << QCborValue::Null
+						  << true
+						  << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("invalid") << static_cast<int>(QMetaType::QJsonValue)
+							 << static_cast<QCborTag>(CborSerializer::NoTag)
+							 << QCborValue::Map
+							 << false
+							 << TypeConverter::DeserializationCapabilityResult::Negative;
+}
+
+void RawFragmentConverterTest::addCommonSerData()
+{
+	QTest::newRow("cbor.map") << QVariantHash{}
+							  << TestQ{}
+							  << static_cast<QObject*>(nullptr)
+							  << qMetaTypeId<RawFragment>()
+							  << QVariant::fromValue(RawFragment{QCborValue{QCborMap{
+									 {QStringLiteral("key"), 42},
+									 {QStringLiteral("list"), QCborArray{true, QStringLiteral("text")}}
+								 }}})
+							  << QCborValue{QCborMap{
+									 {QStringLiteral("key"), 42},
+									 {QStringLiteral("list"), QCborArray{true, QStringLiteral("text")}}
+								 }}
+							  << QJsonValue{QJsonObject{
+									 {QStringLiteral("key"), 42},
+									 {QStringLiteral("list"), QJsonArray{true, QStringLiteral("text")}}
+								 }};
+	QTest::newRow("cbor.string") << QVariantHash{}
+								 << TestQ{}
+								 << static_cast<QObject*>(nullptr)
+								 << qMetaTypeId<RawFragment>()
+								 << QVariant::fromValue(RawFragment{QCborValue{QStringLiteral("text")}})
+								 << QCborValue{QStringLiteral("text")}
+								 << QJsonValue{QStringLiteral("text")};
+	QTest::newRow("json.array") << QVariantHash{}
+								<< TestQ{}
+								<< static_cast<QObject*>(nullptr)
+								<< qMetaTypeId<RawFragment>()
+								<< QVariant::fromValue(RawFragment{QJsonValue{QJsonArray{1, QStringLiteral("text"), QJsonValue::Null}}})
+								<< QCborValue{QCborArray{1, QStringLiteral("text"), nullptr}}
+								<< QJsonValue{QJsonArray{1, QStringLiteral("text"), QJsonValue::Null}};
+	QTest::newRow("json.null") << QVariantHash{}
+							   << TestQ{}
+							   << static_cast<QObject*>(nullptr)
+							   << qMetaTypeId<RawFragment>()
+							   << QVariant::fromValue(RawFragment{QJsonValue{QJsonValue::Null}})
+							   << QCborValue{nullptr}
+							   << QJsonValue{QJsonValue::Null};
+}
+
+void RawFragmentConverterTest::addSerData()
+{
+	QTest::newRow("data.cbor") << QVariantHash{}
+							   << TestQ{}
+							   << static_cast<QObject*>(nullptr)
+							   << qMetaTypeId<RawFragment>()
+							   << QVariant::fromValue(RawFragment::fromCbor(QCborValue{QCborArray{1, 2, 3}}.toCbor()))
+							   << QCborValue{QCborArray{1, 2, 3}}
+							   << QJsonValue{QJsonArray{1, 2, 3}};
+	QTest::newRow("data.json") << QVariantHash{}
+							   << TestQ{}
+							   << static_cast<QObject*>(nullptr)
+							   << qMetaTypeId<RawFragment>()
+							   << QVariant::fromValue(RawFragment::fromJson(R"({"key": [1, 2, 3]})"))
+							   << QCborValue{QCborMap{{QStringLiteral("key"), QCborArray{1, 2, 3}}}}
+							   << QJsonValue{QJsonObject{{QStringLiteral("key"), QJsonArray{1, 2, 3}}}};
+	QTest::newRow("data.cbor.invalid") << QVariantHash{}
+									   << TestQ{}
+									   << static_cast<QObject*>(nullptr)
+									   << qMetaTypeId<RawFragment>()
+									   << QVariant::fromValue(RawFragment::fromCbor(QByteArray{"\x83\x01", 2}))
+									   << QCborValue{QCborValue::Undefined}
+									   << QJsonValue{QJsonValue::Undefined};
+	QTest::newRow("data.json.invalid") << QVariantHash{}
+									   << TestQ{}
+									   << static_cast<QObject*>(nullptr)
+									   << qMetaTypeId<RawFragment>()
+									   << QVariant::fromValue(RawFragment::fromJson(R"({"key": [1, 2)"))
+									   << QCborValue{QCborValue::Undefined}
+									   << QJsonValue{QJsonValue::Undefined};
+}
+
+void RawFragmentConverterTest::testLazyAccess()
+{
+	const QByteArray json = R"({ "b": 1,  "a": [true] })";
+	const auto jFragment = RawFragment::fromJson(json);
+	QCOMPARE(jFragment.encoding(), RawFragment::Encoding::JsonData);
+	QVERIFY(!jFragment.isNull());
+	QCOMPARE(jFragment.toJson(QJsonDocument::Indented), json);
+	QCOMPARE(jFragment.toCborValue(), QCborValue{QCborMap{
+		{QStringLiteral("b"), 1},
+		{QStringLiteral("a"), QCborArray{true}}
+	}});
+	QCOMPARE(jFragment.toCbor(), jFragment.toCborValue().toCbor());
+	QCOMPARE(jFragment.toJsonValue(), QJsonValue{QJsonObject{
+		{QStringLiteral("b"), 1},
+		{QStringLiteral("a"), QJsonArray{true}}
+	}});
+
+	const auto cbor = QCborValue{QCborArray{1, QStringLiteral("text")}}.toCbor();
+	const auto cFragment = RawFragment::fromCbor(cbor);
+	QCOMPARE(cFragment.encoding(), RawFragment::Encoding::CborData);
+	QCOMPARE(cFragment.toCbor(), cbor);
+	QCOMPARE(cFragment.toJson(), QByteArray{R"([1,"text"])"});
+	QCOMPARE(cFragment, RawFragment{QJsonValue{QJsonArray{1, QStringLiteral("text")}}});
+	QVERIFY(cFragment != jFragment);
+
+	QVERIFY(RawFragment{}.isNull());
+	QVERIFY(RawFragment::fromJson({}).isNull());
+	QCOMPARE(RawFragment::fromJson("[1,").toJsonValue(), QJsonValue{QJsonValue::Undefined});
+}
+
+void RawFragmentConverterTest::testSourceText()
+{
+	// neither the whitespace nor the numbers or escapes are canonical, so any re-encoding shows
+	const QByteArray payload = "{ \"list\" : [ 1.50E+1, -0.0,1e2 ] ,\n\t\"text\":\"\\u0041b\" }";
+	const QByteArray json = "{\"target\":\"dest\",\"payload\":" + payload + "}";
+
+	JsonSerializer serializer;
+	try {
+		const auto envelope = serializer.deserializeFrom(json, qMetaTypeId<Envelope>()).value<Envelope>();
+		QCOMPARE(envelope.target, QStringLiteral("dest"));
+		QCOMPARE(envelope.payload.encoding(), RawFragment::Encoding::JsonData);
+		QCOMPARE(envelope.payload.toJson(), payload);
+		const auto cPayload = envelope.payload.toCborValue();
+		QCOMPARE(cPayload[QStringLiteral("text")], QCborValue{QStringLiteral("Ab")});
+		QCOMPARE(cPayload[QStringLiteral("list")].toArray().size(), static_cast<qsizetype>(3));
+
+		// written back byte for byte, in indented documents as well
+		QCOMPARE(serializer.serializeTo(QVariant::fromValue(envelope)), json);
+		QVERIFY(serializer.serializeTo(QVariant::fromValue(envelope), QJsonDocument::Indented).contains(payload));
+		// the direct JSON path only has the decoded value
+		QCOMPARE(serializer.serialize(QVariant::fromValue(envelope))[QStringLiteral("payload")].toObject(),
+				 cPayload.toJsonValue().toObject());
+
+		// empty containers cannot be told apart, so they fall back to the decoded value
+		const auto empty = serializer.deserializeFrom(R"({"target":"dest","payload":[ ]})", qMetaTypeId<Envelope>()).value<Envelope>();
+		QCOMPARE(empty.payload.toCborValue(), QCborValue{QCborArray{}});
+		QCOMPARE(serializer.serializeTo(QVariant::fromValue(empty)), QByteArray{R"({"target":"dest","payload":[]})"});
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+QTEST_MAIN(RawFragmentConverterTest)
+
+#include "tst_rawfragmentconverter.moc"
@@ -114,3 +114,73 @@ QVariant TestWrapperConverter::deserializeCbor(int propertyType, const QCborValu
 TestObject::TestObject(QObject *parent)
 	: QObject{parent}
 {}
+
+
+
+TreeObject::TreeObject(QObject *parent)
+	: QObject{parent}
+{}
+
+int TreeObject::value() const
+{
+	return _value;
+}
+
+QList<int> TreeObject::list() const
+{
+	return _list;
+}
+
+TreeObject *TreeObject::child() const
+{
+	return _child;
+}
+
+void TreeObject::setValue(int value)
+{
+	++writes;
+	if (_value != value) {
+		_value = value;
+		emit valueChanged();
+	}
+}
+
+void TreeObject::setList(const QList<int> &list)
+{
+	++writes;
+	if (_list != list) {
+		_list = list;
+		emit listChanged();
+	}
+}
+
+void TreeObject::setChild(TreeObject *child)
+{
+	++writes;
+	if (_child != child) {
+		_child = child;
+		emit childChanged();
+	}
+}
+
+
+
+OwnerObject::OwnerObject(QObject *parent)
+	: QObject{parent},
+	  _owned{new TreeObject{this}}
+{
+	_owned->setObjectName(QStringLiteral("owned"));
+}
+
+TreeObject *OwnerObject::owned() const
+{
+	return _owned;
+}
+
+void OwnerObject::setOwned(TreeObject *owned)
+{
+	if (_owned != owned) {
+		_owned = owned;
+		emit ownedChanged();
+	}
+}
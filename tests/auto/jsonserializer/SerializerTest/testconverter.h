@@ -75,6 +75,58 @@ public:
 	TestObject(QObject *parent = nullptr);
 };
 
+class TreeObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(int value READ value WRITE setValue NOTIFY valueChanged)
+	Q_PROPERTY(QList<int> list READ list WRITE setList NOTIFY listChanged)
+	Q_PROPERTY(TreeObject* child READ child WRITE setChild NOTIFY childChanged)
+
+public:
+	Q_INVOKABLE TreeObject(QObject *parent = nullptr);
+
+	int value() const;
+	QList<int> list() const;
+	TreeObject *child() const;
+
+	void setValue(int value);
+	void setList(const QList<int> &list);
+	void setChild(TreeObject *child);
+
+	int writes = 0;
+
+Q_SIGNALS:
+	void valueChanged();
+	void listChanged();
+	void childChanged();
+
+private:
+	int _value = 0;
+	QList<int> _list;
+	TreeObject *_child = nullptr;
+};
+
+// creates a child in its constructor, which the property points to
+class OwnerObject : public QObject
+{
+	Q_OBJECT
+
+	Q_PROPERTY(TreeObject* owned READ owned WRITE setOwned NOTIFY ownedChanged)
+
+public:
+	Q_INVOKABLE OwnerObject(QObject *parent = nullptr);
+
+	TreeObject *owned() const;
+	void setOwned(TreeObject *owned);
+
+Q_SIGNALS:
+	void ownedChanged();
+
+private:
+	TreeObject *_owned;
+};
+
 Q_DECLARE_OPERATORS_FOR_FLAGS(EnumContainer::EnumFlags)
 
 Q_DECLARE_METATYPE(EnumContainer)
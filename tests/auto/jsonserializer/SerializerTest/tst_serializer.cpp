@@ -7,6 +7,7 @@
 #include "testconverter.h"
 
 #include <QtJsonSerializer/private/serializerbase_p.h>
+#include <QtJsonSerializer/private/jsonreader_p.h>
 using namespace QtJsonSerializer;
 using namespace QtJsonSerializer::MetaWriters;
 
@@ -18,6 +19,41 @@ Q_DECLARE_METATYPE(TestPair)
 Q_DECLARE_METATYPE(std::optional<int>)
 Q_DECLARE_METATYPE(TestVariant)
 
+// a container that only gets a writer while the test runs
+struct LateList {
+	QList<int> values;
+};
+Q_DECLARE_METATYPE(LateList)
+
+class LateListWriter : public SequentialWriter
+{
+public:
+	LateListWriter(LateList *data) :
+		_data{data}
+	{}
+
+	SequenceInfo info() const override {
+		return {QMetaType::Int, false};
+	}
+	void reserve(int size) override {
+		_data->values.reserve(size);
+	}
+	void add(const QVariant &value) override {
+		_data->values.append(value.toInt());
+	}
+
+private:
+	LateList *_data;
+};
+
+class LateListWriterFactory : public SequentialWriterFactory
+{
+public:
+	QSharedPointer<SequentialWriter> create(void *data) const override {
+		return QSharedPointer<LateListWriter>::create(static_cast<LateList*>(data));
+	}
+};
+
 class SerializerTest : public QObject
 {
 	Q_OBJECT
@@ -36,6 +72,23 @@ private Q_SLOTS:
 
 	void testDeviceSerialization();
 	void testExceptionTrace();
+	void testTryDeserialize();
+	void testDeserializationCache();
+	void testClassIds();
+	void testProjection_data();
+	void testProjection();
+	void testDeserializeInto();
+	void testPatch();
+	void testChangeTracking();
+	void testDeferNotifications();
+	void testInstanceFactory();
+	void testWriterRegistration();
+	void testContiguousLists();
+	void testJsonText_data();
+	void testJsonText();
+
+	void benchmarkJsonParsing_data();
+	void benchmarkJsonParsing();
 
 private:
 	JsonSerializer *jsonSerializer = nullptr;
@@ -362,6 +415,18 @@ void SerializerTest::testVariantConversions()
 			for (const auto &vData : variantList)
 				writer->add(vData);
 			QCOMPARE(res, data);
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+			QVariant movedRes{data.userType(), nullptr};
+#else
+			QVariant movedRes{QMetaType(data.userType()), nullptr};
+#endif
+			{
+				ScopedSequentialWriter scopedWriter{movedRes};
+				QVERIFY(scopedWriter);
+				scopedWriter->addRange(QVariantList{variantList});
+			}
+			QCOMPARE(movedRes, data);
 		} else if (targetType == QMetaType::QVariantMap ||
 				   targetType == QMetaType::QVariantHash) {
 			const auto variantMap = variantData.toMap();
@@ -383,6 +448,20 @@ void SerializerTest::testVariantConversions()
 			for (auto it = variantMap.begin(), end = variantMap.end(); it != end; ++it)
 				writer->add(it.key(), it.value());
 			QCOMPARE(res, data);
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+			QVariant movedRes{data.userType(), nullptr};
+#else
+			QVariant movedRes{QMetaType(data.userType()), nullptr};
+#endif
+			{
+				ScopedAssociativeWriter scopedWriter{movedRes};
+				QVERIFY(scopedWriter);
+				scopedWriter->reserve(variantMap.size());
+				for (auto it = variantMap.begin(), end = variantMap.end(); it != end; ++it)
+					scopedWriter->add(QVariant{it.key()}, QVariant{it.value()});
+			}
+			QCOMPARE(movedRes, data);
 		}
 		convData = variantData;
 	} else {
@@ -867,6 +946,833 @@ void SerializerTest::testExceptionTrace()
 	}
 }
 
+void SerializerTest::testTryDeserialize()
+{
+	resetProps();
+
+	// valid data
+	const EnumContainer data{EnumContainer::Normal1, EnumContainer::Flag1 | EnumContainer::Flag3};
+	const QCborMap cMap {
+		{QStringLiteral("0"), QStringLiteral("Normal1")},
+		{QStringLiteral("1"), QStringLiteral("Flag1|Flag3")},
+	};
+	const auto cRes = cborSerializer->tryDeserialize<EnumContainer>(cMap);
+	QVERIFY(cRes);
+	QCOMPARE(cRes.value<EnumContainer>(), data);
+	QVERIFY(cRes.message().isEmpty());
+	const auto jRes = jsonSerializer->tryDeserializeFrom<EnumContainer>(QJsonDocument{QCborValue{cMap}.toJsonValue().toObject()}.toJson());
+	QVERIFY(jRes);
+	QCOMPARE(jRes.value<EnumContainer>(), data);
+
+	// errors reported by the serializer itself
+	const auto sRes = cborSerializer->tryDeserialize<int>(QCborValue{QStringLiteral("invalid")});
+	QVERIFY(!sRes);
+	QVERIFY(!sRes.value().isValid());
+	QVERIFY(sRes.propertyTrace().isEmpty());
+	QVERIFY(sRes.message().contains("strict validation"));
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+	QVERIFY_EXCEPTION_THROWN(sRes.raise(), DeserializationException);
+#else
+	QVERIFY_THROWS_EXCEPTION(DeserializationException, sRes.raise());
+#endif
+
+	// errors thrown by a converter
+	const auto eRes = cborSerializer->tryDeserialize<EnumContainer>(QCborMap{
+		{QStringLiteral("error"), QCborValue::Null}
+	});
+	QVERIFY(!eRes);
+	const auto trace = eRes.propertyTrace();
+	QCOMPARE(trace.size(), 1);
+	QCOMPARE(trace[0].second, QByteArray{"EnumContainer"});
+	QCOMPARE(trace[0].first, QByteArray{"test"});
+
+	// invalid documents
+	QVERIFY(!jsonSerializer->tryDeserializeFrom<EnumContainer>("{\"0\": "));
+	QVERIFY(!cborSerializer->tryDeserializeFrom<EnumContainer>(QByteArray::fromHex("a2")));
+}
+
+void SerializerTest::testDeserializationCache()
+{
+	resetProps();
+
+	// the rejection because of the tag is cached
+	const QCborValue tagged {static_cast<QCborTag>(4242), QCborArray{1, 2}};
+	QVERIFY(!cborSerializer->tryDeserialize<QList<int>>(tagged));
+	QVERIFY(!cborSerializer->tryDeserialize<QList<int>>(tagged));
+
+	// changing the type tag must invalidate the cached decision
+	cborSerializer->setTypeTag<QList<int>>(static_cast<QCborTag>(4242));
+	const auto res = cborSerializer->tryDeserialize<QList<int>>(tagged);
+	cborSerializer->setTypeTag<QList<int>>();
+	QVERIFY(res);
+	QCOMPARE(res.value<QList<int>>(), (QList<int>{1, 2}));
+	QVERIFY(!cborSerializer->tryDeserialize<QList<int>>(tagged));
+}
+
+void SerializerTest::testClassIds()
+{
+	resetProps();
+
+	try {
+		cborSerializer->setClassId<TreeObject>(7);
+		QCOMPARE(cborSerializer->classId<TreeObject>(), qint64{7});
+		QCOMPARE(cborSerializer->classForId(7), &TreeObject::staticMetaObject);
+
+		// polymorphic objects write the id instead of the class name
+		TreeObject object;
+		object.setValue(42);
+		object.setProperty("__qt_json_serializer_polymorphic", true);
+		const auto cbor = cborSerializer->serialize(&object);
+		QCOMPARE(cbor.toMap()[QStringLiteral("@class")], QCborValue{7});
+		const auto res = qobject_cast<TreeObject*>(cborSerializer->deserialize<QObject*>(cbor, this));
+		QVERIFY(res);
+		QCOMPARE(res->value(), 42);
+		res->deleteLater();
+
+		// the property switches polymorphism off again
+		object.setProperty("__qt_json_serializer_polymorphic", false);
+		QVERIFY(!cborSerializer->serialize(&object).toMap().contains(QStringLiteral("@class")));
+		object.setProperty("__qt_json_serializer_polymorphic", true);
+
+		// a new id replaces the old one, and without an id the name is written again
+		cborSerializer->setClassId<TreeObject>(8);
+		QCOMPARE(cborSerializer->classForId(7), static_cast<const QMetaObject*>(nullptr));
+		QCOMPARE(cborSerializer->classForId(8), &TreeObject::staticMetaObject);
+		cborSerializer->setClassId<TreeObject>();
+		QCOMPARE(cborSerializer->classId<TreeObject>(), qint64{-1});
+		QCOMPARE(cborSerializer->classForId(8), static_cast<const QMetaObject*>(nullptr));
+		QCOMPARE(cborSerializer->serialize(&object).toMap()[QStringLiteral("@class")], QCborValue{QStringLiteral("TreeObject")});
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	cborSerializer->setClassId<TreeObject>();
+	resetProps();
+}
+
+void SerializerTest::testProjection_data()
+{
+	QTest::addColumn<bool>("structuralIndexing");
+
+	QTest::newRow("sequential") << false;
+	QTest::newRow("indexed") << true;
+}
+
+void SerializerTest::testProjection()
+{
+	QFETCH(bool, structuralIndexing);
+
+	resetProps();
+	jsonSerializer->setStructuralIndexing(structuralIndexing);
+	using TestMap = QMap<QString, QMap<QString, int>>;
+
+	// "c" is not a valid map, but never looked at
+	const QByteArray json = R"({"a": {"x": 1, "y": 2}, "b": {"x": 3, "y": 4}, "c": [1, 2]})";
+	const QStringList projection {
+		QStringLiteral("a"),
+		QStringLiteral("b.x"),
+		QStringLiteral("d.x")
+	};
+	const TestMap result {
+		{QStringLiteral("a"), {{QStringLiteral("x"), 1}, {QStringLiteral("y"), 2}}},
+		{QStringLiteral("b"), {{QStringLiteral("x"), 3}}}
+	};
+
+	try {
+		QCOMPARE(jsonSerializer->deserializeFrom<TestMap>(json, projection), result);
+		const auto jValue = QJsonDocument::fromJson(json).object();
+		QCOMPARE(jsonSerializer->deserialize<TestMap>(jValue, projection), result);
+
+		const auto cValue = QCborValue::fromJsonValue(jValue);
+		QCOMPARE(cborSerializer->deserialize<TestMap>(cValue, projection), result);
+		QCOMPARE(cborSerializer->deserializeFrom<TestMap>(cValue.toCbor(), projection), result);
+
+		// without projection, everything is read again
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(jsonSerializer->deserializeFrom<TestMap>(json), DeserializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(DeserializationException, jsonSerializer->deserializeFrom<TestMap>(json));
+#endif
+		QCOMPARE(jsonSerializer->deserializeFrom<TestMap>(json, QStringList{QStringLiteral("a"), QStringLiteral("b")}),
+				 (TestMap {
+					  {QStringLiteral("a"), {{QStringLiteral("x"), 1}, {QStringLiteral("y"), 2}}},
+					  {QStringLiteral("b"), {{QStringLiteral("x"), 3}, {QStringLiteral("y"), 4}}}
+				  }));
+
+		// skipped values must still be valid JSON
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(jsonSerializer->deserializeFrom<TestMap>(R"({"a": {}, "c": [1, ]})", projection), DeserializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(DeserializationException, jsonSerializer->deserializeFrom<TestMap>(R"({"a": {}, "c": [1, ]})", projection));
+#endif
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testDeserializeInto()
+{
+	resetProps();
+
+	auto root = new TreeObject{this};
+	auto child = new TreeObject{root};
+	root->setValue(1);
+	root->setList({1, 2, 3});
+	root->setChild(child);
+	child->setValue(2);
+	root->writes = 0;
+	child->writes = 0;
+
+	try {
+		// unchanged data -> nothing is written and the child is kept
+		jsonSerializer->deserializeInto(root, QJsonObject {
+			{QStringLiteral("value"), 1},
+			{QStringLiteral("list"), QJsonArray{1, 2, 3}},
+			{QStringLiteral("child"), QJsonObject {
+				 {QStringLiteral("value"), 2},
+				 {QStringLiteral("list"), QJsonArray{}},
+				 {QStringLiteral("child"), QJsonValue::Null}
+			 }}
+		});
+		QCOMPARE(root->child(), child);
+		QCOMPARE(root->writes, 0);
+		QCOMPARE(child->writes, 0);
+
+		// only changed properties are written, nested objects are updated in place
+		cborSerializer->deserializeInto(root, QCborMap {
+			{QStringLiteral("value"), 1},
+			{QStringLiteral("list"), QCborArray{1, 2, 3, 4}},
+			{QStringLiteral("child"), QCborMap {
+				 {QStringLiteral("value"), 3},
+				 {QStringLiteral("list"), QCborArray{}},
+				 {QStringLiteral("child"), nullptr}
+			 }}
+		});
+		QCOMPARE(root->child(), child);
+		QCOMPARE(root->list(), (QList<int>{1, 2, 3, 4}));
+		QCOMPARE(root->writes, 1);
+		QCOMPARE(child->value(), 3);
+		QCOMPARE(child->writes, 1);
+
+		// containers are refilled, with their elements updated by key
+		using TestMap = QMap<QString, QMap<QString, int>>;
+		TestMap map {
+			{QStringLiteral("a"), {{QStringLiteral("x"), 1}}},
+			{QStringLiteral("b"), {{QStringLiteral("y"), 2}}}
+		};
+		jsonSerializer->deserializeInto(map, QJsonObject {
+			{QStringLiteral("a"), QJsonObject{{QStringLiteral("x"), 1}, {QStringLiteral("z"), 3}}},
+			{QStringLiteral("c"), QJsonObject{}}
+		});
+		QCOMPARE(map, (TestMap {
+			{QStringLiteral("a"), {{QStringLiteral("x"), 1}, {QStringLiteral("z"), 3}}},
+			{QStringLiteral("c"), {}}
+		}));
+
+		// invalid targets cannot be updated
+		QVariant invalid;
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(cborSerializer->deserializeInto(invalid, QCborValue{42}), DeserializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(DeserializationException, cborSerializer->deserializeInto(invalid, QCborValue{42}));
+#endif
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testPatch()
+{
+	resetProps();
+
+	auto root = new TreeObject{this};
+	auto child = new TreeObject{root};
+	root->setValue(1);
+	root->setList({1, 2});
+	root->setChild(child);
+	child->setValue(2);
+	root->writes = 0;
+	child->writes = 0;
+
+	try {
+		// merge patches only touch what they mention
+		jsonSerializer->applyMergePatch(root, QJsonObject {
+			{QStringLiteral("child"), QJsonObject {
+				 {QStringLiteral("value"), 5}
+			 }}
+		});
+		QCOMPARE(root->child(), child);
+		QCOMPARE(root->list(), (QList<int>{1, 2}));
+		QCOMPARE(root->writes, 0);
+		QCOMPARE(child->value(), 5);
+		QCOMPARE(child->writes, 1);
+
+		// null removes values
+		cborSerializer->applyMergePatch(root, QCborMap {
+			{QStringLiteral("value"), nullptr}
+		});
+		QCOMPARE(root->value(), 0);
+		QCOMPARE(root->writes, 1);
+
+		using TestMap = QMap<QString, QMap<QString, int>>;
+		TestMap map {
+			{QStringLiteral("a"), {{QStringLiteral("x"), 1}, {QStringLiteral("y"), 2}}},
+			{QStringLiteral("b"), {{QStringLiteral("x"), 3}}}
+		};
+		jsonSerializer->applyMergePatch(map, QJsonObject {
+			{QStringLiteral("a"), QJsonObject{{QStringLiteral("y"), QJsonValue::Null}, {QStringLiteral("z"), 4}}},
+			{QStringLiteral("b"), QJsonValue::Null},
+			{QStringLiteral("c"), QJsonObject{{QStringLiteral("x"), 5}}}
+		});
+		QCOMPARE(map, (TestMap {
+			{QStringLiteral("a"), {{QStringLiteral("x"), 1}, {QStringLiteral("z"), 4}}},
+			{QStringLiteral("c"), {{QStringLiteral("x"), 5}}}
+		}));
+
+		// created patches only contain the differences
+		const TestMap other {
+			{QStringLiteral("a"), {{QStringLiteral("x"), 2}, {QStringLiteral("z"), 4}}}
+		};
+		const auto patch = jsonSerializer->createMergePatch(map, other);
+		QCOMPARE(patch, QJsonValue{QJsonObject {
+			{QStringLiteral("a"), QJsonObject{{QStringLiteral("x"), 2}}},
+			{QStringLiteral("c"), QJsonValue::Null}
+		}});
+		jsonSerializer->applyMergePatch(map, patch);
+		QCOMPARE(map, other);
+		QCOMPARE(cborSerializer->createMergePatch(map, other), QCborValue{QCborMap{}});
+
+		// patch operations
+		root->writes = 0;
+		cborSerializer->applyPatch(root, QCborArray {
+			QCborMap {
+				{QStringLiteral("op"), QStringLiteral("add")},
+				{QStringLiteral("path"), QStringLiteral("/list/1")},
+				{QStringLiteral("value"), 3}
+			},
+			QCborMap {
+				{QStringLiteral("op"), QStringLiteral("test")},
+				{QStringLiteral("path"), QStringLiteral("/child/value")},
+				{QStringLiteral("value"), 5}
+			},
+			QCborMap {
+				{QStringLiteral("op"), QStringLiteral("copy")},
+				{QStringLiteral("from"), QStringLiteral("/child/value")},
+				{QStringLiteral("path"), QStringLiteral("/value")}
+			}
+		});
+		QCOMPARE(root->child(), child);
+		QCOMPARE(root->list(), (QList<int>{1, 3, 2}));
+		QCOMPARE(root->value(), 5);
+		QCOMPARE(root->writes, 2);
+		QCOMPARE(child->writes, 1);
+
+		// values set to null are kept as null
+		QVariantMap nullMap {
+			{QStringLiteral("a"), 1},
+			{QStringLiteral("b"), 2}
+		};
+		jsonSerializer->applyPatch(nullMap, QJsonArray {
+			QJsonObject {
+				{QStringLiteral("op"), QStringLiteral("replace")},
+				{QStringLiteral("path"), QStringLiteral("/a")},
+				{QStringLiteral("value"), QJsonValue::Null}
+			}
+		});
+		QCOMPARE(nullMap.size(), 2);
+		QVERIFY(nullMap.contains(QStringLiteral("a")));
+		QCOMPARE(nullMap.value(QStringLiteral("b")).toInt(), 2);
+
+		const QJsonArray failedTest {
+			QJsonObject {
+				{QStringLiteral("op"), QStringLiteral("test")},
+				{QStringLiteral("path"), QStringLiteral("/value")},
+				{QStringLiteral("value"), 1}
+			}
+		};
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(jsonSerializer->applyPatch(root, failedTest), DeserializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(DeserializationException, jsonSerializer->applyPatch(root, failedTest));
+#endif
+		QCOMPARE(root->value(), 5);
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+}
+
+void SerializerTest::testChangeTracking()
+{
+	resetProps();
+	ChangeTracker tracker;
+	jsonSerializer->setChangeTracker(&tracker);
+	cborSerializer->setChangeTracker(&tracker);
+
+	auto root = new TreeObject{this};
+	auto child = new TreeObject{root};
+	root->setValue(1);
+	root->setList({1, 2});
+	root->setChild(child);
+	child->setValue(2);
+
+	try {
+		// untracked objects are written completely
+		QCOMPARE(jsonSerializer->serializeChanges(root), QJsonValue{QJsonObject {
+			{QStringLiteral("value"), 1},
+			{QStringLiteral("list"), QJsonArray{1, 2}},
+			{QStringLiteral("child"), QJsonObject {
+				 {QStringLiteral("value"), 2},
+				 {QStringLiteral("list"), QJsonArray{}},
+				 {QStringLiteral("child"), QJsonValue::Null}
+			 }}
+		}});
+		QVERIFY(tracker.isTracked(root));
+		QVERIFY(tracker.isTracked(child));
+		QCOMPARE(jsonSerializer->serializeChanges(root), QJsonValue{QJsonObject{}});
+
+		// only changes are written, child objects only if they changed themselves
+		child->setValue(3);
+		QVERIFY(!tracker.hasChanges(root));
+		QVERIFY(tracker.hasChanges(child));
+		QCOMPARE(tracker.changedProperties(child), QList<QByteArray>{"value"});
+		QCOMPARE(cborSerializer->serializeChanges(root), QCborValue{QCborMap {
+			{QStringLiteral("child"), QCborMap{{QStringLiteral("value"), 3}}}
+		}});
+		QVERIFY(!tracker.hasChanges(child));
+
+		// replaced objects are written completely
+		auto newChild = new TreeObject{root};
+		newChild->setValue(4);
+		root->setChild(newChild);
+		root->setList({3});
+		const auto changes = jsonSerializer->serializeChanges(root);
+		QCOMPARE(changes, QJsonValue{QJsonObject {
+			{QStringLiteral("list"), QJsonArray{3}},
+			{QStringLiteral("child"), QJsonObject {
+				 {QStringLiteral("value"), 4},
+				 {QStringLiteral("list"), QJsonArray{}},
+				 {QStringLiteral("child"), QJsonValue::Null}
+			 }}
+		}});
+		QVERIFY(tracker.isTracked(newChild));
+
+		// changes can be applied as merge patch, and deserialized objects are tracked as well
+		auto copy = jsonSerializer->deserialize<TreeObject*>(QJsonObject {
+			{QStringLiteral("value"), 1},
+			{QStringLiteral("list"), QJsonArray{1, 2}},
+			{QStringLiteral("child"), QJsonObject{{QStringLiteral("value"), 3}}}
+		}, this);
+		QVERIFY(tracker.isTracked(copy));
+		QVERIFY(!tracker.hasChanges(copy));
+		jsonSerializer->applyMergePatch(copy, changes);
+		QCOMPARE(copy->value(), 1);
+		QCOMPARE(copy->list(), QList<int>{3});
+		QCOMPARE(copy->child()->value(), 4);
+		QCOMPARE(tracker.changedProperties(copy), QList<QByteArray>{"list"});
+
+		// taking the changes also takes a snapshot
+		copy->setValue(5);
+		QCOMPARE(tracker.takeChanges(copy), (QList<QByteArray>{"value", "list"}));
+		QVERIFY(!tracker.hasChanges(copy));
+		QVERIFY(tracker.takeChanges(copy).isEmpty());
+
+		// destroyed objects are forgotten
+		auto temp = new TreeObject{};
+		tracker.track(temp);
+		QVERIFY(tracker.isTracked(temp));
+		delete temp;
+		QVERIFY(!tracker.isTracked(temp));
+
+		cborSerializer->setChangeTracker(nullptr);
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(cborSerializer->serializeChanges(root), SerializationException);
+		QVERIFY_EXCEPTION_THROWN(jsonSerializer->serializeChanges(QVariant{42}), SerializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(SerializationException, cborSerializer->serializeChanges(root));
+		QVERIFY_THROWS_EXCEPTION(SerializationException, jsonSerializer->serializeChanges(QVariant{42}));
+#endif
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	resetProps();
+}
+
+void SerializerTest::testDeferNotifications()
+{
+	resetProps();
+	jsonSerializer->setDeferNotifications(true);
+	cborSerializer->setDeferNotifications(true);
+
+	// records the state of children when they are attached
+	class ChildFilter : public QObject {
+	public:
+		QList<int> values;
+		bool eventFilter(QObject *watched, QEvent *event) override {
+			if (event->type() == QEvent::ChildAdded) {
+				if (const auto tree = qobject_cast<TreeObject*>(static_cast<QChildEvent*>(event)->child()); tree)
+					values.append(tree->value());
+			}
+			return QObject::eventFilter(watched, event);
+		}
+	};
+
+	try {
+		QObject holder;
+		ChildFilter filter;
+		holder.installEventFilter(&filter);
+		auto object = jsonSerializer->deserialize<TreeObject*>(QJsonObject {
+			{QStringLiteral("value"), 5},
+			{QStringLiteral("child"), QJsonObject{{QStringLiteral("value"), 6}}}
+		}, &holder);
+		QCOMPARE(object->parent(), &holder);
+		QCOMPARE(object->child()->parent(), object);
+		QCOMPARE(object->child()->value(), 6);
+		QCOMPARE(filter.values, QList<int>{5});
+
+		// the signals are only emitted once everything is written
+		QList<QPair<int, QList<int>>> valueStates;
+		auto listEmits = 0;
+		connect(object, &TreeObject::valueChanged, this, [&]() {
+			valueStates.append({object->value(), object->list()});
+		});
+		connect(object, &TreeObject::listChanged, this, [&]() {
+			++listEmits;
+		});
+		cborSerializer->deserializeInto(object, QCborMap {
+			{QStringLiteral("value"), 7},
+			{QStringLiteral("list"), QCborArray{1, 2}},
+			{QStringLiteral("child"), QCborMap{{QStringLiteral("value"), 6}}}
+		});
+		QCOMPARE(valueStates, (QList<QPair<int, QList<int>>>{{7, {1, 2}}}));
+		QCOMPARE(listEmits, 1);
+		QVERIFY(!object->signalsBlocked());
+
+		// unchanged properties are not notified
+		cborSerializer->deserializeInto(object, QCborMap {
+			{QStringLiteral("value"), 7},
+			{QStringLiteral("list"), QCborArray{1, 2, 3}}
+		});
+		QCOMPARE(valueStates.size(), 1);
+		QCOMPARE(listEmits, 2);
+
+		// properties written before a failure are still notified
+		cborSerializer->setValidationFlags(SerializerBase::ValidationFlag::NoExtraProperties);
+		try {
+			cborSerializer->deserializeInto(object, QCborMap {
+				{QStringLiteral("value"), 8},
+				{QStringLiteral("extra"), 42}
+			});
+			QFAIL("Expected a DeserializationException");
+		} catch (DeserializationException &) {}
+		QCOMPARE(object->value(), 8);
+		QCOMPARE(valueStates.size(), 2);
+		QVERIFY(!object->signalsBlocked());
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	resetProps();
+}
+
+void SerializerTest::testInstanceFactory()
+{
+	resetProps();
+
+	try {
+		auto pool = QSharedPointer<InstancePool>::create(2);
+		jsonSerializer->setInstanceFactory<TreeObject>(pool);
+		cborSerializer->setInstanceFactory<TreeObject>(pool);
+
+		auto first = jsonSerializer->deserialize<TreeObject*>(QJsonObject {
+			{QStringLiteral("value"), 1},
+			{QStringLiteral("list"), QJsonArray{1, 2}},
+			{QStringLiteral("child"), QJsonObject{{QStringLiteral("value"), 2}}}
+		}, this);
+		const auto firstChild = first->child();
+		first->setProperty("extra", 42);
+		QPointer<QObject> foreignChild = new QObject{first};
+
+		// objects and the children the pool created are reset when recycled, all other children are deleted
+		pool->recycle(first);
+		QCOMPARE(pool->size(), 2);
+		QVERIFY(foreignChild.isNull());
+		QVERIFY(!first->parent());
+		QVERIFY(!firstChild->parent());
+		QCOMPARE(first->value(), 0);
+		QCOMPARE(first->list(), QList<int>{});
+		QVERIFY(!first->child());
+		QVERIFY(!first->property("extra").isValid());
+		QCOMPARE(firstChild->value(), 0);
+
+		// recycled objects are reused before new ones are created
+		auto second = cborSerializer->deserialize<TreeObject*>(QCborMap {
+			{QStringLiteral("value"), 3},
+			{QStringLiteral("child"), QCborMap{{QStringLiteral("value"), 4}}}
+		}, this);
+		QCOMPARE(pool->size(), 0);
+		QCOMPARE(second, first);
+		QCOMPARE(second->parent(), this);
+		QCOMPARE(second->value(), 3);
+		QCOMPARE(second->child(), firstChild);
+		QCOMPARE(second->child()->parent(), second);
+		QCOMPARE(second->child()->value(), 4);
+
+		// instances that exceed the capacity are deleted
+		QPointer<TreeObject> temp = new TreeObject{};
+		pool->recycle(second);
+		pool->recycle(temp.data());
+		QCOMPARE(pool->size(), 2);
+		QVERIFY(temp.isNull());
+		pool->clear();
+		QCOMPARE(pool->size(), 0);
+
+		// objects are only reused in the thread they live in
+		QThread thread;
+		auto other = new TreeObject{};
+		other->moveToThread(&thread);
+		pool->recycle(other);
+		QCOMPARE(pool->size(), 1);
+		auto third = jsonSerializer->deserialize<TreeObject*>(QJsonObject{{QStringLiteral("value"), 5}}, this);
+		QVERIFY(third != other);
+		QCOMPARE(third->thread(), QThread::currentThread());
+		QCOMPARE(pool->size(), 1);
+		pool->clear();
+
+		// children the constructor created are kept and reset, and never replaced by the prototype's
+		auto ownerPool = QSharedPointer<InstancePool>::create(1);
+		jsonSerializer->setInstanceFactory<OwnerObject>(ownerPool);
+		auto owner = jsonSerializer->deserialize<OwnerObject*>(QJsonObject {
+			{QStringLiteral("owned"), QJsonObject{{QStringLiteral("value"), 6}}}
+		}, this);
+		QPointer<TreeObject> ownedChild = owner->findChild<TreeObject*>(QStringLiteral("owned"), Qt::FindDirectChildrenOnly);
+		QVERIFY(ownedChild);
+		QVERIFY(owner->owned() != ownedChild);
+		QCOMPARE(owner->owned()->value(), 6);
+		ownedChild->setValue(7);
+		ownerPool->recycle(owner);
+		QVERIFY(!ownedChild.isNull());
+		QCOMPARE(ownedChild->parent(), owner);
+		QCOMPARE(owner->owned(), ownedChild.data());
+		QCOMPARE(owner->children(), QObjectList{ownedChild.data()});
+		QCOMPARE(ownedChild->value(), 0);
+		ownerPool->clear();
+		pool->clear();
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	resetProps();
+}
+
+void SerializerTest::testWriterRegistration()
+{
+	// a second thread, whose writer caches live across the registration
+	QThread thread;
+	QObject context;
+	context.moveToThread(&thread);
+	thread.start();
+	auto threadGuard = qScopeGuard([&]() {
+		thread.quit();
+		thread.wait();
+	});
+	auto otherCanWrite = false;
+	auto otherType = -1;
+	const auto typeId = qMetaTypeId<LateList>();
+	const auto queryInThread = [&]() {
+		QVERIFY(QMetaObject::invokeMethod(&context, [&]() {
+			otherCanWrite = SequentialWriter::canWrite(typeId);
+			otherType = SequentialWriter::getInfo(typeId).type;
+		}, Qt::BlockingQueuedConnection));
+	};
+
+	// both threads cache the unregistered state
+	QVERIFY(!SequentialWriter::canWrite(typeId));
+	QCOMPARE(SequentialWriter::getInfo(typeId).type, static_cast<int>(QMetaType::UnknownType));
+	queryInThread();
+	QVERIFY(!otherCanWrite);
+	QCOMPARE(otherType, static_cast<int>(QMetaType::UnknownType));
+
+	// the registration is seen by both of them
+	SequentialWriter::registerWriter(typeId, new LateListWriterFactory{});
+	QVERIFY(SequentialWriter::canWrite(typeId));
+	QCOMPARE(SequentialWriter::getInfo(typeId).type, static_cast<int>(QMetaType::Int));
+	queryInThread();
+	QVERIFY(otherCanWrite);
+	QCOMPARE(otherType, static_cast<int>(QMetaType::Int));
+
+	auto data = QVariant::fromValue(LateList{});
+	const auto writer = SequentialWriter::getWriter(data);
+	QVERIFY(writer);
+	writer->add(42);
+	QCOMPARE(data.value<LateList>().values, QList<int>{42});
+}
+
+void SerializerTest::testContiguousLists()
+{
+	resetProps();
+
+	try {
+		QStringList strings;
+		QJsonArray jsonStrings;
+		for (auto i = 0; i < 1000; ++i) {
+			strings.append(QString::number(i));
+			jsonStrings.append(QString::number(i));
+		}
+		QCOMPARE(jsonSerializer->serialize(strings), QJsonValue{jsonStrings});
+		QCOMPARE(jsonSerializer->deserialize<QStringList>(jsonStrings), strings);
+		QCOMPARE(cborSerializer->deserialize<QStringList>(cborSerializer->serialize(strings)), strings);
+
+		// the JSON format of byte arrays is applied to every element
+		const QByteArrayList byteArrays {"baum", "42"};
+		const QJsonArray jsonByteArrays {
+			QString::fromUtf8(QByteArray{"baum"}.toBase64()),
+			QString::fromUtf8(QByteArray{"42"}.toBase64())
+		};
+		QCOMPARE(jsonSerializer->serialize(byteArrays), QJsonValue{jsonByteArrays});
+		QCOMPARE(jsonSerializer->deserialize<QByteArrayList>(jsonByteArrays), byteArrays);
+
+		// element tags are applied as well
+		cborSerializer->setTypeTag<int>(static_cast<QCborTag>(4243));
+		const auto tagged = cborSerializer->serialize(QList<int>{1, 2});
+		cborSerializer->setTypeTag<int>();
+		QCOMPARE(tagged, QCborValue{QCborArray {
+			QCborValue{static_cast<QCborTag>(4243), 1},
+			QCborValue{static_cast<QCborTag>(4243), 2}
+		}});
+		QCOMPARE(cborSerializer->deserialize<QList<double>>(QCborArray{0.5, 1.5}), (QList<double>{0.5, 1.5}));
+
+		// only elements of the exact type skip the validation and conversion
+		QVERIFY(!cborSerializer->tryDeserialize<QList<int>>(QCborValue{QCborArray{1, QStringLiteral("2")}}));
+		cborSerializer->setTypeTag<int>(static_cast<QCborTag>(4243));
+		QVERIFY(!cborSerializer->tryDeserialize<QList<int>>(QCborValue{QCborArray{1, 2}}));
+		QCOMPARE(cborSerializer->deserialize<QList<int>>(tagged), (QList<int>{1, 2}));
+		cborSerializer->setTypeTag<int>();
+		cborSerializer->setValidationFlags(SerializerBase::ValidationFlag::StandardValidation);
+		jsonSerializer->setValidationFlags(SerializerBase::ValidationFlag::StandardValidation);
+		QCOMPARE(cborSerializer->deserialize<QList<int>>(QCborArray{1, QStringLiteral("2")}), (QList<int>{1, 2}));
+		QCOMPARE(jsonSerializer->deserialize<QStringList>(QJsonArray{QStringLiteral("a"), 1}), (QStringList{QStringLiteral("a"), QStringLiteral("1")}));
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
+
+	resetProps();
+}
+
+void SerializerTest::testJsonText_data()
+{
+	QTest::addColumn<bool>("structuralIndexing");
+
+	QTest::newRow("sequential") << false;
+	QTest::newRow("indexed") << true;
+}
+
+void SerializerTest::testJsonText()
+{
+	QFETCH(bool, structuralIndexing);
+
+	resetProps();
+	jsonSerializer->setStructuralIndexing(structuralIndexing);
+
+	// numbers are written and read without a detour via double
+	const QVariantList numbers {
+		QVariant{Q_INT64_C(9007199254740993)},
+		QVariant{std::numeric_limits<qint64>::min()},
+		QVariant{0.1},
+		QVariant{1e300},
+		QVariant{-2.5e-8}
+	};
+	const auto numberJson = jsonSerializer->serializeTo(QVariant{numbers});
+	QCOMPARE(numberJson, QByteArray{"[9007199254740993,-9223372036854775808,0.1,1e+300,-2.5e-08]"});
+	QCOMPARE(jsonSerializer->deserializeFrom(numberJson, QMetaType::QVariantList).toList(), numbers);
+
+	// same layout as QJsonDocument
+	const QVariantMap data {
+		{QStringLiteral("a"), QVariantList{1, QStringLiteral("x\n\"y\x01")}},
+		{QStringLiteral("b"), QVariantMap{}},
+		{QStringLiteral("c"), true},
+		{QStringLiteral("d"), QString::fromUtf8("a long plain ASCII run, then \"quotes\", \\ backslashes, \xC3\xA4\xC3\xB6\xC3\xBC, \xF0\x9F\x98\x80 and\ttabs")}
+	};
+	for (const auto format : {QJsonDocument::Compact, QJsonDocument::Indented}) {
+		const auto json = jsonSerializer->serializeTo(QVariant{data}, format);
+		QCOMPARE(json, QJsonDocument{QJsonObject::fromVariantMap(data)}.toJson(format));
+		QCOMPARE(jsonSerializer->deserializeFrom(json, QMetaType::QVariantMap).toMap(), data);
+	}
+
+	// escapes and top level values
+	QCOMPARE(jsonSerializer->deserializeFrom(QByteArray{"\"\\ud83d\\ude00\\u00e4\""}, QMetaType::QString).toString(),
+			 QString::fromUtf8("\xF0\x9F\x98\x80\xC3\xA4"));
+	QCOMPARE(jsonSerializer->deserializeFrom(QByteArray{" 42 "}, QMetaType::Int).toInt(), 42);
+
+	// invalid JSON
+	for (const auto &invalid : {
+			 QByteArrayLiteral("[1, 2"),
+			 QByteArrayLiteral("[01]"),
+			 QByteArrayLiteral("{\"a\" 1}"),
+			 QByteArrayLiteral("[1] x"),
+			 QByteArrayLiteral("[\"abc]"),
+			 QByteArrayLiteral("[\"a\x01\"]"),
+			 QByteArrayLiteral("[\"\xC3\"]"),
+			 QByteArrayLiteral("[\"a\\x\"]"),
+			 QByteArrayLiteral("[tru\"e\"]")
+		 }) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+		QVERIFY_EXCEPTION_THROWN(jsonSerializer->deserializeFrom(invalid, QMetaType::QVariant), DeserializationException);
+#else
+		QVERIFY_THROWS_EXCEPTION(DeserializationException, jsonSerializer->deserializeFrom(invalid, QMetaType::QVariant));
+#endif
+		QVERIFY(!jsonSerializer->tryDeserializeFrom(invalid, QMetaType::QVariant));
+	}
+}
+
+void SerializerTest::benchmarkJsonParsing_data()
+{
+	QTest::addColumn<int>("mode");
+
+	QTest::newRow("qjsondocument") << 0;
+	QTest::newRow("sequential") << 1;
+	QTest::newRow("indexed") << 2;
+}
+
+void SerializerTest::benchmarkJsonParsing()
+{
+	QFETCH(int, mode);
+
+	QJsonArray records;
+	for (auto i = 0; i < 1000; ++i) {
+		records.append(QJsonObject {
+			{QStringLiteral("id"), i},
+			{QStringLiteral("name"), QStringLiteral("record number %1 with a reasonably long n\u00e4me").arg(i)},
+			{QStringLiteral("value"), i * 0.25},
+			{QStringLiteral("tags"), QJsonArray{QStringLiteral("alpha"), QStringLiteral("beta"), QStringLiteral("gamma")}},
+			{QStringLiteral("active"), i % 2 == 0}
+		});
+	}
+	const auto json = QJsonDocument{records}.toJson(QJsonDocument::Indented);
+
+	QJsonParseError error;
+	qint64 parsed = 0;
+	QElapsedTimer timer;
+	timer.start();
+	if (mode == 0) {
+		QBENCHMARK {
+			QJsonDocument::fromJson(json, &error);
+			parsed += json.size();
+		}
+	} else {
+		QBENCHMARK {
+			JsonReader::read(json, error, mode == 2);
+			parsed += json.size();
+		}
+	}
+	const auto nsecs = qMax<qint64>(timer.nsecsElapsed(), 1);
+	QCOMPARE(error.error, QJsonParseError::NoError);
+	// QBENCHMARK reports the time per iteration, the throughput is logged on top of it
+	qInfo("%lld bytes per iteration, %.3f MB/s",
+		  static_cast<qlonglong>(json.size()),
+		  static_cast<double>(parsed) * 1e3 / static_cast<double>(nsecs));
+}
+
 void SerializerTest::addCommonData()
 {
 	// basic types without any converter
@@ -1006,9 +1912,16 @@ void SerializerTest::resetProps()
 		ser->setPolymorphing(JsonSerializer::Polymorphing::Enabled);
 		ser->setMultiMapMode(SerializerBase::MultiMapMode::Map);
 		ser->setIgnoreStoredAttribute(false);
+		ser->setPositionalEncoding(false);
+		ser->setVariantDiscriminator(false);
+		ser->setDateAsMsecsSinceEpoch(false);
+		ser->setChangeTracker(nullptr);
+		ser->setDeferNotifications(false);
+		ser->setInstanceFactory<TreeObject>(nullptr);
 	}
 
 	jsonSerializer->setValidateBase64(true);
+	jsonSerializer->setStructuralIndexing(false);
 	jsonSerializer->setByteArrayFormat(JsonSerializer::ByteArrayFormat::Base64);
 }
 
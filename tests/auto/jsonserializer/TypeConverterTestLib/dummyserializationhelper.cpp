@@ -34,6 +34,33 @@ QSharedPointer<const TypeExtractor> DummySerializationHelper::extractor(int meta
 	return SerializerBasePrivate::extractors.get(metaTypeId);
 }
 
+qint64 DummySerializationHelper::classId(const QMetaObject *metaObject) const
+{
+	// class ids are a cbor only feature
+	if (json)
+		return -1;
+	return properties.value(QStringLiteral("classIds"))
+			.toHash()
+			.value(QString::fromUtf8(metaObject->className()), -1)
+			.toLongLong();
+}
+
+const QMetaObject *DummySerializationHelper::classForId(qint64 classId) const
+{
+	const auto classIds = properties.value(QStringLiteral("classIds")).toHash();
+	for (auto it = classIds.constBegin(); it != classIds.constEnd(); ++it) {
+		if (it->toLongLong() == classId) {
+			const QByteArray className = it.key().toUtf8() + "*";
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+			return QMetaType(QMetaType::type(className.constData())).metaObject();
+#else
+			return QMetaType::fromName(className.constData()).metaObject();
+#endif
+		}
+	}
+	return nullptr;
+}
+
 QCborValue DummySerializationHelper::serializeSubtype(const QMetaProperty &property, const QVariant &value) const
 {
 	return serializeSubtype(property.userType(), value, property.name());
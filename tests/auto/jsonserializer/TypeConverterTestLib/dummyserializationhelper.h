@@ -16,6 +16,8 @@ public:
 	QVariant getProperty(const char *name) const override;
 	QCborTag typeTag(int metaTypeId) const override;
 	QSharedPointer<const QtJsonSerializer::TypeExtractor> extractor(int metaTypeId) const override;
+	qint64 classId(const QMetaObject *metaObject) const override;
+	const QMetaObject *classForId(qint64 classId) const override;
 	QCborValue serializeSubtype(const QMetaProperty &property, const QVariant &value) const override;
 	QCborValue serializeSubtype(int propertyType, const QVariant &value, const QByteArray &traceHint) const override;
 	QVariant deserializeSubtype(const QMetaProperty &property, const QCborValue &value, QObject *parent) const override;
@@ -2,6 +2,7 @@
 #include <QtJsonSerializer>
 #include <QtTest>
 #include <typeinfo>
+#include <algorithm>
 
 #define private public
 #include <QtJsonSerializer/private/serializerbase_p.h>
@@ -96,6 +97,28 @@ void TypeConverterTestBase::testMetaTypeDetection()
 	helper->json = tag == static_cast<QCborTag>(CborSerializer::NoTag);
 	converter()->setHelper(helper);
 	QCOMPARE(converter()->canConvert(metatype), canSer);
+
+	// the allocation free capability queries must agree with the list based ones
+	if (canSer) {
+		const auto aTags = converter()->allowedCborTags(metatype);
+		auto tagSupport = TypeConverter::TagSupport::Unrestricted;
+		if (!aTags.isEmpty())
+			tagSupport = aTags.contains(tag) ? TypeConverter::TagSupport::Allowed : TypeConverter::TagSupport::Rejected;
+		QCOMPARE(converter()->cborTagSupport(metatype, tag), tagSupport);
+
+		const auto aTypes = converter()->allowedCborTypes(metatype, tag);
+		TypeConverter::CborTypeMask typeMask = 0;
+		for (const auto aType : aTypes)
+			typeMask |= TypeConverter::cborTypeBit(aType);
+		QCOMPARE(converter()->allowedCborTypeMask(metatype, tag), typeMask);
+		auto maskTypes = TypeConverter::cborTypes(typeMask);
+		auto sortedTypes = aTypes;
+		std::sort(maskTypes.begin(), maskTypes.end());
+		std::sort(sortedTypes.begin(), sortedTypes.end());
+		sortedTypes.erase(std::unique(sortedTypes.begin(), sortedTypes.end()), sortedTypes.end());
+		QCOMPARE(maskTypes, sortedTypes);
+	}
+
 	QCOMPARE(converter()->canDeserialize(metatype, tag, type), canDeser);
 }
 
@@ -140,6 +163,12 @@ void TypeConverterTestBase::testSerialization()
 			QVERIFY_EXCEPTION_THROWN(converter()->serialize(type, data), SerializationException);
 #else
 			QVERIFY_THROWS_EXCEPTION(SerializationException, converter()->serialize(type, data));
+#endif
+			helper->serData = serData;
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+			QVERIFY_EXCEPTION_THROWN(converter()->serializeJsonValue(type, data), SerializationException);
+#else
+			QVERIFY_THROWS_EXCEPTION(SerializationException, converter()->serializeJsonValue(type, data));
 #endif
 		} else {
 			if (!cResult.isUndefined()) {
@@ -147,15 +176,32 @@ void TypeConverterTestBase::testSerialization()
 				helper->serData = serData;
 				auto res = converter()->serialize(type, data);
 				QCOMPARE(res, cResult);
+
+				// the raw path must produce the same CBOR
+				if (data.userType() == type) {
+					helper->serData = serData;
+					QCOMPARE(converter()->serializeRaw(type, data.constData()), cResult);
+				}
 			}
 			if (!jResult.isUndefined()) {
 				helper->json = true;
 				helper->serData = serData;
 				auto cRes = converter()->serialize(type, data);
-				if (const auto tag = helper->typeTag(type); tag != static_cast<QCborTag>(CborSerializer::NoTag))
+				const auto tag = helper->typeTag(type);
+				if (tag != static_cast<QCborTag>(CborSerializer::NoTag))
 					cRes = {tag, cRes.isTag() ? cRes.taggedValue() : cRes};
 				const auto res = cRes.toJsonValue();
 				QCOMPARE(res, jResult);
+
+				// the direct path must produce the same JSON (override tags are applied by the serializer)
+				if (tag == static_cast<QCborTag>(CborSerializer::NoTag)) {
+					helper->serData = serData;
+					QCOMPARE(converter()->serializeJsonValue(type, data), jResult);
+					if (data.userType() == type) {
+						helper->serData = serData;
+						QCOMPARE(converter()->serializeJsonRaw(type, data.constData()), jResult);
+					}
+				}
 			}
 		}
 	} catch(std::exception &e) {
@@ -209,6 +255,12 @@ void TypeConverterTestBase::testDeserialization()
 				QVERIFY_EXCEPTION_THROWN(converter()->deserializeJson(type, QCborValue::fromJsonValue(jData), this), DeserializationException);
 #else
 				QVERIFY_THROWS_EXCEPTION(DeserializationException, converter()->deserializeJson(type, QCborValue::fromJsonValue(jData), this));
+#endif
+				helper->deserData = deserData;
+#if QT_VERSION < QT_VERSION_CHECK(6, 3, 0)
+				QVERIFY_EXCEPTION_THROWN(converter()->deserializeJsonValue(type, jData, this), DeserializationException);
+#else
+				QVERIFY_THROWS_EXCEPTION(DeserializationException, converter()->deserializeJsonValue(type, jData, this));
 #endif
 			}
 		} else {
@@ -222,6 +274,18 @@ void TypeConverterTestBase::testDeserialization()
 				QVERIFY(res.convert(QMetaType(type)));
 #endif
 				SELF_COMPARE(type, res, result);
+
+				// the raw path must produce the same value
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+				QVariant rawRes{type, nullptr};
+#else
+				QVariant rawRes{QMetaType(type), nullptr};
+#endif
+				if (type != QMetaType::QVariant && rawRes.isValid()) {
+					helper->deserData = deserData;
+					converter()->deserializeRaw(type, cData, rawRes.data(), this);
+					SELF_COMPARE(type, rawRes, result);
+				}
 			}
 			if (!jData.isUndefined()) {
 				helper->json = true;
@@ -233,6 +297,16 @@ void TypeConverterTestBase::testDeserialization()
 				QVERIFY(res.convert(QMetaType(type)));
 #endif
 				SELF_COMPARE(type, res, result);
+
+				// the direct path must read the same data
+				helper->deserData = deserData;
+				auto directRes = converter()->deserializeJsonValue(type, jData, this);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+				QVERIFY(directRes.convert(type));
+#else
+				QVERIFY(directRes.convert(QMetaType(type)));
+#endif
+				SELF_COMPARE(type, directRes, result);
 			}
 		}
 	} catch(std::exception &e) {
@@ -30,6 +30,9 @@ protected:
 	void addSerData() override;
 	void addDeserData() override;
 
+private Q_SLOTS:
+	void testStrictDiscriminator();
+
 private:
 	StdVariantConverter _converter;
 };
@@ -69,6 +72,11 @@ void VariantConverterTest::addMetaData()
 							  << QCborValue::Array
 							  << true
 							  << TypeConverter::DeserializationCapabilityResult::Positive;
+	QTest::newRow("discriminator") << qMetaTypeId<std::variant<int, bool, double>>()
+								   << static_cast<QCborTag>(CborSerializer::VariantAlternative)
+								   << QCborValue::Array
+								   << true
+								   << TypeConverter::DeserializationCapabilityResult::Positive;
 	QTest::newRow("invalid") << static_cast<int>(QMetaType::QVariant)
 							 << static_cast<QCborTag>(CborSerializer::NoTag)
 							 << QCborValue::Null
@@ -99,6 +107,16 @@ void VariantConverterTest::addCommonSerData()
 								  << QVariant::fromValue<std::variant<int, bool, double>>(7.3)
 								  << QCborValue{3}
 								  << QJsonValue{3};
+	QTest::newRow("discriminator") << QVariantHash{{QStringLiteral("variantDiscriminator"), true}}
+								   << TestQ{{QMetaType::Double, 7.3, 3}}
+								   << static_cast<QObject*>(nullptr)
+								   << qMetaTypeId<std::variant<int, bool, double>>()
+								   << QVariant::fromValue<std::variant<int, bool, double>>(7.3)
+								   << QCborValue{static_cast<QCborTag>(CborSerializer::VariantAlternative), QCborArray{2, 3}}
+								   << QJsonValue{QJsonObject{
+											{QStringLiteral("@type"), 2},
+											{QStringLiteral("@value"), 3}
+										}};
 }
 
 void VariantConverterTest::addSerData()
@@ -128,6 +146,52 @@ void VariantConverterTest::addDeserData()
 							 << QVariant{}
 							 << QCborValue{QStringLiteral("Hello World")}
 							 << QJsonValue{QStringLiteral("Hello World")};
+	QTest::newRow("discriminator.index") << QVariantHash{{QStringLiteral("variantDiscriminator"), true}}
+										 << TestQ{}
+										 << static_cast<QObject*>(nullptr)
+										 << qMetaTypeId<std::variant<int, bool, double>>()
+										 << QVariant{}
+										 << QCborValue{static_cast<QCborTag>(CborSerializer::VariantAlternative), QCborArray{5, 3}}
+										 << QJsonValue{QJsonObject{
+												  {QStringLiteral("@type"), 5},
+												  {QStringLiteral("@value"), 3}
+											  }};
+}
+
+void VariantConverterTest::testStrictDiscriminator()
+{
+	const auto type = qMetaTypeId<std::variant<int, bool, double>>();
+	const auto value = QVariant::fromValue<std::variant<int, bool, double>>(7.3);
+	const QCborValue cData{static_cast<QCborTag>(CborSerializer::VariantAlternative), QCborArray{2, 3}};
+
+	StdVariantConverter converter;
+	helper->properties = {
+		{QStringLiteral("validationFlags"), QVariant::fromValue<SerializerBase::ValidationFlags>(SerializerBase::ValidationFlag::StrictBasicTypes)},
+		{QStringLiteral("variantDiscriminator"), true}
+	};
+	helper->expectedParent = nullptr;
+	helper->json = false;
+	converter.setHelper(helper);
+
+	try {
+		helper->serData = {{QMetaType::Double, 7.3, 3}};
+		const auto serialized = converter.serialize(type, value);
+		QCOMPARE(serialized, cData);
+
+		// strict mode verifies the tag, which must be accepted for the discriminated form
+		auto metaTypeId = type;
+		QCOMPARE(converter.canDeserialize(metaTypeId, serialized.tag(), serialized.taggedValue().type()),
+				 TypeConverter::DeserializationCapabilityResult::Positive);
+		metaTypeId = type;
+		QCOMPARE(converter.canDeserialize(metaTypeId, static_cast<QCborTag>(CborSerializer::NoTag), QCborValue::Double),
+				 TypeConverter::DeserializationCapabilityResult::Positive);
+
+		helper->deserData = {{QMetaType::Double, 7.3, 3}};
+		const auto deserialized = converter.deserializeCbor(type, serialized, this);
+		QCOMPARE(deserialized.value<TestVar1>(), value.value<TestVar1>());
+	} catch (std::exception &e) {
+		QFAIL(e.what());
+	}
 }
 
 QTEST_MAIN(VariantConverterTest)
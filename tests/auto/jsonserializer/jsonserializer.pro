@@ -21,6 +21,7 @@ CONVERTER_TESTS = \
 	ObjectConverterTest \
 	OptionalConverterTest \
 	PairConverterTest \
+	RawFragmentConverterTest \
 	SmartPointerConverterTest \
 	TupleConverterTest \
 	VariantConverterTest \